@@ -1,8 +1,7 @@
 #include "lib/math.glsl"
 #include "lib/sdf.glsl"
 
-uniform vec4 colour;
-uniform vec2 dimensions;
+#include "marker_params.glsl"
 
 in vec2 pos;
 out vec4 colour_out;
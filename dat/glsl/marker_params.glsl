@@ -0,0 +1,9 @@
+/* Colour and size of a radar marker. When drawn as a batch, they come from the
+ * instance data through project_pos_batch.vert instead of uniforms. */
+#ifdef MARKER_BATCH
+flat in vec4 colour;
+flat in vec2 dimensions;
+#else /* MARKER_BATCH */
+uniform vec4 colour;
+uniform vec2 dimensions;
+#endif /* MARKER_BATCH */
@@ -1,7 +1,6 @@
 #include "lib/sdf.glsl"
 
-uniform vec4 colour;
-uniform vec2 dimensions;
+#include "marker_params.glsl"
 
 in vec2 pos;
 out vec4 colour_out;
@@ -0,0 +1,19 @@
+/* Instanced version of project_pos.vert for batching simple shaders. */
+uniform mat4 projection;
+in vec4 vertex;
+in vec3 centre; // Position and rotation
+in vec2 size;
+in vec4 tint;
+out vec2 pos;
+flat out vec4 colour;
+flat out vec2 dimensions;
+
+void main(void) {
+   float c = cos( centre.z );
+   float s = sin( centre.z );
+   vec2 p  = vertex.xy * size;
+   pos        = vertex.xy;
+   colour     = tint;
+   dimensions = size;
+   gl_Position = projection * vec4( centre.xy + vec2( c*p.x - s*p.y, s*p.x + c*p.y ), 0.0, 1.0 );
+}
@@ -1,5 +1,4 @@
-uniform vec4 colour;
-uniform vec2 dimensions;
+#include "marker_params.glsl"
 
 in vec2 pos;
 out vec4 colour_out;
@@ -0,0 +1,26 @@
+uniform sampler2D sampler1;
+uniform sampler2D sampler2;
+
+in vec2 tex_coord;
+in vec4 colour_frag;
+in float inter_frag;
+out vec4 colour_out;
+
+void main(void) {
+   /* Same as texture.frag and texture_interpolate.frag. */
+   if (inter_frag >= 1.0) {
+      colour_out = colour_frag * texture(sampler1, tex_coord);
+      return;
+   }
+   else if (inter_frag <= 0.0) {
+      colour_out = colour_frag * texture(sampler2, tex_coord);
+      return;
+   }
+   vec4 colour1 = texture(sampler1, tex_coord);
+   vec4 colour2 = texture(sampler2, tex_coord);
+   if (colour1.a <= 0.0)
+      colour1.rgb = vec3(0.0);
+   if (colour2.a <= 0.0)
+      colour2.rgb = vec3(0.0);
+   colour_out = colour_frag * mix(colour2, colour1, inter_frag);
+}
@@ -0,0 +1,17 @@
+uniform mat4 projection;
+
+in vec4 vertex;
+in vec4 rect;
+in vec4 tex_rect;
+in vec4 colour;
+in float inter;
+out vec2 tex_coord;
+out vec4 colour_frag;
+out float inter_frag;
+
+void main(void) {
+   tex_coord   = tex_rect.xy + vertex.xy * tex_rect.zw;
+   colour_frag = colour;
+   inter_frag  = inter;
+   gl_Position = projection * vec4( rect.xy + vertex.xy * rect.zw, 0.0, 1.0 );
+}
@@ -1,12 +1,32 @@
-/* Same as project_pos.vert */
+/* Trail segments are batched, so everything that used to be a per-segment
+ * uniform is passed as vertex attributes instead. */
 uniform mat4 projection;
-in vec4 vertex;
+in vec3 vertex; // Screen position and "trail" depth
+in vec2 coord;  // Position within the segment [0,1]
+in vec4 col1;
+in vec4 col2;
+in vec2 trange;
+in vec2 position1;
+in vec2 position2;
+in vec2 params; // Unique value and current time of the trail
 out vec2 pos;
-
-uniform vec2 z; // Depth
+flat out vec4 c1;
+flat out vec4 c2;
+flat out vec2 t;
+flat out vec2 pos1;
+flat out vec2 pos2;
+flat out float r;
+flat out float dt;
 
 void main(void) {
-   pos = vertex.xy;
-   gl_Position = projection * vertex;
-   gl_Position.z = mix( z.x, z.y, vertex.x ); // Use the "trail" depth
+   pos  = coord;
+   c1   = col1;
+   c2   = col2;
+   t    = trange;
+   pos1 = position1;
+   pos2 = position2;
+   r    = params.x;
+   dt   = params.y;
+   gl_Position = projection * vec4( vertex.xy, 0.0, 1.0 );
+   gl_Position.z = vertex.z;
 }
@@ -3,13 +3,13 @@
 
 // For ideas: https://thebookofshaders.com/05/
 
-uniform vec4 c1;  // Start colour
-uniform vec4 c2;  // End colour
-uniform vec2 t; // Start and end time [0,1]
-uniform float dt; // Current time (in seconds)
-uniform vec2 pos1;// Start position
-uniform vec2 pos2;// End position
-uniform float r;  // Unique value per trail [0,1]
+flat in vec4 c1;  // Start colour
+flat in vec4 c2;  // End colour
+flat in vec2 t; // Start and end time [0,1]
+flat in float dt; // Current time (in seconds)
+flat in vec2 pos1;// Start position
+flat in vec2 pos2;// End position
+flat in float r;  // Unique value per trail [0,1]
 uniform vec3 nebu_col; // Base colour of the nebula, only changes when entering new system
 
 in vec2 pos;
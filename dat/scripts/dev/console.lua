@@ -87,6 +87,32 @@ function inspect( t )
    end
 end
 
+-- Prints the n AI functions with the most total run time, see naev.perfStats()
+-- luacheck: globals aiprofile
+function aiprofile( n, reset )
+   n = n or 20
+   local entries = {}
+   for ainame,prof in pairs(naev.perfStats("aiprofile")) do
+      table.insert( entries, { name=ainame, s=prof.control } )
+      for taskname,s in pairs(prof.tasks) do
+         table.insert( entries, { name=ainame.."/"..taskname, s=s } )
+      end
+   end
+   table.sort( entries, function( a, b ) return a.s.time > b.s.time end )
+
+   print(string.format("%40s %9s %10s %8s %10s", "profile/task", "calls",
+      "total ms", "max ms", "mem KiB"))
+   for i=1,math.min(n,#entries) do
+      local e = entries[i]
+      print(string.format("%40s %9d %10.2f %8.3f %10.1f", e.name, e.s.calls,
+         e.s.time*1000, e.s.time_max*1000, e.s.mem/1024))
+   end
+
+   if reset then
+      naev.perfStatsReset()
+   end
+end
+
 -- luacheck: globals pprint
 pprint = require "dev.pprint"
 
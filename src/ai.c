@@ -74,6 +74,7 @@
 
 #include "array.h"
 #include "board.h"
+#include "camera.h"
 #include "conf.h"
 #include "faction.h"
 #include "gatherable.h"
@@ -87,6 +88,7 @@
 #include "nlua_vec2.h"
 #include "nluadef.h"
 #include "ntracing.h"
+#include "opengl.h"
 #include "physics.h"
 #include "pilot.h"
 #include "rng.h"
@@ -111,6 +113,24 @@ static nlua_env   *equip_env = NULL; /**< Equipment enviornment. */
 static IntList     ai_qtquery;       /**< Quadtree query. */
 static double ai_dt = 0.; /**< Current update tick, useful in some cases. **/
 
+/*
+ * control tick scheduling
+ */
+#define AI_BUDGET                                                              \
+   0.002 /**< Seconds of control ticks per frame before deferring. */
+#define AI_DEFER_MAX                                                           \
+   0.5 /**< Maximum delay of a control tick as a fraction of control_rate. */
+#define AI_SLOTS                                                               \
+   256 /**< Number of control tick slots, enough for control rates to 3.8 s. */
+#define AI_SLOT_WIDTH                                                          \
+   ( 1. / 60. ) /**< Game time covered by each control tick slot. */
+static double    ai_time = 0.; /**< Game time seen by ai_updateSlots(). */
+static long long ai_slotCur =
+   0; /**< Absolute control tick slot of the current frame. */
+static int ai_slots[AI_SLOTS]; /**< Control ticks scheduled per slot. */
+static Uint64  ai_frameUsed = 0; /**< Counter ticks of control this frame. */
+static AIStats ai_stats;         /**< Scheduler statistics. */
+
 /*
  * prototypes
  */
@@ -121,6 +141,13 @@ static int  ai_setMemory( void );
 static void ai_create( Pilot *pilot );
 static int  ai_loadEquip( void );
 static int  ai_sort( const void *p1, const void *p2 );
+/* Scheduling. */
+static double ai_scheduleControl( double crate );
+static int    ai_canDefer( const Pilot *p, const Task *t );
+/* Profiling. */
+static int  ai_profTask( AI_Profile *prof, const char *name );
+static void ai_profStart( Uint64 *tstart, double *mstart );
+static void ai_profEnd( AIProfStats *stats, Uint64 tstart, double mstart );
 /* Task management. */
 static void  ai_taskGC( Pilot *pilot );
 static Task *ai_createTask( lua_State *L, int subtask );
@@ -704,6 +731,9 @@ static int ai_loadProfile( AI_Profile *prof, const char *filename )
    size_t      len;
    const char *str;
 
+   /* Clear memory. */
+   memset( prof, 0, sizeof( AI_Profile ) );
+
    /* Set name. */
    len        = strlen( filename ) - strlen( AI_PATH ) - strlen( ".lua" );
    prof->name = malloc( len + 1 );
@@ -791,6 +821,9 @@ void ai_exit( void )
    for ( int i = 0; i < array_size( profiles ); i++ ) {
       free( profiles[i].name );
       nlua_freeEnv( profiles[i].env );
+      for ( int j = 0; j < array_size( profiles[i].tasks ); j++ )
+         free( profiles[i].tasks[j].name );
+      array_free( profiles[i].tasks );
    }
    array_free( profiles );
 
@@ -802,6 +835,202 @@ void ai_exit( void )
    il_destroy( &ai_qtquery );
 }
 
+/**
+ * @brief Starts a new frame for the control tick budget.
+ *
+ * Should be called once per rendered frame, before all the updates.
+ */
+void ai_frameStart( void )
+{
+   ai_stats.frame_time =
+      (double)ai_frameUsed / (double)SDL_GetPerformanceFrequency();
+   NTracingPlotI( "ai_deferred", ai_stats.deferred_frame );
+   ai_frameUsed            = 0;
+   ai_stats.deferred_frame = 0;
+}
+
+/**
+ * @brief Advances the control tick slots by the game time of an update.
+ *
+ * Should be called once before all the pilots think.
+ *
+ *    @param dt Current delta tick.
+ */
+void ai_updateSlots( double dt )
+{
+   long long slot;
+
+   /* Clear the slots that have gone by. */
+   ai_time += dt;
+   slot = (long long)( ai_time / AI_SLOT_WIDTH );
+   if ( slot - ai_slotCur >= AI_SLOTS )
+      memset( ai_slots, 0, sizeof( ai_slots ) );
+   else
+      for ( long long i = ai_slotCur + 1; i <= slot; i++ )
+         ai_slots[i % AI_SLOTS] = 0;
+   ai_slotCur = slot;
+}
+
+/**
+ * @brief Picks when the next control tick of a pilot should happen.
+ *
+ * Two random candidates are drawn within ±10% of the control rate and the
+ * one landing on the least busy slot is used, which keeps pilots spawned
+ * together from ticking together.
+ *
+ *    @param crate Control rate of the pilot.
+ *    @return Time until the next control tick.
+ */
+static double ai_scheduleControl( double crate )
+{
+   double    a  = crate * ( 0.9 + 0.2 * RNGF() );
+   double    b  = crate * ( 0.9 + 0.2 * RNGF() );
+   long long sa = (long long)( a / AI_SLOT_WIDTH );
+   long long sb = (long long)( b / AI_SLOT_WIDTH );
+
+   /* Too far away to be tracked. */
+   if ( ( sa >= AI_SLOTS ) || ( sb >= AI_SLOTS ) )
+      return a;
+
+   sa = ( ai_slotCur + sa ) % AI_SLOTS;
+   sb = ( ai_slotCur + sb ) % AI_SLOTS;
+   if ( ai_slots[sb] < ai_slots[sa] ) {
+      ai_slots[sb]++;
+      return b;
+   }
+   ai_slots[sa]++;
+   return a;
+}
+
+/**
+ * @brief Checks to see if a pilot's due control tick can wait a frame.
+ *
+ * Only done once the frame went over its control tick budget, and never for
+ * pilots with nothing to do, that the player can see or that are controlled
+ * by or fly with the player.
+ *
+ *    @param p Pilot to check.
+ *    @param t Current task of the pilot.
+ *    @return 1 if the control tick should be deferred.
+ */
+static int ai_canDefer( const Pilot *p, const Task *t )
+{
+   double x, y, z, rx, ry;
+
+   if ( (double)ai_frameUsed <
+        AI_BUDGET * (double)SDL_GetPerformanceFrequency() )
+      return 0;
+   if ( ( t == NULL ) || pilot_isPlayer( p ) ||
+        pilot_isFlag( p, PILOT_MANUAL_CONTROL ) || pilot_isWithPlayer( p ) )
+      return 0;
+   if ( p->tcontrol < -AI_DEFER_MAX * p->ai->control_rate )
+      return 0;
+
+   /* Pilots on screen always think on time. */
+   z = cam_getZoom();
+   cam_getPos( &x, &y );
+   rx = FABS( p->solid.pos.x - x ) * z;
+   ry = FABS( p->solid.pos.y - y ) * z;
+   if ( ( rx <= ( SCREEN_W + p->ship->size ) / 2. ) &&
+        ( ry <= ( SCREEN_H + p->ship->size ) / 2. ) )
+      return 0;
+
+   ai_stats.deferred++;
+   ai_stats.deferred_frame++;
+   return 1;
+}
+
+/**
+ * @brief Gets the statistics of the control tick scheduler.
+ *
+ *    @param[out] stats Statistics of the scheduler.
+ */
+void ai_getStats( AIStats *stats )
+{
+   *stats = ai_stats;
+}
+
+/**
+ * @brief Gets all the AI profiles.
+ *
+ *    @return Array (array.h): All the AI profiles.
+ */
+const AI_Profile *ai_getProfiles( void )
+{
+   return profiles;
+}
+
+/**
+ * @brief Resets the profiling counters of all the AI profiles.
+ */
+void ai_profReset( void )
+{
+   for ( int i = 0; i < array_size( profiles ); i++ ) {
+      AI_Profile *prof = &profiles[i];
+      memset( &prof->control, 0, sizeof( AIProfStats ) );
+      /* Keep the names, since tasks refer to the counters by index. */
+      for ( int j = 0; j < array_size( prof->tasks ); j++ ) {
+         AIProfStats *ts = &prof->tasks[j];
+         ts->calls       = 0;
+         ts->time        = 0.;
+         ts->time_max    = 0.;
+         ts->mem         = 0.;
+      }
+   }
+}
+
+/**
+ * @brief Gets the index of the counters of a task function of a profile.
+ *
+ *    @param prof Profile the task belongs to.
+ *    @param name Name of the task function.
+ *    @return Index in the task counters of the profile.
+ */
+static int ai_profTask( AI_Profile *prof, const char *name )
+{
+   AIProfStats *ts;
+
+   for ( int i = 0; i < array_size( prof->tasks ); i++ )
+      if ( strcmp( prof->tasks[i].name, name ) == 0 )
+         return i;
+
+   if ( prof->tasks == NULL )
+      prof->tasks = array_create( AIProfStats );
+   ts = &array_grow( &prof->tasks );
+   memset( ts, 0, sizeof( AIProfStats ) );
+   ts->name = strdup( name );
+   return array_size( prof->tasks ) - 1;
+}
+
+/**
+ * @brief Starts measuring a run of an AI function.
+ */
+static void ai_profStart( Uint64 *tstart, double *mstart )
+{
+   *mstart = lua_gc( naevL, LUA_GCCOUNT, 0 ) * 1024. +
+             lua_gc( naevL, LUA_GCCOUNTB, 0 );
+   *tstart = SDL_GetPerformanceCounter();
+}
+
+/**
+ * @brief Finishes measuring a run of an AI function.
+ *
+ * Memory is the growth of the Lua heap, so it undercounts runs during which
+ * the garbage collector kicks in.
+ */
+static void ai_profEnd( AIProfStats *stats, Uint64 tstart, double mstart )
+{
+   double dt = (double)( SDL_GetPerformanceCounter() - tstart ) /
+               (double)SDL_GetPerformanceFrequency();
+   double mem = lua_gc( naevL, LUA_GCCOUNT, 0 ) * 1024. +
+                lua_gc( naevL, LUA_GCCOUNTB, 0 );
+   stats->calls++;
+   stats->time += dt;
+   stats->time_max = MAX( stats->time_max, dt );
+   if ( mem > mstart )
+      stats->mem += mem - mstart;
+}
+
 /**
  * @brief Heart of the AI, brains of the pilot.
  *
@@ -840,11 +1069,16 @@ void ai_think( Pilot *pilot, double dt, int dotask )
    /* Get current task. */
    t = ai_curTask( cur_pilot );
 
-   /* control function if pilot is idle or tick is up */
-   if ( ( cur_pilot->tcontrol < 0. ) || ( t == NULL ) ) {
+   /* control function if pilot is idle or tick is up, unless the frame is
+    * busy and the pilot can wait a bit */
+   if ( ( ( cur_pilot->tcontrol < 0. ) && !ai_canDefer( cur_pilot, t ) ) ||
+        ( t == NULL ) ) {
       NTracingZoneName( _ctx_control, "ai_think[control]", 1 );
 
+      Uint64 tstart;
+      double mstart;
       double crate = cur_pilot->ai->control_rate;
+      ai_profStart( &tstart, &mstart );
       if ( pilot_isFlag( pilot, PILOT_PLAYER ) ||
            pilot_isFlag( cur_pilot, PILOT_MANUAL_CONTROL ) ) {
          lua_rawgeti( naevL, LUA_REGISTRYINDEX,
@@ -857,11 +1091,15 @@ void ai_think( Pilot *pilot, double dt, int dotask )
          ai_run( env, 1 ); /* run control */
       }
       /* Try to desync control ticks when possible by adding randomness. */
-      cur_pilot->tcontrol = crate * ( 0.9 + 0.2 * RNGF() );
+      cur_pilot->tcontrol = ai_scheduleControl( crate );
 
       /* Task may have changed due to control tick. */
       t = ai_curTask( cur_pilot );
 
+      ai_frameUsed += SDL_GetPerformanceCounter() - tstart;
+      ai_stats.control++;
+      ai_profEnd( &cur_pilot->ai->control, tstart, mstart );
+
       NTracingZoneEnd( _ctx_control );
    }
 
@@ -873,26 +1111,36 @@ void ai_think( Pilot *pilot, double dt, int dotask )
 
    /* pilot has a currently running task */
    if ( t != NULL ) {
-      int data;
+      int         data, stats;
+      Uint64      tstart;
+      double      mstart;
+      AI_Profile *prof = cur_pilot->ai;
+      Task       *run  = ( t->subtask != NULL ) ? t->subtask : t;
       NTracingZoneName( _ctx_task, "ai_think[task]", 1 );
 
       /* Run subtask if available, otherwise run main task. */
-      if ( t->subtask != NULL ) {
-         lua_rawgeti( naevL, LUA_REGISTRYINDEX, t->subtask->func );
-         /* Use subtask data or task data if subtask is not set. */
-         data = t->subtask->dat;
-         if ( data == LUA_NOREF )
-            data = t->dat;
-      } else {
-         lua_rawgeti( naevL, LUA_REGISTRYINDEX, t->func );
+      lua_rawgeti( naevL, LUA_REGISTRYINDEX, run->func );
+      /* Use subtask data or task data if subtask is not set. */
+      data = run->dat;
+      if ( data == LUA_NOREF )
          data = t->dat;
+
+      /* The AI may have changed since the task was created, so charge it to
+       * the function of the same name in the current profile. */
+      if ( run->prof != prof ) {
+         run->stats = ai_profTask( prof, run->name );
+         run->prof  = prof;
       }
+      stats = run->stats;
       /* Function should be on the stack. */
+      ai_profStart( &tstart, &mstart );
       if ( data != LUA_NOREF ) {
          lua_rawgeti( naevL, LUA_REGISTRYINDEX, data );
          ai_run( env, 1 );
       } else
          ai_run( env, 0 );
+      if ( stats < array_size( prof->tasks ) )
+         ai_profEnd( &prof->tasks[stats], tstart, mstart );
 
       /* Manual control must check if IDLE hook has to be run. */
       if ( pilot_isFlag( cur_pilot, PILOT_MANUAL_CONTROL ) ) {
@@ -1183,10 +1431,12 @@ Task *ai_newtask( lua_State *L, Pilot *p, const char *func, int subtask,
    luaL_checktype( L, -1, LUA_TFUNCTION );
 
    /* Create the new task. */
-   t       = ncalloc( 1, sizeof( Task ) );
-   t->name = strdup( func );
-   t->func = luaL_ref( L, LUA_REGISTRYINDEX );
-   t->dat  = LUA_NOREF;
+   t        = ncalloc( 1, sizeof( Task ) );
+   t->name  = strdup( func );
+   t->func  = luaL_ref( L, LUA_REGISTRYINDEX );
+   t->dat   = LUA_NOREF;
+   t->stats = ai_profTask( p->ai, func );
+   t->prof  = p->ai;
 
    /* Handle subtask and general task. */
    if ( !subtask ) {
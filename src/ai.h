@@ -3,6 +3,10 @@
  */
 #pragma once
 
+/** @cond */
+#include <stdint.h>
+/** @endcond */
+
 #include "nlua.h"
 
 /* Forward declaration to avoid cyclical import. */
@@ -28,9 +32,22 @@ typedef struct Task_ {
 
    struct Task_ *subtask; /**< Subtasks of the current task. */
 
-   int dat; /**< Lua reference to the data (index in registry). */
+   int dat;   /**< Lua reference to the data (index in registry). */
+   int stats; /**< Index in the task statistics of the profile. */
+   const struct AI_Profile_ *prof; /**< Profile stats is an index of. */
 } Task;
 
+/**
+ * @brief Profiling counters of an AI profile function.
+ */
+typedef struct AIProfStats_ {
+   char    *name;     /**< Name of the task function. */
+   uint64_t calls;    /**< Number of times it was run. */
+   double   time;     /**< Total time spent in it (seconds). */
+   double   time_max; /**< Longest single run (seconds). */
+   double   mem;      /**< Lua memory allocated by it (bytes). */
+} AIProfStats;
+
 /**
  * @struct AI_Profile
  *
@@ -46,8 +63,22 @@ typedef struct AI_Profile_ {
    int ref_refuel;         /**< Profile refuel reference function. */
    int ref_create; /**< Run when pilot is created (or initialized in the case of
                       persistent pilots). */
+
+   /* Profiling. */
+   AIProfStats  control; /**< Control function counters. */
+   AIProfStats *tasks;   /**< Task function counters (array.h). */
 } AI_Profile;
 
+/**
+ * @brief Statistics of the AI control tick scheduler.
+ */
+typedef struct AIStats_ {
+   uint64_t control;        /**< Control ticks run. */
+   uint64_t deferred;       /**< Control ticks deferred to a later frame. */
+   int      deferred_frame; /**< Control ticks deferred in the last frame. */
+   double   frame_time; /**< Seconds of control ticks in the last frame. */
+} AIStats;
+
 /**
  * @struct AIMemory
  *
@@ -64,7 +95,9 @@ typedef struct AIMemory_ {
 /*
  * misc
  */
-AI_Profile *ai_getProfile( const char *name );
+AI_Profile       *ai_getProfile( const char *name );
+const AI_Profile *ai_getProfiles( void );
+void              ai_profReset( void );
 
 /*
  * init/exit
@@ -97,9 +130,12 @@ void ai_hail( Pilot *recipient );
 void ai_refuel( Pilot *refueler, unsigned int target );
 void ai_getDistress( const Pilot *p, const Pilot *distressed,
                      const Pilot *attacker );
+void ai_frameStart( void );
+void ai_updateSlots( double dt );
 void ai_think( Pilot *pilot, double dt, int dotask );
 AIMemory ai_setPilot( Pilot *p );
 void     ai_unsetPilot( AIMemory oldmem );
 void     ai_thinkSetup( double dt );
 void     ai_thinkApply( Pilot *p );
 void     ai_init( Pilot *p );
+void     ai_getStats( AIStats *stats );
@@ -66,6 +66,17 @@ static glTexture **asteroid_gfx =
    NULL; /**< Graphics for the asteroids (array.h). */
 static int asteroid_creating = 0;
 
+/**
+ * @brief Asteroid to render, by index so that it can be checked at render time.
+ */
+typedef struct AsteroidRef_ {
+   int field; /**< Index of the field in the current system. */
+   int id;    /**< Index of the asteroid in the field. */
+} AsteroidRef;
+static AsteroidRef *asteroid_visible =
+   NULL; /**< Asteroids to render this frame (array.h). */
+static IntList asteroid_qtquery; /**< For querying visible asteroids. */
+
 /* Prototypes. */
 static int asttype_cmp( const void *p1, const void *p2 );
 static int asttype_parse( AsteroidType *at, const char *file );
@@ -893,35 +904,113 @@ void asteroids_renderOverlay( void )
    NTracingZoneEnd( _ctx );
 }
 
+/**
+ * @brief Compares asteroid references by their index in the field for qsort.
+ */
+static int asteroid_cmpRef( const void *p1, const void *p2 )
+{
+   const AsteroidRef *r1 = p1;
+   const AsteroidRef *r2 = p2;
+   return r1->id - r2->id;
+}
+
+/**
+ * @brief Builds the list of asteroids to render this frame.
+ *
+ *    @param view Visible region of the game world.
+ *    @param[out] stats Culling counters to update.
+ */
+void asteroids_cull( const RenderView *view, RenderCullStats *stats )
+{
+   if ( asteroid_visible == NULL ) {
+      asteroid_visible = array_create( AsteroidRef );
+      il_create( &asteroid_qtquery, 1 );
+   }
+   array_resize( &asteroid_visible, 0 );
+
+   if ( cur_system == NULL )
+      return;
+
+   for ( int i = 0; i < array_size( cur_system->asteroids ); i++ ) {
+      AsteroidAnchor *ast   = &cur_system->asteroids[i];
+      int             start = array_size( asteroid_visible );
+      int             n;
+
+      /* See if the asteroid field is in range, if not skip. */
+      if ( render_viewOutside( view, ast->pos.x, ast->pos.y, ast->radius ) ) {
+         stats->asteroids_culled += array_size( ast->asteroids );
+         continue;
+      }
+
+      /* Foreground asteroids come from the quadtree, which is built after they
+       * move. */
+      if ( ast->qt_init ) {
+         qt_query( &ast->qt, &asteroid_qtquery, floor( view->x1 ),
+                   floor( view->y1 ), ceil( view->x2 ), ceil( view->y2 ) );
+         for ( int j = 0; j < il_size( &asteroid_qtquery ); j++ ) {
+            int             id = il_get( &asteroid_qtquery, j, 0 );
+            const Asteroid *a  = &ast->asteroids[id];
+            if ( ( a->state == ASTEROID_FG ) && !a->scanned ) {
+               AsteroidRef ref = { .field = i, .id = id };
+               array_push_back( &asteroid_visible, ref );
+            }
+         }
+      }
+
+      /* The rest are not in the quadtree and are tested directly. */
+      for ( int j = 0; j < array_size( ast->asteroids ); j++ ) {
+         const Asteroid *a = &ast->asteroids[j];
+         double          r;
+
+         if ( ( a->state == ASTEROID_XX ) ||
+              ( ( a->state == ASTEROID_FG ) && !a->scanned ) )
+            continue;
+
+         r = MAX( tex_sw( a->gfx ), tex_sh( a->gfx ) );
+         /* Scanned asteroids have their text to the right. */
+         if ( a->scanned )
+            r += gl_printWidthRaw( &gl_smallFont,
+                                   _( a->type->scanned_msg ) ) /
+                 cam_getZoom();
+         if ( !render_viewOutside( view, a->sol.pos.x, a->sol.pos.y, r ) ) {
+            AsteroidRef ref = { .field = i, .id = j };
+            array_push_back( &asteroid_visible, ref );
+         }
+      }
+
+      /* Keep the drawing order of the field. */
+      n = array_size( asteroid_visible ) - start;
+      qsort( &asteroid_visible[start], n, sizeof( AsteroidRef ),
+             asteroid_cmpRef );
+      stats->asteroids_drawn += n;
+      stats->asteroids_culled += array_size( ast->asteroids ) - n;
+   }
+}
+
 /**
  * @brief Renders the current systems' spobs.
  */
 void asteroids_render( void )
 {
-   double cx, cy, z;
+   double cx, cy;
    cam_getPos( &cx, &cy );
-   z = cam_getZoom();
    cx -= SCREEN_W / 2.;
    cy -= SCREEN_H / 2.;
 
    NTracingZone( _ctx, 1 );
    gl_debugGroupStart();
 
-   /* Render the asteroids & debris. */
-   for ( int i = 0; i < array_size( cur_system->asteroids ); i++ ) {
-      const AsteroidAnchor *ast = &cur_system->asteroids[i];
-      double                x, y, r;
-
-      /* See if the asteroid field is in range, if not skip. */
-      gl_gameToScreenCoords( &x, &y, ast->pos.x, ast->pos.y );
-      r = ast->radius * z;
-      if ( ( x < -r ) || ( x > SCREEN_W + r ) || ( y < -r ) ||
-           ( y > SCREEN_H + r ) )
-         continue;
-
-      /* Render all asteroids. */
-      for ( int j = 0; j < array_size( ast->asteroids ); j++ )
-         asteroid_renderSingle( &ast->asteroids[j] );
+   /* Render the asteroids that passed culling. Lua may have changed the
+    * system since, so the references have to be checked. */
+   for ( int i = 0; i < array_size( asteroid_visible ); i++ ) {
+      const AsteroidRef    *ref = &asteroid_visible[i];
+      const AsteroidAnchor *ast;
+      if ( ( cur_system == NULL ) ||
+           ( ref->field >= array_size( cur_system->asteroids ) ) )
+         break;
+      ast = &cur_system->asteroids[ref->field];
+      if ( ref->id < array_size( ast->asteroids ) )
+         asteroid_renderSingle( &ast->asteroids[ref->id] );
    }
 
    /* Render the debris. */
@@ -1103,6 +1192,13 @@ void asteroids_free( void )
    array_free( debris_stack );
    debris_stack = NULL;
 
+   /* Clean up culling. */
+   if ( asteroid_visible != NULL ) {
+      array_free( asteroid_visible );
+      asteroid_visible = NULL;
+      il_destroy( &asteroid_qtquery );
+   }
+
    /* Free the gatherable stack. */
    gatherable_free();
 }
@@ -11,6 +11,7 @@
 #include "outfit.h"
 #include "physics.h"
 #include "quadtree.h"
+#include "render.h"
 
 #define ASTEROID_DEFAULT_RADIUS                                                \
    2500. /**< Default radius of an asteroid field. */
@@ -150,6 +151,7 @@ void asteroids_init( void );
 
 /* Updating and rendering. */
 void asteroids_update( double dt );
+void asteroids_cull( const RenderView *view, RenderCullStats *stats );
 void asteroids_render( void );
 void asteroids_renderOverlay( void );
 
@@ -17,6 +17,7 @@
 #include "log.h"
 #include "mission.h"
 #include "space.h"
+#include "strmap.h"
 
 /**
  * @brief The claim structure.
@@ -31,7 +32,32 @@ struct Claim_s {
       block any exclusive claims. */
 };
 
-static char **claimed_strs = NULL; /**< Global claimed strings. */
+static StrMap claimed_strs; /**< Claimed strings to number of claims. */
+
+static void claim_strAdd( const char *str );
+static void claim_strRemove( const char *str );
+
+/**
+ * @brief Adds a claim on a string to the claimed string set.
+ */
+static void claim_strAdd( const char *str )
+{
+   int *count = strmap_get( &claimed_strs, str );
+   if ( count != NULL )
+      ( *count )++;
+   else
+      strmap_set( &claimed_strs, str, 1 );
+}
+
+/**
+ * @brief Removes a claim on a string from the claimed string set.
+ */
+static void claim_strRemove( const char *str )
+{
+   int *count = strmap_get( &claimed_strs, str );
+   if ( ( count != NULL ) && ( --( *count ) <= 0 ) )
+      strmap_remove( &claimed_strs, str );
+}
 
 /**
  * @brief Creates a system claim.
@@ -128,12 +154,9 @@ int claim_test( const Claim_t *claim )
    }
 
    /* Check strings. */
-   for ( int i = 0; i < array_size( claim->strs ); i++ ) {
-      for ( int j = 0; j < array_size( claimed_strs ); j++ ) {
-         if ( strcmp( claim->strs[i], claimed_strs[j] ) == 0 )
-            return 1;
-      }
-   }
+   for ( int i = 0; i < array_size( claim->strs ); i++ )
+      if ( strmap_get( &claimed_strs, claim->strs[i] ) != NULL )
+         return 1;
 
    return 0;
 }
@@ -200,16 +223,8 @@ void claim_destroy( Claim_t *claim )
    array_free( claim->ids );
 
    for ( int i = 0; i < array_size( claim->strs ); i++ ) {
-      if ( claim->active ) {
-         for ( int j = 0; j < array_size( claimed_strs ); j++ ) {
-            if ( strcmp( claim->strs[i], claimed_strs[j] ) == 0 ) {
-               free( claimed_strs[j] );
-               array_erase( &claimed_strs, &claimed_strs[j],
-                            &claimed_strs[j + 1] );
-               break;
-            }
-         }
-      }
+      if ( claim->active )
+         claim_strRemove( claim->strs[i] );
       free( claim->strs[i] );
    }
    array_free( claim->strs );
@@ -228,10 +243,7 @@ void claim_clear( void )
       sys[i].claims_soft = 0;
    }
 
-   for ( int i = 0; i < array_size( claimed_strs ); i++ )
-      free( claimed_strs[i] );
-   array_free( claimed_strs );
-   claimed_strs = NULL;
+   strmap_free( &claimed_strs );
 }
 
 /**
@@ -261,10 +273,8 @@ void claim_activate( Claim_t *claim )
    }
 
    /* Add strings. */
-   if ( ( claimed_strs == NULL ) && ( array_size( claim->strs ) > 0 ) )
-      claimed_strs = array_create( char * );
    for ( int i = 0; i < array_size( claim->strs ); i++ )
-      array_push_back( &claimed_strs, strdup( claim->strs[i] ) );
+      claim_strAdd( claim->strs[i] );
    claim->active = 1;
 }
 
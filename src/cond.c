@@ -15,8 +15,16 @@
 #include "log.h"
 #include "nlua.h"
 #include "nstring.h"
+#include "strmap.h"
+
+#define COND_CACHE_MAX 256 /**< Maximum number of cached conditionals. */
 
 static nlua_env *cond_env = NULL; /** Conditional Lua env. */
+static StrMap    cond_cache;      /**< Conditionals to compiled chunks. */
+static CondStats cond_stats;      /**< Cache statistics. */
+
+static void cond_cacheFlush( void );
+static int  cond_cacheGet( const char *cond );
 
 /**
  * @brief Initializes the conditional subsystem.
@@ -40,10 +48,62 @@ int cond_init( void )
  */
 void cond_exit( void )
 {
+   cond_cacheFlush();
+   strmap_free( &cond_cache );
+
    nlua_freeEnv( cond_env );
    cond_env = NULL;
 }
 
+/**
+ * @brief Releases all the cached conditionals.
+ */
+static void cond_cacheFlush( void )
+{
+   for ( unsigned int i = 0; i < cond_cache.size; i++ )
+      if ( ( cond_cache.keys[i] != NULL ) &&
+           ( cond_cache.vals[i] != LUA_NOREF ) )
+         luaL_unref( naevL, LUA_REGISTRYINDEX, cond_cache.vals[i] );
+   cond_stats.evictions += cond_cache.used;
+   strmap_clear( &cond_cache );
+}
+
+/**
+ * @brief Gets the compiled chunk of a conditional, compiling it if necessary.
+ *
+ * The cache is flushed when it is full, so that conditionals generated on the
+ * fly can't make it grow without bound.
+ *
+ *    @param cond Conditional string to get.
+ *    @return The chunk of the conditional or LUA_NOREF if it doesn't compile.
+ */
+static int cond_cacheGet( const char *cond )
+{
+   const int *chunk = strmap_get( &cond_cache, cond );
+   if ( chunk != NULL ) {
+      cond_stats.hits++;
+      return *chunk;
+   }
+   cond_stats.misses++;
+
+   /* Make room. */
+   if ( cond_cache.used >= COND_CACHE_MAX )
+      cond_cacheFlush();
+
+   return *strmap_set( &cond_cache, cond, cond_compile( cond ) );
+}
+
+/**
+ * @brief Gets the statistics of the conditional cache.
+ *
+ *    @param[out] stats Statistics of the cache.
+ */
+void cond_getStats( CondStats *stats )
+{
+   *stats         = cond_stats;
+   stats->entries = cond_cache.used;
+}
+
 /**
  * @brief Compiles a conditional statement that can then be used as a reference.
  *
@@ -95,70 +155,18 @@ cond_err:
 /**
  * @brief Checks to see if a condition is true.
  *
+ * Conditions are compiled once and cached, so checking the same condition
+ * again only has to run the chunk.
+ *
  *    @param cond Condition to check.
  *    @return 0 if is false, 1 if is true, -1 on error.
  */
 int cond_check( const char *cond )
 {
-   int  ret;
-   char buf[STRMAX_SHORT];
-
-   /* Load the string directly. */
-   if ( strstr( cond, "return" ) != NULL ) {
-      lua_pushstring( naevL, cond );
-   } else {
-      /* Append "return" first. */
-      lua_pushstring( naevL, "return " );
-      lua_pushstring( naevL, cond );
-      lua_concat( naevL, 2 );
-   }
-   ret = nlua_dobufenv( cond_env, lua_tostring( naevL, -1 ),
-                        lua_strlen( naevL, -1 ), "Lua Conditional" );
-   switch ( ret ) {
-   case LUA_ERRSYNTAX:
-      snprintf( buf, sizeof( buf ), _( "Lua conditional syntax error: %s" ),
-                lua_tostring( naevL, -1 ) );
-      goto cond_err;
-   case LUA_ERRRUN:
-      snprintf( buf, sizeof( buf ),
-                _( "Lua Conditional had a runtime error: %s" ),
-                lua_tostring( naevL, -1 ) );
-      goto cond_err;
-   case LUA_ERRMEM:
-      snprintf( buf, sizeof( buf ),
-                _( "Lua Conditional ran out of memory: %s" ),
-                lua_tostring( naevL, -1 ) );
-      goto cond_err;
-   case LUA_ERRERR:
-      snprintf(
-         buf, sizeof( buf ),
-         _( "Lua Conditional had an error while handling error function: %s" ),
-         lua_tostring( naevL, -1 ) );
-      goto cond_err;
-   default:
-      break;
-   }
-
-   /* Check the result. */
-   if ( lua_isboolean( naevL, -1 ) ) {
-      ret = !!lua_toboolean( naevL, -1 );
-      lua_pop( naevL, 1 );
-
-      /* Clear the stack. */
-      lua_settop( naevL, 0 );
-
-      return ret;
-   }
-   snprintf( buf, sizeof( buf ),
-             _( "Lua Conditional didn't return a boolean" ) );
-
-cond_err:
-   print_with_line_numbers( cond );
-   WARN( "%s", buf );
-
-   /* Clear the stack. */
-   lua_settop( naevL, 0 );
-   return -1;
+   int chunk = cond_cacheGet( cond );
+   if ( chunk == LUA_NOREF )
+      return -1;
+   return cond_checkChunk( chunk, cond );
 }
 
 int cond_checkChunk( int chunk, const char *cond )
@@ -3,8 +3,21 @@
  */
 #pragma once
 
+#include <stdint.h>
+
+/**
+ * @brief Statistics of the conditional cache.
+ */
+typedef struct CondStats_ {
+   uint64_t hits;      /**< Conditionals found already compiled. */
+   uint64_t misses;    /**< Conditionals that had to be compiled. */
+   uint64_t evictions; /**< Compiled conditionals thrown out of the cache. */
+   uint64_t entries;   /**< Number of conditionals currently cached. */
+} CondStats;
+
 int  cond_init( void );
 void cond_exit( void );
 int  cond_compile( const char *cond );
 int  cond_check( const char *cond );
 int  cond_checkChunk( int chunk, const char *cond );
+void cond_getStats( CondStats *stats );
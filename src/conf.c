@@ -218,7 +218,8 @@ void conf_setVideoDefaults( void )
 {
    int w, h, f;
 
-   conf.num_backups = NUM_BACKUPS_DEFAULT;
+   conf.num_backups   = NUM_BACKUPS_DEFAULT;
+   conf.save_compress = SAVE_COMPRESS_DEFAULT;
 
    /* More complex resolution handling. */
    f                                 = 0;
@@ -264,6 +265,7 @@ void conf_setVideoDefaults( void )
    conf.gamma_correction    = GAMMA_CORRECTION_DEFAULT;
    conf.low_memory          = LOW_MEMORY_DEFAULT;
    conf.max_3d_tex_size     = MAX_3D_TEX_SIZE;
+   conf.outfit_gfx_budget   = OUTFIT_GFX_BUDGET_DEFAULT;
 
    if ( cur_system )
       background_load( cur_system->background );
@@ -337,6 +339,9 @@ int conf_loadConfig( const char *file )
    /* ndata. */
    conf_loadString( L, "data", conf.ndata );
 
+   /* Saves. */
+   conf_loadBool( L, "save_compress", conf.save_compress );
+
    /* Language. */
    conf_loadString( L, "language", conf.language );
 
@@ -385,6 +390,7 @@ int conf_loadConfig( const char *file )
    conf_loadFloat( L, "gamma_correction", conf.gamma_correction );
    conf_loadBool( L, "low_memory", conf.low_memory );
    conf_loadInt( L, "max_3d_tex_size", conf.max_3d_tex_size );
+   conf_loadInt( L, "outfit_gfx_budget", conf.outfit_gfx_budget );
 
    /* FPS */
    conf_loadBool( L, "showfps", conf.fps_show );
@@ -895,6 +901,10 @@ int conf_saveConfig( const char *file )
    conf_saveInt( "num_backups", conf.num_backups );
    conf_saveEmptyLine();
 
+   conf_saveComment( _( "Compress saved games with gzip" ) );
+   conf_saveBool( "save_compress", conf.save_compress );
+   conf_saveEmptyLine();
+
    /* Language. */
    conf_saveComment(
       _( "Language to use. Set to the two character identifier to the language "
@@ -1037,6 +1047,13 @@ int conf_saveConfig( const char *file )
    conf_saveInt( "max_3d_tex_size", conf.max_3d_tex_size );
    conf_saveEmptyLine();
 
+   conf_saveComment(
+      _( "Memory budget in MiB for outfit store graphics. Graphics that have "
+         "not been used recently are unloaded when taking off if the budget is "
+         "exceeded. A value of less than or equal to 0 keeps them all." ) );
+   conf_saveInt( "outfit_gfx_budget", conf.outfit_gfx_budget );
+   conf_saveEmptyLine();
+
    /* FPS */
    conf_saveComment( _( "Display a frame rate counter" ) );
    conf_saveBool( "showfps", conf.fps_show );
@@ -11,6 +11,7 @@
  * CONFIGURATION DEFAULTS
  */
 #define NUM_BACKUPS_DEFAULT 5 /**< Number of backups. */
+#define SAVE_COMPRESS_DEFAULT 1 /**< Whether to compress saved games. */
 /* Gameplay options */
 #define DOUBLETAP_SENSITIVITY_DEFAULT                                          \
    250 /**< Default afterburner sensitivity. */
@@ -78,6 +79,8 @@
 #define FONT_SIZE_SMALL_DEFAULT 11   /**< Default small font size. */
 #define LOW_MEMORY_DEFAULT 0         /**< Default for low memory mode. */
 #define MAX_3D_TEX_SIZE 256          /**< Maximum 3D texture size. */
+#define OUTFIT_GFX_BUDGET_DEFAULT                                              \
+   128 /**< Memory budget (in MiB) for outfit store graphics. */
 /* Audio options */
 #define USE_EFX_DEFAULT 1 /**< Whether or not to use EFX (if using OpenAL). */
 #define MUTE_SOUND_DEFAULT 0      /**< Whether sound should be disabled. */
@@ -99,7 +102,8 @@ typedef struct PlayerConf_s {
    char *datapath; /**< Path for user data (saves, screenshots, etc.). */
 
    /* Saves. */
-   int num_backups; /**< Number of backups. */
+   int num_backups;   /**< Number of backups. */
+   int save_compress; /**< Whether to compress saved games. */
 
    /* Language. */
    char *language; /**< Language to use. */
@@ -133,6 +137,8 @@ typedef struct PlayerConf_s {
    int    low_memory;       /**< Low memory mode. */
    int max_3d_tex_size; /**< How large to make the textures in low memory mode.
                          */
+   int outfit_gfx_budget; /**< Memory budget (in MiB) for outfit store graphics
+                             kept around, or <= 0 to keep them all. */
 
    /* Sound. */
    int
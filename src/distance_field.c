@@ -38,122 +38,611 @@ policies, either expressed or implied, of the freetype-gl project.
  */
 
 /** @cond */
-#include <float.h>
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
 /** @endcond */
 
-#include "edtaa3func.h"
+#include <SDL3/SDL_cpuinfo.h>
+#include <SDL3/SDL_mutex.h>
+#include <SDL3/SDL_thread.h>
+
+#include "distance_field.h"
+
+#define SDF_INF 1e20 /**< Squared distance used for "infinitely far". */
+#define SDF_THREAD_PIXELS                                                      \
+   ( 256 * 256 ) /**< Images at least this big get split across threads. */
+#define SDF_THREAD_MAX 8 /**< Maximum number of threads to use. */
+#define SDF_EDGE_MAX                                                           \
+   ( 0.5 * M_SQRT2 ) /**< Furthest an edge can be from the pixel centre. */
 
 /**
- * @brief Like the original: perform a Euclidean Distance Transform on the input
- * and normalize to [0,1], with a value of 0.5 on the boundary.
- * @param data width*height values, row-major order. Positive values are object
- * pixels. Negative/zero values are background pixels.
- * @param width Number of columns.
- * @param height Number of rows.
- * @param[out] vmax The underlying distance value corresponding to +1.0.
- * @return Allocated distance field, values ranging from 0 (farthest inside) to
- * 1 (greatest distance).
+ * @brief Steps of the distance transform.
  */
-double *make_distance_mapd( double *data, unsigned int width,
-                            unsigned int height, double *vmax )
+typedef enum EDTStep_ {
+   EDT_COLUMNS, /**< 1D transform of the columns. */
+   EDT_ROWS,    /**< 1D transform of the rows. */
+   EDT_REFINE,  /**< Distances to the edge instead of the seeds. */
+} EDTStep;
+
+/**
+ * @brief Jobs of a single pass of the distance transform still being run.
+ */
+typedef struct EDTPass_ {
+   int left;   /**< Number of queued jobs that haven't finished. */
+   int failed; /**< Whether any of the jobs failed. */
+} EDTPass;
+
+/**
+ * @brief Work done by a single thread of the exact distance transform.
+ */
+typedef struct EDTJob_ {
+   double         *grid[2]; /**< Squared distance grids, done in place. */
+   int            *seed[2]; /**< Nearest seed of each pixel for each grid. */
+   const double   *cov;     /**< Coverage of the pixels. */
+   int             w;       /**< Width of the grids. */
+   int             h;       /**< Height of the grids. */
+   EDTStep         step;    /**< Step of the transform to run. */
+   int             start;   /**< First line to transform. */
+   int             end;     /**< One past the last line to transform. */
+   EDTPass        *pass;    /**< Pass the job belongs to. */
+   struct EDTJob_ *next;    /**< Next job in the queue. */
+} EDTJob;
+
+/*
+ * Worker threads, shared by all the callers.
+ */
+static SDL_InitState  sdf_init;            /**< Whether the workers started. */
+static int            sdf_nworkers = 0;    /**< Number of worker threads. */
+static SDL_Mutex     *sdf_lock     = NULL; /**< Protects the queue. */
+static SDL_Condition *sdf_work     = NULL; /**< Signalled on queued jobs. */
+static SDL_Condition *sdf_done     = NULL; /**< Signalled on finished jobs. */
+static EDTJob        *sdf_head     = NULL; /**< First job of the queue. */
+static EDTJob        *sdf_tail     = NULL; /**< Last job of the queue. */
+
+static double  edt_edge( double gx, double gy, double l, double a );
+static double  edt_edgeLocal( const double *cov, int w, int h, int x, int y,
+                              double a );
+static double  edt_edgeDist( const double *cov, int w, int h, int x, int y,
+                             int s, int inside );
+static void    edt_try( double *dist, int *seed, const double *cov, int w,
+                        int h, int x, int y, int n, int inside );
+static void    edt_refine( double *dist, int *seed, const double *cov, int w,
+                           int h, int y0, int y1, int inside );
+static int     edt_job( void *data );
+static EDTJob *sdf_dequeue( void );
+static void    sdf_finish( EDTJob *job, int ret );
+static int     sdf_worker( void *data );
+static int     sdf_start( void );
+
+/**
+ * @brief Exact 1D squared Euclidean distance transform of a line of a grid
+ * (Felzenszwalb and Huttenlocher).
+ *
+ * Works on a copy of the line so that columns are processed from contiguous
+ * memory.
+ * @param[out] idx Position along the line of the nearest point for each
+ * element.
+ */
+static void edt_line( double *grid, int offset, int stride, int n, double *f,
+                      double *z, int *v, int *idx )
 {
-   unsigned int wh      = width * height;
-   short       *xdist   = (short *)malloc( wh * sizeof( short ) );
-   short       *ydist   = (short *)malloc( wh * sizeof( short ) );
-   double      *gx      = (double *)calloc( wh, sizeof( double ) );
-   double      *gy      = (double *)calloc( wh, sizeof( double ) );
-   double      *outside = (double *)calloc( wh, sizeof( double ) );
-   double      *inside  = (double *)calloc( wh, sizeof( double ) );
-
-   // Compute outside = edtaa3(bitmap); % Transform background (0's)
-   computegradient( data, width, height, gx, gy );
-   edtaa3( data, gx, gy, width, height, xdist, ydist, outside );
-   for ( unsigned int i = 0; i < wh; i++ )
-      if ( outside[i] < 0.0 )
-         outside[i] = 0.0;
-
-   // Compute inside = edtaa3(1-bitmap); % Transform foreground (1's)
-   memset( gx, 0, sizeof( double ) * width * height );
-   memset( gy, 0, sizeof( double ) * width * height );
-   for ( unsigned int i = 0; i < wh; i++ )
-      data[i] = 1. - data[i];
-   computegradient( data, width, height, gx, gy );
-   edtaa3( data, gx, gy, width, height, xdist, ydist, inside );
-   for ( unsigned int i = 0; i < wh; i++ )
-      if ( inside[i] < 0. )
-         inside[i] = 0.;
+   int k = 0;
 
-   // distmap = outside - inside; % Bipolar distance field
-   *vmax = 0.;
-   for ( unsigned int i = 0; i < wh; i++ ) {
-      outside[i] -= inside[i];
-      if ( *vmax < fabs( outside[i] ) )
-         *vmax = fabs( outside[i] );
+   for ( int q = 0; q < n; q++ )
+      f[q] = grid[offset + q * stride];
+
+   /* Compute the lower envelope of the parabolas. */
+   v[0] = 0;
+   z[0] = -SDF_INF;
+   z[1] = +SDF_INF;
+   for ( int q = 1; q < n; q++ ) {
+      double s;
+      do {
+         int r = v[k];
+         s     = ( f[q] - f[r] + (double)q * q - (double)r * r ) /
+             ( 2. * ( q - r ) );
+      } while ( ( s <= z[k] ) && ( --k >= 0 ) );
+      k++;
+      v[k]     = q;
+      z[k]     = s;
+      z[k + 1] = +SDF_INF;
    }
 
-   for ( unsigned int i = 0; i < wh; i++ ) {
-      double v = outside[i];
-      if ( v < -*vmax )
-         outside[i] = -*vmax;
-      else if ( v > +*vmax )
-         outside[i] = +*vmax;
-      data[i] = ( outside[i] + *vmax ) / ( 2. * *vmax );
-   }
-
-   free( xdist );
-   free( ydist );
-   free( gx );
-   free( gy );
-   free( outside );
-   free( inside );
-   return data;
+   /* Sample it. */
+   k = 0;
+   for ( int q = 0; q < n; q++ ) {
+      while ( z[k + 1] < q )
+         k++;
+      idx[q] = v[k];
+      grid[offset + q * stride] =
+         f[v[k]] + (double)( q - v[k] ) * ( q - v[k] );
+   }
+}
+
+/**
+ * @brief Distance from the centre of a pixel to an edge crossing it.
+ *
+ * Assumes the pixel is a box filtered sample of a straight edge.
+ *    @param gx X component of the direction across the edge.
+ *    @param gy Y component of the direction across the edge.
+ *    @param l Length of the direction.
+ *    @param a Coverage of the pixel.
+ *    @return Distance to the edge, negative if the centre is covered.
+ */
+static double edt_edge( double gx, double gy, double l, double a )
+{
+   double a1;
+
+   /* Axis aligned, or no idea of the direction. */
+   if ( ( gx == 0. ) || ( gy == 0. ) )
+      return 0.5 - a;
+
+   /* Symmetric, so only the first octant has to be handled. */
+   gx = fabs( gx ) / l;
+   gy = fabs( gy ) / l;
+   if ( gx < gy ) {
+      double t = gx;
+      gx       = gy;
+      gy       = t;
+   }
+
+   /* The edge cuts a corner off the pixel near 0 or 1 coverage. */
+   a1 = 0.5 * gy / gx;
+   if ( a < a1 )
+      return 0.5 * ( gx + gy ) - sqrt( 2. * gx * gy * a );
+   else if ( a < 1. - a1 )
+      return ( 0.5 - a ) * gx;
+   return -0.5 * ( gx + gy ) + sqrt( 2. * gx * gy * ( 1. - a ) );
+}
+
+/**
+ * @brief Distance from the centre of a seed to the edge crossing it, using
+ * the gradient of the coverage as the edge direction.
+ *    @param cov Coverage of the pixels.
+ *    @param w Width of the image.
+ *    @param h Height of the image.
+ *    @param x X position of the seed.
+ *    @param y Y position of the seed.
+ *    @param a Coverage of the seed as seen from the side being measured.
+ */
+static double edt_edgeLocal( const double *cov, int w, int h, int x, int y,
+                             double a )
+{
+   int    i = y * w + x;
+   double gx, gy;
+
+   /* Not enough neighbours for the gradient on the border. */
+   if ( ( x <= 0 ) || ( y <= 0 ) || ( x >= w - 1 ) || ( y >= h - 1 ) )
+      return 0.5 - a;
+   gx = -cov[i - w - 1] - M_SQRT2 * cov[i - 1] - cov[i + w - 1] +
+        cov[i - w + 1] + M_SQRT2 * cov[i + 1] + cov[i + w + 1];
+   gy = -cov[i - w - 1] - M_SQRT2 * cov[i - w] - cov[i - w + 1] +
+        cov[i + w - 1] + M_SQRT2 * cov[i + w] + cov[i + w + 1];
+   return edt_edge( gx, gy, sqrt( gx * gx + gy * gy ), a );
+}
+
+/**
+ * @brief Distance from a pixel to the edge crossing a seed.
+ *
+ * Seeds away from the pixel use the direction to the pixel as the edge
+ * direction, which is what edtaa3 does.
+ *    @param cov Coverage of the pixels.
+ *    @param w Width of the image.
+ *    @param h Height of the image.
+ *    @param x X position of the pixel.
+ *    @param y Y position of the pixel.
+ *    @param s Seed to measure to.
+ *    @param inside Whether measuring from the inside.
+ */
+static double edt_edgeDist( const double *cov, int w, int h, int x, int y,
+                            int s, int inside )
+{
+   int    sy = s / w;
+   int    sx = s - sy * w;
+   double a  = inside ? 1. - cov[s] : cov[s];
+   double dx = x - sx;
+   double dy = y - sy;
+   double l;
+
+   if ( ( sx == x ) && ( sy == y ) )
+      return edt_edgeLocal( cov, w, h, x, y, a );
+   l = sqrt( dx * dx + dy * dy );
+   return l + edt_edge( dx, dy, l, a );
+}
+
+/**
+ * @brief Tries to get closer to the edge with the seed of a neighbour.
+ */
+static void edt_try( double *dist, int *seed, const double *cov, int w, int h,
+                     int x, int y, int n, int inside )
+{
+   int    i = y * w + x;
+   int    s = seed[n];
+   int    sy, sx;
+   double dx, dy, d;
+
+   /* Neighbours mostly share seeds. */
+   if ( s == seed[i] )
+      return;
+
+   /* Edges are at most half a pixel diagonal from the centre of the seed. */
+   sy = s / w;
+   sx = s - sy * w;
+   dx = x - sx;
+   dy = y - sy;
+   d  = dist[i] + SDF_EDGE_MAX;
+   if ( ( d > 0. ) && ( dx * dx + dy * dy >= d * d ) )
+      return;
+
+   d = edt_edgeDist( cov, w, h, x, y, s, inside );
+   if ( d < dist[i] ) {
+      dist[i] = d;
+      seed[i] = s;
+   }
+}
+
+/**
+ * @brief Turns the squared distances to the nearest seed into distances to
+ * the edge for a range of rows.
+ *
+ * The nearest seed isn't always the one with the nearest edge, so like edtaa3
+ * the seeds are swept forwards and backwards once to find better ones. The
+ * sweeps stay within the rows so that ranges can be done in parallel.
+ *    @param[in,out] dist Squared distances to the nearest seed, replaced by
+ * the distances to the edge.
+ *    @param[in,out] seed Nearest seed of each pixel.
+ *    @param cov Coverage of the pixels.
+ *    @param w Width of the image.
+ *    @param h Height of the image.
+ *    @param y0 First row to refine.
+ *    @param y1 One past the last row to refine.
+ *    @param inside Whether measuring from the inside.
+ */
+static void edt_refine( double *dist, int *seed, const double *cov, int w,
+                        int h, int y0, int y1, int inside )
+{
+   for ( int y = y0; y < y1; y++ )
+      for ( int x = 0; x < w; x++ )
+         dist[y * w + x] =
+            edt_edgeDist( cov, w, h, x, y, seed[y * w + x], inside );
+
+   for ( int y = y0; y < y1; y++ ) {
+      for ( int x = 0; x < w; x++ ) {
+         int i = y * w + x;
+         if ( x > 0 )
+            edt_try( dist, seed, cov, w, h, x, y, i - 1, inside );
+         if ( y <= y0 )
+            continue;
+         if ( x > 0 )
+            edt_try( dist, seed, cov, w, h, x, y, i - w - 1, inside );
+         edt_try( dist, seed, cov, w, h, x, y, i - w, inside );
+         if ( x < w - 1 )
+            edt_try( dist, seed, cov, w, h, x, y, i - w + 1, inside );
+      }
+   }
+   for ( int y = y1 - 1; y >= y0; y-- ) {
+      for ( int x = w - 1; x >= 0; x-- ) {
+         int i = y * w + x;
+         if ( x < w - 1 )
+            edt_try( dist, seed, cov, w, h, x, y, i + 1, inside );
+         if ( y >= y1 - 1 )
+            continue;
+         if ( x < w - 1 )
+            edt_try( dist, seed, cov, w, h, x, y, i + w + 1, inside );
+         edt_try( dist, seed, cov, w, h, x, y, i + w, inside );
+         if ( x > 0 )
+            edt_try( dist, seed, cov, w, h, x, y, i + w - 1, inside );
+      }
+   }
+}
+
+/**
+ * @brief Runs a step of the distance transform over a range of columns or
+ * rows, keeping track of the nearest seed.
+ *
+ * The column pass stores the row of the nearest seed in each column, which
+ * the row pass turns into the index of the nearest seed overall.
+ */
+static int edt_job( void *data )
+{
+   EDTJob *job = data;
+   int     w   = job->w;
+   int     n   = ( job->w > job->h ) ? job->w : job->h;
+   double *f, *z;
+   int    *v, *idx, *tmp;
+   int     ret = 0;
+
+   if ( job->step == EDT_REFINE ) {
+      for ( int g = 0; g < 2; g++ )
+         edt_refine( job->grid[g], job->seed[g], job->cov, w, job->h,
+                     job->start, job->end, g );
+      return 0;
+   }
+
+   f   = malloc( n * sizeof( double ) );
+   z   = malloc( ( n + 1 ) * sizeof( double ) );
+   v   = malloc( n * sizeof( int ) );
+   idx = malloc( n * sizeof( int ) );
+   tmp = malloc( n * sizeof( int ) );
+
+   if ( ( f == NULL ) || ( z == NULL ) || ( v == NULL ) || ( idx == NULL ) ||
+        ( tmp == NULL ) ) {
+      ret = -1;
+      goto out;
+   }
+
+   for ( int g = 0; g < 2; g++ ) {
+      int *seed = job->seed[g];
+      for ( int i = job->start; i < job->end; i++ ) {
+         if ( job->step == EDT_COLUMNS ) {
+            edt_line( job->grid[g], i, w, job->h, f, z, v, idx );
+            for ( int q = 0; q < job->h; q++ )
+               seed[q * w + i] = idx[q];
+         } else {
+            edt_line( job->grid[g], i * w, 1, w, f, z, v, idx );
+            for ( int q = 0; q < w; q++ )
+               tmp[q] = seed[i * w + idx[q]] * w + idx[q];
+            memcpy( &seed[i * w], tmp, w * sizeof( int ) );
+         }
+      }
+   }
+
+out:
+   free( f );
+   free( z );
+   free( v );
+   free( idx );
+   free( tmp );
+   return ret;
+}
+
+/**
+ * @brief Takes the first job off the queue. Must hold sdf_lock.
+ */
+static EDTJob *sdf_dequeue( void )
+{
+   EDTJob *job = sdf_head;
+   if ( job != NULL ) {
+      sdf_head = job->next;
+      if ( sdf_head == NULL )
+         sdf_tail = NULL;
+   }
+   return job;
+}
+
+/**
+ * @brief Marks a queued job as done. Must hold sdf_lock.
+ */
+static void sdf_finish( EDTJob *job, int ret )
+{
+   if ( ret != 0 )
+      job->pass->failed = 1;
+   job->pass->left--;
+   SDL_BroadcastCondition( sdf_done );
+}
+
+/**
+ * @brief Runs queued distance transform jobs forever.
+ */
+static int sdf_worker( void *data )
+{
+   (void)data;
+   SDL_LockMutex( sdf_lock );
+   for ( ;; ) {
+      EDTJob *job = sdf_dequeue();
+      int     ret;
+      if ( job == NULL ) {
+         SDL_WaitCondition( sdf_work, sdf_lock );
+         continue;
+      }
+      SDL_UnlockMutex( sdf_lock );
+      ret = edt_job( job );
+      SDL_LockMutex( sdf_lock );
+      sdf_finish( job, ret );
+   }
+   return 0;
+}
+
+/**
+ * @brief Starts the worker threads the first time they are needed.
+ *
+ * Uses its own threads instead of the threadpool, since this gets called from
+ * threadpool jobs when loading data and vpools can't be nested.
+ *
+ *    @return Number of worker threads available.
+ */
+static int sdf_start( void )
+{
+   if ( SDL_ShouldInit( &sdf_init ) ) {
+      int n = SDL_GetNumLogicalCPUCores();
+      if ( n > SDF_THREAD_MAX )
+         n = SDF_THREAD_MAX;
+      sdf_lock = SDL_CreateMutex();
+      sdf_work = SDL_CreateCondition();
+      sdf_done = SDL_CreateCondition();
+      if ( ( sdf_lock != NULL ) && ( sdf_work != NULL ) &&
+           ( sdf_done != NULL ) ) {
+         /* The caller does its share of the work too. */
+         for ( int i = 1; i < n; i++ ) {
+            SDL_Thread *th = SDL_CreateThread( sdf_worker, "sdf", NULL );
+            if ( th == NULL )
+               break;
+            SDL_DetachThread( th );
+            sdf_nworkers++;
+         }
+      }
+      SDL_SetInitialized( &sdf_init, 1 );
+   }
+   return sdf_nworkers;
+}
+
+/**
+ * @brief Runs a pass of the distance transform, splitting the lines across the
+ * worker threads.
+ *
+ *    @return 0 on success, -1 if out of memory.
+ */
+static int edt_pass( double **grid, int **seed, const double *cov, int w,
+                     int h, EDTStep step, int nthreads )
+{
+   EDTJob  jobs[SDF_THREAD_MAX];
+   EDTPass pass   = { .left = 0, .failed = 0 };
+   int     nlines = ( step == EDT_COLUMNS ) ? w : h;
+
+   if ( nthreads > nlines )
+      nthreads = nlines;
+   for ( int i = 0; i < nthreads; i++ ) {
+      jobs[i] = ( EDTJob ){
+         .grid  = { grid[0], grid[1] },
+         .seed  = { seed[0], seed[1] },
+         .cov   = cov,
+         .w     = w,
+         .h     = h,
+         .step  = step,
+         .start = nlines * i / nthreads,
+         .end   = nlines * ( i + 1 ) / nthreads,
+         .pass  = &pass,
+         .next  = NULL,
+      };
+   }
+   if ( nthreads <= 1 )
+      return edt_job( &jobs[0] );
+
+   /* Queue all but the first job, which is run on this thread. */
+   SDL_LockMutex( sdf_lock );
+   for ( int i = 1; i < nthreads; i++ ) {
+      if ( sdf_tail == NULL )
+         sdf_head = &jobs[i];
+      else
+         sdf_tail->next = &jobs[i];
+      sdf_tail = &jobs[i];
+      pass.left++;
+   }
+   SDL_BroadcastCondition( sdf_work );
+   SDL_UnlockMutex( sdf_lock );
+
+   if ( edt_job( &jobs[0] ) != 0 )
+      pass.failed = 1;
+
+   /* Help with the queue instead of only waiting for the workers. */
+   SDL_LockMutex( sdf_lock );
+   while ( pass.left > 0 ) {
+      EDTJob *job = sdf_dequeue();
+      int     ret;
+      if ( job == NULL ) {
+         SDL_WaitCondition( sdf_done, sdf_lock );
+         continue;
+      }
+      SDL_UnlockMutex( sdf_lock );
+      ret = edt_job( job );
+      SDL_LockMutex( sdf_lock );
+      sdf_finish( job, ret );
+   }
+   SDL_UnlockMutex( sdf_lock );
+   return pass.failed ? -1 : 0;
 }
 
 /**
  * @brief Perform a Euclidean Distance Transform on the input and normalize to
  * [0,1], with a value of 0.5 on the boundary.
+ *
+ * Uses an exact separable distance transform to find the nearest seed pixel
+ * of each pixel, and offsets the distance by where the edge crosses the seed
+ * to get the sub-pixel boundary, like edtaa3. Large images are processed in
+ * parallel. test/sdf checks the output against the edtaa3 reference.
  * @param img Pixel values, row-major order.
  * @param width Number of columns.
  * @param height Number of rows.
  * @param[out] vmax The underlying distance value corresponding to +1.0.
  * @return Allocated distance field, values ranging from 0 (innermost) to 1
- * (outermost). The reason for the inversion (relative to make_distance_mapd and
- * the "signed distance" concept) is so that these can be pasted together in a
- * texture atlas with a buffer of 0.0 values representing "completely outside".
+ * (outermost), or NULL if out of memory.
  */
 float *make_distance_mapbf( unsigned char *img, unsigned int width,
                             unsigned int height, double *vmax )
 {
-   unsigned int wh   = width * height;
-   double      *data = (double *)calloc( wh, sizeof( double ) );
-   float       *out  = (float *)malloc( wh * sizeof( float ) );
+   unsigned int  wh       = width * height;
+   double       *cov      = malloc( wh * sizeof( double ) );
+   double       *grid[2]  = { malloc( wh * sizeof( double ) ),
+                              malloc( wh * sizeof( double ) ) };
+   int          *seed[2]  = { malloc( wh * sizeof( int ) ),
+                              malloc( wh * sizeof( int ) ) };
+   float        *out      = malloc( wh * sizeof( float ) );
+   unsigned char img_min  = 255;
+   unsigned char img_max  = 0;
+   int           nthreads = 1;
+   double        scale, vm;
+   EDTStep       steps[]  = { EDT_COLUMNS, EDT_ROWS, EDT_REFINE };
 
-   // find minimum and maximum values
-   double img_min = DBL_MAX;
-   double img_max = DBL_MIN;
+   if ( ( cov == NULL ) || ( grid[0] == NULL ) || ( grid[1] == NULL ) ||
+        ( seed[0] == NULL ) || ( seed[1] == NULL ) || ( out == NULL ) ) {
+      free( out );
+      out = NULL;
+      goto out;
+   }
 
+   // find minimum and maximum values
    for ( unsigned int i = 0; i < wh; i++ ) {
-      double v = img[i];
-      if ( v > img_max )
-         img_max = v;
-      if ( v < img_min )
-         img_min = v;
+      if ( img[i] > img_max )
+         img_max = img[i];
+      if ( img[i] < img_min )
+         img_min = img[i];
+   }
+   scale = ( img_max > 0 ) ? 1. / img_max : 0.;
+
+   // Nothing to measure without an edge
+   if ( img_min == img_max ) {
+      for ( unsigned int i = 0; i < wh; i++ )
+         out[i] = 0.5;
+      *vmax = 0.;
+      goto out;
    }
 
-   // Map values from 0 - 255 to 0.0 - 1.0
-   for ( unsigned int i = 0; i < wh; i++ )
-      data[i] = ( img[i] - img_min ) / img_max;
+   // Outside is the distance to pixels with coverage, inside to pixels without
+   for ( unsigned int i = 0; i < wh; i++ ) {
+      cov[i]     = ( img[i] - img_min ) * scale;
+      grid[0][i] = ( cov[i] > 0. ) ? 0. : SDF_INF;
+      grid[1][i] = ( cov[i] < 1. ) ? 0. : SDF_INF;
+   }
 
-   data = make_distance_mapd( data, width, height, vmax );
+   // Columns, rows, then distances to the edge from outside and inside
+   if ( wh >= SDF_THREAD_PIXELS )
+      nthreads = 1 + sdf_start();
+   for ( unsigned int i = 0; i < sizeof( steps ) / sizeof( steps[0] ); i++ ) {
+      if ( edt_pass( grid, seed, cov, width, height, steps[i], nthreads ) !=
+           0 ) {
+         free( out );
+         out = NULL;
+         goto out;
+      }
+   }
 
-   // lower to float
-   for ( unsigned int i = 0; i < wh; i++ )
-      out[i] = (float)( 1 - data[i] );
+   // distmap = outside - inside; % Bipolar distance field
+   vm = 0.;
+   for ( unsigned int i = 0; i < wh; i++ ) {
+      double d = fmax( grid[0][i], 0. ) - fmax( grid[1][i], 0. );
+      grid[0][i]     = d;
+      if ( vm < fabs( d ) )
+         vm = fabs( d );
+   }
+   *vmax = vm;
 
-   free( data );
+   // Normalize and lower to float, inverted so that a buffer of 0.0 values
+   // in a texture atlas represents "completely outside"
+   if ( vm > 0. ) {
+      double s = 1. / ( 2. * vm );
+      for ( unsigned int i = 0; i < wh; i++ )
+         out[i] = (float)( 1. - ( grid[0][i] + vm ) * s );
+   } else {
+      for ( unsigned int i = 0; i < wh; i++ )
+         out[i] = 0.5;
+   }
 
+out:
+   free( cov );
+   free( grid[0] );
+   free( grid[1] );
+   free( seed[0] );
+   free( seed[1] );
    return out;
 }
@@ -163,6 +163,9 @@ static int effect_parse( EffectData *efx, const char *file )
       WARN( _( "Effect '%s' has unknown node '%s'" ), efx->name, node->name );
    } while ( xml_nextNode( node ) );
 
+   /* Precompile the stats. */
+   efx->stats_vec = ss_vecFromList( efx->stats );
+
    /* See if it is damaging. */
    efx->damaging = 0;
    if ( ( efx->stats != NULL ) && ( efx->flags & EFFECT_DEBUFF ) ) {
@@ -247,6 +250,7 @@ void effect_exit( void )
       free( e->overwrite );
       gl_freeTexture( e->icon );
       gl_freeTexture( e->img );
+      ss_vecFree( e->stats_vec );
       ss_free( e->stats );
    }
    array_free( effect_list );
@@ -559,7 +563,7 @@ void effect_compute( ShipStats *s, const Effect *efxlist )
    ss_statsInit( &stats );
    for ( int i = 0; i < array_size( efxlist ); i++ ) {
       const Effect *e = &efxlist[i];
-      ss_statsMergeFromListScale( &stats, e->data->stats, e->strength, 0 );
+      ss_statsMergeFromVec( &stats, e->data->stats_vec, e->strength, 0 );
    }
    ss_statsMerge( s, &stats, 1 );
 }
@@ -21,7 +21,8 @@ typedef struct EffectData_ {
                        important. */
    double        duration; /**< Max duration of the effect. */
    unsigned int  flags;    /**< Flags. */
-   ShipStatList *stats;    /**< Actual effect. */
+   ShipStatList *stats;     /**< Actual effect. */
+   ShipStatVec  *stats_vec; /**< Precompiled stats. */
    int           damaging; /**< Effect does damage. */
    /* Visuals. */
    glTexture *icon; /**< Effect icon texture. */
@@ -2044,6 +2044,7 @@ void equipment_updateShips( unsigned int wid, const char *str )
 
    /* Just in case, turn off outfits and reset stats. */
    effect_clear( &ship->effects );
+   pilot_calcStatsDirty( ship, PILOT_STATS_EFFECTS );
    pilot_outfitOffAll( ship );
    pilot_outfitLInitAll( ship );
    pilot_outfitLUpdate( player.p, 0. );
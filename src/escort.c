@@ -164,6 +164,7 @@ unsigned int escort_create( Pilot *p, const Ship *ship, const vec2 *pos,
             pe->intrinsic_stats, SS_TYPE_D_ACCEL_MOD, mod, 0, 1 );
       }
       /* Update stats. */
+      pilot_calcStatsDirty( pe, PILOT_STATS_BASE );
       pilot_calcStats( pe );
    }
 
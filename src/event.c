@@ -41,6 +41,7 @@
 #include "nxml_lua.h"
 #include "player.h"
 #include "rng.h"
+#include "spawn_index.h"
 
 #define XML_EVENT_ID "Events" /**< XML document identifier */
 #define XML_EVENT_TAG "event" /**< XML event tag. */
@@ -60,9 +61,10 @@ typedef struct EventData_ {
    /* For specific cases. */
    char       *spob;       /**< Spob name. */
    char       *system;     /**< System name. */
-   char       *chapter;    /**< Chapter name. */
-   int        *factions;   /**< Faction checks. */
-   pcre2_code *chapter_re; /**< Compiled regex chapter if applicable. */
+   char             *chapter;    /**< Chapter name. */
+   int              *factions;   /**< Faction checks. */
+   pcre2_code       *chapter_re; /**< Compiled regex chapter if applicable. */
+   pcre2_match_data *chapter_md; /**< Match data for chapter_re. */
 
    EventTrigger_t trigger;    /**< What triggers the event. */
    char          *cond;       /**< Conditional Lua code to execute. */
@@ -79,6 +81,16 @@ typedef struct EventData_ {
  */
 static EventData *event_data = NULL; /**< Allocated event data. */
 
+static SpawnIndex event_index[EVENT_TRIGGER_LOAD + 1]; /**< By trigger. */
+
+/*
+ * Chapter matching cache.
+ */
+static char *event_chapter = NULL; /**< Chapter the cache was built for. */
+static int  *event_chapterCache =
+   NULL; /**< Chapter results by event data index (array.h). */
+#define EVENT_CHAPTER_UNKNOWN -1 /**< Chapter hasn't been matched yet. */
+
 /*
  * Active events.
  */
@@ -93,6 +105,10 @@ static int          event_cmp( const void *a, const void *b );
 static int          event_parseFile( const char *file, EventData *temp );
 static int          event_parseXML( EventData *temp, const xmlNodePtr parent );
 static void         event_freeData( EventData *event );
+static int          event_matchChapter( int dataid );
+static void         events_indexBuild( void );
+static void         events_indexFree( void );
+static int         *events_indexGet( EventTrigger_t trigger );
 static int          event_create( int dataid, unsigned int *id );
 int                 events_saveActive( xmlTextWriterPtr writer );
 int                 events_loadActive( xmlNodePtr parent );
@@ -336,6 +352,117 @@ int event_alreadyRunning( int data )
    return 0;
 }
 
+/**
+ * @brief Checks to see if an event matches the player's current chapter.
+ *
+ * Results are cached per event and only recomputed when the chapter changes.
+ *
+ *    @param dataid Event data to check.
+ *    @return 1 if it matches, 0 otherwise.
+ */
+static int event_matchChapter( int dataid )
+{
+   int              rc;
+   const EventData *ed      = &event_data[dataid];
+   const char      *chapter = ( player.chapter != NULL ) ? player.chapter : "";
+
+   /* Invalidate the cache if the chapter changed. */
+   if ( ( event_chapter == NULL ) ||
+        ( strcmp( event_chapter, chapter ) != 0 ) ) {
+      free( event_chapter );
+      event_chapter = strdup( chapter );
+      if ( event_chapterCache == NULL )
+         event_chapterCache = array_create( int );
+      array_resize( &event_chapterCache, array_size( event_data ) );
+      for ( int i = 0; i < array_size( event_chapterCache ); i++ )
+         event_chapterCache[i] = EVENT_CHAPTER_UNKNOWN;
+   }
+
+   if ( event_chapterCache[dataid] != EVENT_CHAPTER_UNKNOWN )
+      return event_chapterCache[dataid];
+
+   rc = pcre2_match( ed->chapter_re, (PCRE2_SPTR)chapter, strlen( chapter ), 0,
+                     0, ed->chapter_md, NULL );
+   if ( ( rc < 0 ) && ( rc != PCRE2_ERROR_NOMATCH ) )
+      WARN( _( "Matching error %d" ), rc );
+   event_chapterCache[dataid] = ( rc > 0 );
+   return event_chapterCache[dataid];
+}
+
+/**
+ * @brief Frees the event trigger index.
+ */
+static void events_indexFree( void )
+{
+   for ( int i = 0; i <= EVENT_TRIGGER_LOAD; i++ )
+      spawnindex_free( &event_index[i] );
+   array_free( event_chapterCache );
+   event_chapterCache = NULL;
+   free( event_chapter );
+   event_chapter = NULL;
+}
+
+/**
+ * @brief Builds the event trigger index from the event data.
+ */
+static void events_indexBuild( void )
+{
+   events_indexFree();
+
+   for ( int i = 0; i <= EVENT_TRIGGER_LOAD; i++ )
+      spawnindex_init( &event_index[i] );
+
+   for ( int i = 0; i < array_size( event_data ); i++ ) {
+      const EventData *ed = &event_data[i];
+      const char      *spob;
+      if ( ( ed->trigger < 0 ) || ( ed->trigger > EVENT_TRIGGER_LOAD ) )
+         continue;
+      /* Spobs are only checked when landed. */
+      spob = ( ( ed->trigger == EVENT_TRIGGER_LAND ) ||
+               ( ed->trigger == EVENT_TRIGGER_LOAD ) )
+                ? ed->spob
+                : NULL;
+      spawnindex_add( &event_index[ed->trigger], spob, ed->system,
+                      ed->factions, i );
+   }
+
+   for ( int i = 0; i <= EVENT_TRIGGER_LOAD; i++ )
+      spawnindex_sort( &event_index[i] );
+}
+
+/**
+ * @brief Gets the events that could possibly be triggered right now.
+ *
+ * Candidates still have to go through all the checks in events_trigger(), but
+ * everything that is left out is guaranteed to fail them.
+ *
+ *    @param trigger Trigger to match.
+ *    @return Candidate event data indices in priority order (array.h). Has to
+ *            be freed by the caller.
+ */
+static int *events_indexGet( EventTrigger_t trigger )
+{
+   const char *spob = NULL;
+   int         fct  = -1;
+
+   if ( ( trigger < 0 ) || ( trigger > EVENT_TRIGGER_LOAD ) )
+      return array_create( int );
+
+   /* Get the location and faction to match. */
+   if ( trigger == EVENT_TRIGGER_ENTER )
+      fct = ( cur_system != NULL ) ? cur_system->faction : -1;
+   else if ( ( ( trigger == EVENT_TRIGGER_LAND ) ||
+               ( trigger == EVENT_TRIGGER_LOAD ) ) &&
+             ( land_spob != NULL ) ) {
+      spob = land_spob->name;
+      fct  = land_spob->presence.faction;
+   }
+
+   return spawnindex_get( &event_index[trigger], spob,
+                          ( cur_system != NULL ) ? cur_system->name : NULL, 1,
+                          fct );
+}
+
 /**
  * @brief Runs all the events matching a trigger.
  *
@@ -343,16 +470,14 @@ int event_alreadyRunning( int data )
  */
 void events_trigger( EventTrigger_t trigger )
 {
-   int created = 0;
-   for ( int i = 0; i < array_size( event_data ); i++ ) {
+   int  created = 0;
+   int *cand    = events_indexGet( trigger );
+   for ( int k = 0; k < array_size( cand ); k++ ) {
+      int        i  = cand[k];
       EventData *ed = &event_data[i];
 
       if ( naev_isQuit() )
-         return;
-
-      /* Make sure trigger matches. */
-      if ( ed->trigger != trigger )
-         continue;
+         break;
 
       /* Spob. */
       if ( ( trigger == EVENT_TRIGGER_LAND || trigger == EVENT_TRIGGER_LOAD ) &&
@@ -400,25 +525,8 @@ void events_trigger( EventTrigger_t trigger )
       }
 
       /* If chapter, must match chapter regex. */
-      if ( ed->chapter_re != NULL ) {
-         pcre2_match_data *match_data =
-            pcre2_match_data_create_from_pattern( ed->chapter_re, NULL );
-         int rc =
-            pcre2_match( ed->chapter_re, (PCRE2_SPTR)player.chapter,
-                         strlen( player.chapter ), 0, 0, match_data, NULL );
-         pcre2_match_data_free( match_data );
-         if ( rc < 0 ) {
-            switch ( rc ) {
-            case PCRE2_ERROR_NOMATCH:
-               continue;
-            default:
-               WARN( _( "Matching error %d" ), rc );
-               break;
-            }
-            continue;
-         } else if ( rc == 0 )
-            continue;
-      }
+      if ( ( ed->chapter_re != NULL ) && !event_matchChapter( i ) )
+         continue;
 
       /* Test conditional. */
       if ( ed->cond != NULL ) {
@@ -434,6 +542,7 @@ void events_trigger( EventTrigger_t trigger )
       event_create( i, NULL );
       created++;
    }
+   array_free( cand );
 
    /* Run claims if necessary. */
    if ( created )
@@ -558,7 +667,9 @@ static int event_parseXML( EventData *temp, const xmlNodePtr parent )
          WARN( _( "Mission '%s' chapter PCRE2 compilation failed at offset %d: "
                   "%s" ),
                temp->name, (int)erroroffset, buffer );
-      }
+      } else
+         temp->chapter_md =
+            pcre2_match_data_create_from_pattern( temp->chapter_re, NULL );
    }
 
 #define MELEMENT( o, s )                                                       \
@@ -620,6 +731,9 @@ int events_load( void )
    qsort( event_data, array_size( event_data ), sizeof( EventData ),
           event_cmp );
 
+   /* Index by trigger. */
+   events_indexBuild();
+
 #if DEBUGGING
    if ( conf.devmode ) {
       time = SDL_GetTicks() - time;
@@ -735,6 +849,7 @@ static void event_freeData( EventData *event )
    free( event->spob );
    free( event->system );
    free( event->chapter );
+   pcre2_match_data_free( event->chapter_md );
    pcre2_code_free( event->chapter_re );
 
    array_free( event->factions );
@@ -776,6 +891,9 @@ void events_exit( void )
 {
    events_cleanup();
 
+   /* Free the index. */
+   events_indexFree();
+
    /* Free data. */
    for ( int i = 0; i < array_size( event_data ); i++ )
       event_freeData( &event_data[i] );
@@ -1004,6 +1122,9 @@ int event_reload( const char *name )
       event_freeData( &save );
    else
       *temp = save;
+
+   /* Trigger or requirements may have changed. */
+   events_indexBuild();
    return res;
 }
 
@@ -1317,6 +1317,11 @@ static int font_makeChar( glFontStash *stsh, font_char_t *c, uint32_t ch )
          /* Compute signed fdistance field with buffered glyph. */
          c->dataf = make_distance_mapbf( buffer, rw, rh, &vmax );
          free( buffer );
+         if ( c->dataf == NULL ) {
+            WARN( _( "Unable to compute distance field of character '%#x'!" ),
+                  ch );
+            return -1;
+         }
       }
       c->w        = rw;
       c->h        = rh;
@@ -315,6 +315,10 @@ static mat4    light_mat_def[MAX_LIGHTS]; /**< Shadow matrices. */
 static mat4    light_mat_alt[MAX_LIGHTS];
 static mat4   *light_mat = light_mat_def;
 
+#define LIGHT_GEN_COS 0.996 /**< Lights turning over ~5 degrees bump gen. */
+static unsigned int light_gen = 1;            /**< Lighting generation. */
+static Light        light_gen_ref[MAX_LIGHTS]; /**< Lights at last gen bump. */
+
 /**
  * @brief Shader to use witha material.
  */
@@ -1986,6 +1990,7 @@ int gltf_init( void )
    L_default = L_default_const;
    for ( int i = 0; i < L_default.nlights; i++ )
       shadow_matrix( &light_mat_def[i], &L_default.lights[i] );
+   memcpy( light_gen_ref, L_default.lights, sizeof( light_gen_ref ) );
 
    /* Set global options. */
    use_normal_mapping    = !conf.low_memory;
@@ -2240,6 +2245,32 @@ void gltf_exit( void )
 void gltf_lightReset( void )
 {
    L_default = L_default_const;
+   memcpy( light_gen_ref, L_default.lights, sizeof( light_gen_ref ) );
+   light_gen++;
+}
+
+/**
+ * @brief Checks to see if a light differs noticeably from a reference.
+ *
+ * Positions are compared by direction and distance with some tolerance, since
+ * background lights follow the camera and move slightly every frame.
+ */
+static int gltf_lightDiffers( const Light *a, const Light *b )
+{
+   double la, lb;
+
+   if ( ( a->sun != b->sun ) ||
+        ( fabs( a->intensity - b->intensity ) > DOUBLE_TOL ) ||
+        ( vec3_dist( &a->colour, &b->colour ) > DOUBLE_TOL ) )
+      return 1;
+
+   la = vec3_length( &a->pos );
+   lb = vec3_length( &b->pos );
+   if ( ( la <= DOUBLE_TOL ) || ( lb <= DOUBLE_TOL ) )
+      return ( ( la <= DOUBLE_TOL ) != ( lb <= DOUBLE_TOL ) );
+   if ( fabs( la - lb ) > 0.1 * MAX( la, lb ) )
+      return 1;
+   return ( vec3_dot( &a->pos, &b->pos ) < LIGHT_GEN_COS * la * lb );
 }
 
 /**
@@ -2256,6 +2287,11 @@ int gltf_lightSet( int idx, const Light *L )
       WARN( _( "Trying to set more lights than MAX_LIGHTS allows!" ) );
       return -1;
    }
+   if ( ( n >= L_default.nlights ) ||
+        gltf_lightDiffers( L, &light_gen_ref[n] ) ) {
+      light_gen_ref[n] = *L;
+      light_gen++;
+   }
    L_default.nlights   = MAX( L_default.nlights, n + 1 );
    L_default.lights[n] = *L;
    shadow_matrix( &light_mat_def[n], &L_default.lights[n] );
@@ -2268,6 +2304,10 @@ int gltf_lightSet( int idx, const Light *L )
 void gltf_lightAmbient( double r, double g, double b )
 {
    const double factor = 1.0 / M_PI;
+   if ( ( fabs( L_default.ambient_r - r * factor ) > DOUBLE_TOL ) ||
+        ( fabs( L_default.ambient_g - g * factor ) > DOUBLE_TOL ) ||
+        ( fabs( L_default.ambient_b - b * factor ) > DOUBLE_TOL ) )
+      light_gen++;
    L_default.ambient_r = r * factor;
    L_default.ambient_g = g * factor;
    L_default.ambient_b = b * factor;
@@ -2288,6 +2328,8 @@ void gltf_lightAmbientGet( double *r, double *g, double *b )
  */
 void gltf_lightIntensity( double strength )
 {
+   if ( fabs( L_default.intensity - strength ) > DOUBLE_TOL )
+      light_gen++;
    L_default.intensity = strength;
 }
 
@@ -2299,6 +2341,17 @@ double gltf_lightIntensityGet( void )
    return L_default.intensity;
 }
 
+/**
+ * @brief Gets the generation of the default lighting.
+ *
+ * The generation changes whenever the default lighting changes noticeably, so
+ * anything rendered with it can be cached until then.
+ */
+unsigned int gltf_lightGeneration( void )
+{
+   return light_gen;
+}
+
 /**
  * @brief Transforms the lighting positions based on a trasnform matrix.
  */
@@ -61,14 +61,15 @@ void gltf_renderScene( GLuint fb, GltfObject *obj, int scene, const mat4 *H,
                        GLfloat time, double size, const Lighting *L );
 
 /* Lighting. */
-void   gltf_lightReset( void );
-int    gltf_lightSet( int idx, const Light *L );
-void   gltf_lightAmbient( double r, double g, double b );
-void   gltf_lightAmbientGet( double *r, double *g, double *b );
-void   gltf_lightIntensity( double strength );
-double gltf_lightIntensityGet( void );
-void   gltf_lightTransform( Lighting *L, const mat4 *H );
-int    gltf_numLights( void );
+void         gltf_lightReset( void );
+int          gltf_lightSet( int idx, const Light *L );
+void         gltf_lightAmbient( double r, double g, double b );
+void         gltf_lightAmbientGet( double *r, double *g, double *b );
+void         gltf_lightIntensity( double strength );
+double       gltf_lightIntensityGet( void );
+unsigned int gltf_lightGeneration( void );
+void         gltf_lightTransform( Lighting *L, const mat4 *H );
+int          gltf_numLights( void );
 
 int          gltf_sceneBody( const GltfObject *obj );
 int          gltf_sceneEngine( const GltfObject *obj );
@@ -96,6 +96,29 @@ typedef struct Radar_ {
    10. /**< Steps used to increase/decrease resolution. */
 static Radar gui_radar;
 
+/**
+ * @brief Drawing layers of the radar markers, lower ones are drawn first.
+ */
+typedef enum RadarLayer_ {
+   RADAR_LAYER_HILIGHT, /**< Highlights around markers. */
+   RADAR_LAYER_UNDER,   /**< Blinks under markers. */
+   RADAR_LAYER_MARKER,  /**< The markers themselves. */
+   RADAR_LAYER_OVER,    /**< Blinks and icons over markers. */
+} RadarLayer;
+
+/**
+ * @brief A radar marker queued while batching.
+ */
+typedef struct RadarMarker_ {
+   const SimpleShader *shd;                          /**< Shader. */
+   RadarLayer          layer;                        /**< Layer. */
+   int                 idx;                          /**< Queue order. */
+   GLfloat             data[GL_SHADER_BATCH_FLOATS]; /**< Instance data. */
+} RadarMarker;
+static int          gui_radarBatch   = 0;    /**< Whether markers are queued. */
+static RadarMarker *gui_radarMarkers = NULL; /**< Queued radar markers. */
+static GLfloat     *gui_radarData    = NULL; /**< Instance upload buffer. */
+
 /* messages */
 static const int mesg_max = 128; /**< Maximum messages onscreen */
 static int       mesg_pointer =
@@ -164,7 +187,13 @@ static const glColour *gui_getSpobColour( int i );
 static void gui_renderRadarOutOfRange( RadarShape sh, int w, int h, int cx,
                                        int cy, const glColour *col );
 static void gui_blink( double cx, double cy, double vr, const glColour *col,
-                       double blinkInterval, double blinkVar );
+                       double blinkInterval, double blinkVar,
+                       RadarLayer layer );
+static void gui_radarMarker( const SimpleShader *shd, RadarLayer layer,
+                             double x, double y, double w, double h,
+                             double angle, const glColour *col );
+static int  gui_radarMarkerCmp( const void *p1, const void *p2 );
+static void gui_radarFlush( void );
 static const glColour *gui_getPilotColour( const Pilot *p );
 /* Lua GUI. */
 static int gui_doFunc( int func_ref, const char *func_name );
@@ -776,6 +805,9 @@ void gui_radarRender( double x, double y )
    } else if ( radar->shape == RADAR_CIRCLE )
       mat4_translate_xy( &gl_view_matrix, x, y );
 
+   /* Markers are queued and drawn in a few batches per kind of object. */
+   gui_radarBatch = 1;
+
    /*
     * spobs
     */
@@ -786,6 +818,7 @@ void gui_radarRender( double x, double y )
    if ( player.p->nav_spob > -1 )
       gui_renderSpob( player.p->nav_spob, radar->shape, radar->w, radar->h,
                       radar->res, 1., 0 );
+   gui_radarFlush();
 
    /*
     * Jump points.
@@ -799,6 +832,7 @@ void gui_radarRender( double x, double y )
    if ( player.p->nav_hyperspace > -1 )
       gui_renderJumpPoint( player.p->nav_hyperspace, radar->shape, radar->w,
                            radar->h, radar->res, 1., 0 );
+   gui_radarFlush();
 
    /*
     * weapons
@@ -819,6 +853,7 @@ void gui_radarRender( double x, double y )
    if ( f != 0 )
       gui_renderPilot( pilot_stack[f], radar->shape, radar->w, radar->h,
                        radar->res, 0 );
+   gui_radarFlush();
 
    /* Render the asteroids */
    const double render_limit =
@@ -839,6 +874,8 @@ void gui_radarRender( double x, double y )
                              0 );
       }
    }
+   gui_radarFlush();
+   gui_radarBatch = 0;
 
    /* Render the viewport frame */
    gui_renderViewportFrame( radar->res, render_limit, 0 );
@@ -1072,40 +1109,33 @@ void gui_renderPilot( const Pilot *p, RadarShape shape, double w, double h,
    if ( hilight ) {
       glColour highlighted = ( scanning ) ? cRadar_scanning : cRadar_hilight;
       highlighted.a        = 0.3;
-      glUseProgram( shaders.hilight.program );
-      glUniform1f( shaders.hilight.dt, animation_dt );
-      gl_renderShader( x, y, scale * 2.0, scale * 2.0, 0., &shaders.hilight,
-                       &highlighted, 1 );
-      hilight = 1;
+      gui_radarMarker( &shaders.hilight, RADAR_LAYER_HILIGHT, x, y,
+                       scale * 2.0, scale * 2.0, 0., &highlighted );
    }
 
-   glUseProgram( shaders.pilotmarker.program );
-   gl_renderShader( x, y, scale, scale, p->solid.dir, &shaders.pilotmarker, col,
-                    1 );
+   gui_radarMarker( &shaders.pilotmarker, RADAR_LAYER_MARKER, x, y, scale,
+                    scale, p->solid.dir, col );
 
    /* Draw selection if targeted. */
    if ( p->id == player.p->target )
       gui_blink( x, y, MAX( scale * 2., 10.0 ), &cRadar_hilight,
-                 RADAR_BLINK_PILOT, blink_pilot );
+                 RADAR_BLINK_PILOT, blink_pilot, RADAR_LAYER_OVER );
 
    /* Draw name. */
    if ( overlay && hilight ) {
       /* TODO try to minimize overlap here. */
       gl_printMarkerRaw( &gl_smallFont, x + scale + 5., y - gl_smallFont.h / 2.,
                          col, p->name );
-      if ( scanning ) {
-         glUseProgram( shaders.pilotscanning.program );
-         gl_renderShader( x + scale + 3., y + scale + gl_smallFont.h / 2. + 3.,
-                          5., 5., 1.5 * animation_dt, &shaders.pilotscanning,
-                          col, 1 );
-      }
+      if ( scanning )
+         gui_radarMarker( &shaders.pilotscanning, RADAR_LAYER_OVER,
+                          x + scale + 3., y + scale + gl_smallFont.h / 2. + 3.,
+                          5., 5., 1.5 * animation_dt, col );
    } else {
       /* Draw scanning icon. */
-      if ( scanning ) {
-         glUseProgram( shaders.pilotscanning.program );
-         gl_renderShader( x + scale + 3., y + scale + 3., 5., 5.,
-                          1.5 * animation_dt, &shaders.pilotscanning, col, 1 );
-      }
+      if ( scanning )
+         gui_radarMarker( &shaders.pilotscanning, RADAR_LAYER_OVER,
+                          x + scale + 3., y + scale + 3., 5., 5.,
+                          1.5 * animation_dt, col );
    }
 }
 
@@ -1182,12 +1212,12 @@ void gui_renderAsteroid( const Asteroid *a, double w, double h, double res,
       col = &cGrey70;
 
    // gl_renderRect( px, py, MIN( 2*sx, w-px ), MIN( 2*sy, h-py ), col );
-   glUseProgram( shaders.asteroidmarker.program );
-   gl_renderShader( px, py, r, r, 0., &shaders.asteroidmarker, col, 1 );
+   gui_radarMarker( &shaders.asteroidmarker, RADAR_LAYER_MARKER, px, py, r, r,
+                    0., col );
 
    if ( targeted )
       gui_blink( px, py, MAX( 7., 2.0 * r ), col, RADAR_BLINK_PILOT,
-                 blink_pilot );
+                 blink_pilot, RADAR_LAYER_OVER );
 }
 
 /**
@@ -1298,12 +1328,95 @@ void gui_forceBlink( void )
  * @brief Renders the spob blink around a position on the minimap.
  */
 static void gui_blink( double cx, double cy, double vr, const glColour *col,
-                       double blinkInterval, double blinkVar )
+                       double blinkInterval, double blinkVar,
+                       RadarLayer layer )
 {
    if ( blinkVar > blinkInterval / 2. )
       return;
-   glUseProgram( shaders.blinkmarker.program );
-   gl_renderShader( cx, cy, vr, vr, 0., &shaders.blinkmarker, col, 1 );
+   gui_radarMarker( &shaders.blinkmarker, layer, cx, cy, vr, vr, 0., col );
+}
+
+/**
+ * @brief Draws a centered radar marker, or queues it when batching.
+ *
+ *    @param shd Shader of the marker.
+ *    @param layer Layer to draw the marker in when batching.
+ *    @param x X position of the center.
+ *    @param y Y position of the center.
+ *    @param w Width.
+ *    @param h Height.
+ *    @param angle Rotation of the marker.
+ *    @param col Colour of the marker.
+ */
+static void gui_radarMarker( const SimpleShader *shd, RadarLayer layer,
+                             double x, double y, double w, double h,
+                             double angle, const glColour *col )
+{
+   RadarMarker *m;
+
+   if ( !gui_radarBatch ) {
+      glUseProgram( shd->program );
+      glUniform1f( shd->dt, animation_dt );
+      gl_renderShader( x, y, w, h, angle, shd, col, 1 );
+      return;
+   }
+
+   m          = &array_grow( &gui_radarMarkers );
+   m->shd     = shd;
+   m->layer   = layer;
+   m->idx     = array_size( gui_radarMarkers );
+   m->data[0] = x;
+   m->data[1] = y;
+   m->data[2] = angle;
+   m->data[3] = w;
+   m->data[4] = h;
+   m->data[5] = col->r;
+   m->data[6] = col->g;
+   m->data[7] = col->b;
+   m->data[8] = col->a;
+}
+
+/**
+ * @brief Sorts radar markers by layer and shader, keeping the queued order.
+ */
+static int gui_radarMarkerCmp( const void *p1, const void *p2 )
+{
+   const RadarMarker *m1 = p1;
+   const RadarMarker *m2 = p2;
+   if ( m1->layer != m2->layer )
+      return m1->layer - m2->layer;
+   if ( m1->shd->program != m2->shd->program )
+      return ( m1->shd->program < m2->shd->program ) ? -1 : +1;
+   return m1->idx - m2->idx;
+}
+
+/**
+ * @brief Draws the queued radar markers, one call per layer and shader.
+ */
+static void gui_radarFlush( void )
+{
+   int n = array_size( gui_radarMarkers );
+   if ( n <= 0 )
+      return;
+
+   qsort( gui_radarMarkers, n, sizeof( RadarMarker ), gui_radarMarkerCmp );
+   array_resize( &gui_radarData, n * GL_SHADER_BATCH_FLOATS );
+   for ( int i = 0; i < n; i++ )
+      memcpy( &gui_radarData[i * GL_SHADER_BATCH_FLOATS],
+              gui_radarMarkers[i].data, sizeof( gui_radarMarkers[i].data ) );
+   for ( int i = 0; i < n; ) {
+      const RadarMarker *m = &gui_radarMarkers[i];
+      int                j = i + 1;
+      while ( ( j < n ) && ( gui_radarMarkers[j].layer == m->layer ) &&
+              ( gui_radarMarkers[j].shd == m->shd ) )
+         j++;
+      gl_renderShaderBatch( m->shd, &gui_radarData[i * GL_SHADER_BATCH_FLOATS],
+                            j - i, animation_dt );
+      i = j;
+   }
+
+   array_erase( &gui_radarMarkers, array_begin( gui_radarMarkers ),
+                array_end( gui_radarMarkers ) );
 }
 
 /**
@@ -1412,10 +1525,8 @@ void gui_renderSpob( int ind, RadarShape shape, double w, double h, double res,
    if ( spob_isKnown( spob ) && spob_isFlag( spob, SPOB_MARKED ) ) {
       glColour highlighted = cRadar_hilight;
       highlighted.a        = 0.3;
-      glUseProgram( shaders.hilight.program );
-      glUniform1f( shaders.hilight.dt, animation_dt );
-      gl_renderShader( cx, cy, vr * 3.0, vr * 3.0, 0., &shaders.hilight,
-                       &highlighted, 1 );
+      gui_radarMarker( &shaders.hilight, RADAR_LAYER_HILIGHT, cx, cy, vr * 3.0,
+                       vr * 3.0, 0., &highlighted );
    }
 
    /* Get the colour. */
@@ -1424,7 +1535,8 @@ void gui_renderSpob( int ind, RadarShape shape, double w, double h, double res,
 
    /* Do the blink. */
    if ( ind == player.p->nav_spob )
-      gui_blink( cx, cy, vr * 2., &col, RADAR_BLINK_SPOB, blink_spob );
+      gui_blink( cx, cy, vr * 2., &col, RADAR_BLINK_SPOB, blink_spob,
+                 RADAR_LAYER_UNDER );
 
    if ( spob->marker != NULL )
       shd = spob->marker;
@@ -1436,8 +1548,7 @@ void gui_renderSpob( int ind, RadarShape shape, double w, double h, double res,
    } else
       shd = &shaders.spobmarker_empty;
 
-   glUseProgram( shd->program );
-   gl_renderShader( cx, cy, vr, vr, 0., shd, &col, 1 );
+   gui_radarMarker( shd, RADAR_LAYER_MARKER, cx, cy, vr, vr, 0., &col );
 
    if ( overlay ) {
       char buf[STRMAX_SHORT];
@@ -1516,10 +1627,8 @@ void gui_renderJumpPoint( int ind, RadarShape shape, double w, double h,
    if ( sys_isMarked( s ) ) {
       glColour highlighted = cRadar_hilight;
       highlighted.a        = 0.3;
-      glUseProgram( shaders.hilight.program );
-      glUniform1f( shaders.hilight.dt, animation_dt );
-      gl_renderShader( cx, cy, vr * 3.0, vr * 3.0, 0., &shaders.hilight,
-                       &highlighted, 1 );
+      gui_radarMarker( &shaders.hilight, RADAR_LAYER_HILIGHT, cx, cy, vr * 3.0,
+                       vr * 3.0, 0., &highlighted );
    }
 
    if ( ind == player.p->nav_hyperspace )
@@ -1530,13 +1639,13 @@ void gui_renderJumpPoint( int ind, RadarShape shape, double w, double h,
       col = cGreen;
    col.a *= alpha;
 
-   glUseProgram( shaders.jumpmarker.program );
-   gl_renderShader( cx, cy, vr * 1.5, vr * 1.5, M_PI - jp->angle,
-                    &shaders.jumpmarker, &col, 1 );
+   gui_radarMarker( &shaders.jumpmarker, RADAR_LAYER_MARKER, cx, cy, vr * 1.5,
+                    vr * 1.5, M_PI - jp->angle, &col );
 
    /* Blink ontop. */
    if ( ind == player.p->nav_hyperspace )
-      gui_blink( cx, cy, vr * 3., &col, RADAR_BLINK_SPOB, blink_spob );
+      gui_blink( cx, cy, vr * 3., &col, RADAR_BLINK_SPOB, blink_spob,
+                 RADAR_LAYER_OVER );
 
    /* Render name. */
    if ( overlay ) {
@@ -1598,6 +1707,8 @@ int gui_init( void )
 
    /* Quadtrees. */
    il_create( &gui_qtquery, 1 );
+   gui_radarMarkers = array_create( RadarMarker );
+   gui_radarData    = array_create( GLfloat );
 
    return 0;
 }
@@ -1958,6 +2069,10 @@ void gui_free( void )
    gui_target_pilot = NULL;
 
    il_destroy( &gui_qtquery );
+   array_free( gui_radarMarkers );
+   gui_radarMarkers = NULL;
+   array_free( gui_radarData );
+   gui_radarData = NULL;
 
    omsg_cleanup();
 }
@@ -43,6 +43,7 @@
 #include "nlua_ship.h"
 #include "player.h"
 #include "space.h"
+#include "strmap.h"
 
 /**
  * @brief Hook queue to delay execution.
@@ -73,10 +74,13 @@ typedef enum HookType_e {
  * @brief Internal representation of a hook.
  */
 typedef struct Hook_ {
-   struct Hook_ *next; /**< Linked list. */
+   struct Hook_ *next;       /**< Linked list. */
+   struct Hook_ *stack_next; /**< Next hook in the same stack. */
+   struct Hook_ *stack_prev; /**< Previous hook in the same stack. */
 
    unsigned int id;      /**< unique id */
-   char        *stack;   /**< stack it's a part of */
+   const char  *stack;   /**< stack it's a part of (interned) */
+   int          stackid; /**< Index of the stack in hook_stacks. */
    int          created; /**< Hook has just been created. */
    int delete;           /**< indicates it should be deleted when possible */
    int ran_once; /**< Indicates if the hook already ran, useful when iterating.
@@ -109,6 +113,14 @@ typedef struct Hook_ {
    } u; /**< Type specific data. */
 } Hook;
 
+/**
+ * @brief All the hooks belonging to a stack.
+ */
+typedef struct HookStack_ {
+   char *name;  /**< Name of the stack. */
+   Hook *first; /**< Hooks of the stack, in the same order as hook_list. */
+} HookStack;
+
 /*
  * the stack
  */
@@ -117,6 +129,15 @@ static Hook        *hook_list         = NULL; /**< Stack of hooks. */
 static int          hook_runningstack = 0;    /**< Check if stack is running. */
 static int hook_loadingstack = 0; /**< Check if the hooks are being loaded. */
 
+/*
+ * Indices.
+ */
+static HookStack   *hook_stacks    = NULL; /**< Interned stacks (array.h). */
+static StrMap       hook_stackMap;         /**< Stack name to index. */
+static Hook       **hook_idMap     = NULL; /**< Hash map of hooks by ID. */
+static unsigned int hook_idMapSize = 0;    /**< Size of hook_idMap. */
+static unsigned int hook_idMapUsed = 0;    /**< Hooks in hook_idMap. */
+
 /*
  * prototypes
  */
@@ -127,6 +148,10 @@ static void hooks_updateDateExecute( ntime_t change );
 static void         hook_rmRaw( Hook *h );
 static void         hooks_purgeList( void );
 static Hook        *hook_get( unsigned int id );
+static void         hook_mapInsert( Hook *h );
+static void         hook_mapRemove( const Hook *h );
+static int          hook_stackID( const char *stack, int create );
+static void         hook_stackRemove( Hook *h );
 static unsigned int hook_genID( void );
 static Hook        *hook_new( HookType_t type, const char *stack );
 static int          hook_parseParam( const HookParam *param );
@@ -142,6 +167,14 @@ int hook_load( xmlNodePtr parent );
 /* Misc. */
 static Mission *hook_getMission( Hook *hook );
 
+/**
+ * @brief Hashes a hook ID.
+ */
+static inline unsigned int hook_hashID( unsigned int id )
+{
+   return id * 2654435761u; /* Knuth's multiplicative hash. */
+}
+
 /**
  * Adds a hook to the queue.
  */
@@ -482,9 +515,8 @@ static unsigned int hook_genID( void )
       return id;
 
    /* Must check ids for collisions. */
-   for ( Hook *h = hook_list; h != NULL; h = h->next )
-      if ( id == h->id )      /* Check for collision. */
-         return hook_genID(); /* recursively try again */
+   if ( hook_get( id ) != NULL )
+      return hook_genID(); /* recursively try again */
 
    return id;
 }
@@ -511,9 +543,18 @@ static Hook *hook_new( HookType_t type, const char *stack )
    /* Fill out generic details. */
    new_hook->type    = type;
    new_hook->id      = hook_genID();
-   new_hook->stack   = strdup( stack );
+   new_hook->stackid = hook_stackID( stack, 1 );
+   new_hook->stack   = hook_stacks[new_hook->stackid].name;
    new_hook->created = 1;
 
+   /* Index it. */
+   HookStack *hs = &hook_stacks[new_hook->stackid];
+   if ( hs->first != NULL )
+      hs->first->stack_prev = new_hook;
+   new_hook->stack_next = hs->first;
+   hs->first            = new_hook;
+   hook_mapInsert( new_hook );
+
    /** @TODO fix this hack. */
    if ( strcmp( stack, "safe" ) == 0 )
       new_hook->once = 1;
@@ -671,6 +712,8 @@ static void hooks_purgeList( void )
 
          /* Free. */
          h->next = NULL;
+         hook_stackRemove( h );
+         hook_mapRemove( h );
          hook_free( h );
 
          /* Last. */
@@ -922,23 +965,28 @@ int hook_hasEventParent( unsigned int parent )
 
 static int hooks_executeParam( const char *stack, const HookParam *param )
 {
-   int run;
+   int run, id;
 
    /* Don't update if player is dead. */
    if ( ( player.p == NULL ) || player_isFlag( PLAYER_DESTROYED ) )
       return 0;
 
+   /* Stacks that never had hooks have nothing to run. */
+   run = 0;
+   id  = hook_stackID( stack, 0 );
+   if ( id < 0 )
+      goto cleanup;
+
    /* Reset the current stack's ran and creation flags. */
-   for ( Hook *h = hook_list; h != NULL; h = h->next )
-      if ( strcmp( stack, h->stack ) == 0 ) {
-         h->ran_once = 0;
-         h->created  = 0;
-      }
+   for ( Hook *h = hook_stacks[id].first; h != NULL; h = h->stack_next ) {
+      h->ran_once = 0;
+      h->created  = 0;
+   }
 
-   run = 0;
    hook_runningstack++; /* running hooks */
    for ( int j = 1; j >= 0; j-- ) {
-      for ( Hook *h = hook_list; h != NULL; h = h->next ) {
+      /* Hooks are not unlinked while running, only marked for deletion. */
+      for ( Hook *h = hook_stacks[id].first; h != NULL; h = h->stack_next ) {
          /* Should be deleted. */
          if ( h->delete )
             continue;
@@ -948,9 +996,6 @@ static int hooks_executeParam( const char *stack, const HookParam *param )
          /* Don't update newly created hooks. */
          if ( h->created != 0 )
             continue;
-         /* Doesn't match stack. */
-         if ( strcmp( stack, h->stack ) != 0 )
-            continue;
 
          /* Run hook. */
          hook_run( h, param, j );
@@ -965,6 +1010,7 @@ static int hooks_executeParam( const char *stack, const HookParam *param )
    }
    hook_runningstack--; /* not running hooks anymore */
 
+cleanup:
    /* Free reference parameters. */
    if ( param != NULL ) {
       int n = 0;
@@ -1059,13 +1105,126 @@ int hooks_run( const char *stack )
  */
 static Hook *hook_get( unsigned int id )
 {
-   for ( Hook *h = hook_list; h != NULL; h = h->next )
-      if ( h->id == id )
-         return h;
+   unsigned int mask;
+
+   if ( hook_idMapSize == 0 )
+      return NULL;
+
+   mask = hook_idMapSize - 1;
+   for ( unsigned int i = hook_hashID( id ) & mask; hook_idMap[i] != NULL;
+         i = ( i + 1 ) & mask )
+      if ( hook_idMap[i]->id == id )
+         return hook_idMap[i];
 
    return NULL;
 }
 
+/**
+ * @brief Adds a hook to the ID hash map, replacing any hook with the same ID.
+ */
+static void hook_mapInsert( Hook *h )
+{
+   unsigned int mask, i;
+
+   /* Grow to keep it at most half full. */
+   if ( 2 * ( hook_idMapUsed + 1 ) > hook_idMapSize ) {
+      Hook       **old     = hook_idMap;
+      unsigned int oldsize = hook_idMapSize;
+      hook_idMapSize       = MAX( 64, 2 * oldsize );
+      hook_idMap           = calloc( hook_idMapSize, sizeof( Hook * ) );
+      hook_idMapUsed       = 0;
+      for ( unsigned int j = 0; j < oldsize; j++ )
+         if ( old[j] != NULL )
+            hook_mapInsert( old[j] );
+      free( old );
+   }
+
+   mask = hook_idMapSize - 1;
+   for ( i = hook_hashID( h->id ) & mask; hook_idMap[i] != NULL;
+         i = ( i + 1 ) & mask ) {
+      if ( hook_idMap[i]->id == h->id ) {
+         hook_idMap[i] = h;
+         return;
+      }
+   }
+   hook_idMap[i] = h;
+   hook_idMapUsed++;
+}
+
+/**
+ * @brief Removes a hook from the ID hash map.
+ */
+static void hook_mapRemove( const Hook *h )
+{
+   unsigned int mask, i, j;
+
+   if ( hook_idMapSize == 0 )
+      return;
+
+   mask = hook_idMapSize - 1;
+   for ( i = hook_hashID( h->id ) & mask; hook_idMap[i] != h;
+         i = ( i + 1 ) & mask )
+      if ( hook_idMap[i] == NULL )
+         return; /* Was replaced by a hook with the same ID. */
+
+   /* Shift back the hooks after it so they can still be found. */
+   j = i;
+   for ( ;; ) {
+      unsigned int k;
+      j = ( j + 1 ) & mask;
+      if ( hook_idMap[j] == NULL )
+         break;
+      k = hook_hashID( hook_idMap[j]->id ) & mask;
+      /* Can't move it if its home is cyclically in (i,j]. */
+      if ( ( i <= j ) ? ( ( i < k ) && ( k <= j ) )
+                      : ( ( i < k ) || ( k <= j ) ) )
+         continue;
+      hook_idMap[i] = hook_idMap[j];
+      i             = j;
+   }
+   hook_idMap[i] = NULL;
+   hook_idMapUsed--;
+}
+
+/**
+ * @brief Gets the index of a stack in hook_stacks, interning it if necessary.
+ *
+ *    @param stack Name of the stack.
+ *    @param create Whether to create the stack if it doesn't exist.
+ *    @return Index of the stack or -1 if not found.
+ */
+static int hook_stackID( const char *stack, int create )
+{
+   const int *id = strmap_get( &hook_stackMap, stack );
+   if ( id != NULL )
+      return *id;
+   if ( !create )
+      return -1;
+
+   /* Create the new stack. */
+   if ( hook_stacks == NULL )
+      hook_stacks = array_create( HookStack );
+   HookStack *hs = &array_grow( &hook_stacks );
+   hs->name      = strdup( stack );
+   hs->first     = NULL;
+   return *strmap_set( &hook_stackMap, stack, array_size( hook_stacks ) - 1 );
+}
+
+/**
+ * @brief Unlinks a hook from its stack.
+ */
+static void hook_stackRemove( Hook *h )
+{
+   if ( h->stack_prev != NULL )
+      h->stack_prev->stack_next = h->stack_next;
+   else
+      hook_stacks[h->stackid].first = h->stack_next;
+   if ( h->stack_next != NULL )
+      h->stack_next->stack_prev = h->stack_prev;
+   h->stack_next = NULL;
+   h->stack_prev = NULL;
+}
+
 /**
  * @brief Gets the lua env for a hook.
  */
@@ -1140,9 +1299,6 @@ static void hook_free( Hook *h )
    /* Remove from all the pilots. */
    pilots_rmHook( h->id );
 
-   /* Generic freeing. */
-   free( h->stack );
-
    /* Free type specific. */
    switch ( h->type ) {
    case HOOK_TYPE_MISN:
@@ -1178,6 +1334,17 @@ void hook_cleanup( void )
    }
    /* safe defaults just in case */
    hook_list = NULL;
+
+   /* Clear the indices. */
+   for ( int i = 0; i < array_size( hook_stacks ); i++ )
+      free( hook_stacks[i].name );
+   array_free( hook_stacks );
+   hook_stacks = NULL;
+   strmap_free( &hook_stackMap );
+   free( hook_idMap );
+   hook_idMap     = NULL;
+   hook_idMapSize = 0;
+   hook_idMapUsed = 0;
 }
 
 /**
@@ -1425,8 +1592,10 @@ static int hook_parse( xmlNodePtr base )
 
          /* Set the id. */
          if ( id != 0 ) {
-            h     = hook_get( new_id );
+            h = hook_get( new_id );
+            hook_mapRemove( h );
             h->id = id;
+            hook_mapInsert( h );
 
             /* Additional info. */
             if ( is_date ) {
@@ -44,6 +44,7 @@
 #include "nstring.h"
 #include "ntime.h"
 #include "ntracing.h"
+#include "outfit.h"
 #include "player.h"
 #include "player_autonav.h"
 #include "player_fleet.h"
@@ -86,8 +87,8 @@ static int   land_regen = 0; /**< Whether or not regenning. */
 static int   land_windowsMap[LAND_NUMWINDOWS]; /**< Mapping of windows. */
 static unsigned int *land_windows = NULL;      /**< Landed window ids. */
 Spob                *land_spob    = NULL;      /**< Spob player landed at. */
-static glTexture    *gfx_exterior =
-   NULL; /**< Exterior graphic of the landed spob. */
+static glTexRequest *gfx_exterior =
+   NULL; /**< Exterior graphic of the landed spob (loaded in background). */
 
 /*
  * mission computer stack
@@ -1152,7 +1153,7 @@ static void land_cleanupWindow( unsigned int wid, const char *name )
 
    /* Clean up possible stray graphic. */
    if ( gfx_exterior != NULL ) {
-      gl_freeTexture( gfx_exterior );
+      gl_texRequestFree( gfx_exterior );
       gfx_exterior = NULL;
    }
 }
@@ -1465,7 +1466,7 @@ void land( Spob *p, int load )
 
    /* Load stuff */
    land_spob    = p;
-   gfx_exterior = gl_newImage( p->gfx_exterior, 0 );
+   gfx_exterior = gl_texRequest( p->gfx_exterior, 0, 1, 1 );
 
    /* Run outfits as necessary. */
    pilot_outfitLOnland( player.p );
@@ -1541,7 +1542,8 @@ static void land_createMainTab( unsigned int wid )
    /*
     * Pretty display.
     */
-   window_addImage( wid, 20, -40, 400, 400, "imgSpob", gfx_exterior, 1 );
+   window_addImageRequest( wid, 20, -40, 400, 400, "imgSpob", gfx_exterior,
+                           1 );
    if ( land_spob->description != NULL )
       window_addText( wid, 440, -20 - offset, w - 460,
                       h - 20 - offset - 60 - LAND_BUTTON_HEIGHT * 2, 0,
@@ -1850,6 +1852,7 @@ void takeoff( int delay, int nosave )
 
    /* Hooks and stuff. */
    land_cleanup();         /* Cleanup stuff */
+   outfit_gfxStoreGC();    /* Unload store graphics over budget. */
    hooks_run( "takeoff" ); /* Must be run after cleanup since we don't want the
                               missions to think we are landed. */
    if ( menu_isOpen( MENU_MAIN ) )
@@ -1859,6 +1862,7 @@ void takeoff( int delay, int nosave )
    player_addEscorts(); /* TODO only regenerate fleet if planet has a shipyard
                          */
    effect_clear( &player.p->effects );
+   pilot_calcStatsDirty( player.p, PILOT_STATS_EFFECTS );
    pilot_healLanded( player.p );
 
    hooks_run( "enter" );
@@ -1877,6 +1881,7 @@ void takeoff( int delay, int nosave )
          continue;
 
       effect_clear( &p->effects );
+      pilot_calcStatsDirty( p, PILOT_STATS_EFFECTS );
       pilot_calcStats( p );
 
       /* Update lua stuff. */
@@ -1973,7 +1978,7 @@ void land_cleanup( void )
 
    /* Clean up possible stray graphic. */
    if ( gfx_exterior != NULL )
-      gl_freeTexture( gfx_exterior );
+      gl_texRequestFree( gfx_exterior );
    gfx_exterior = NULL;
 
    /* Remove computer markers just in case. */
@@ -27,6 +27,7 @@
 #include "menu.h"
 #include "mission.h"
 #include "ndata.h"
+#include "nfile.h"
 #include "nstring.h"
 #include "nxml.h"
 #include "player.h"
@@ -49,9 +50,16 @@
 #define BUTTON_WIDTH 120 /**< Button width. */
 #define BUTTON_HEIGHT 30 /**< Button height. */
 
+#define LOAD_INDEX_FILE                                                        \
+   "index.xml" /**< Name of the save header index in each player directory. */
+#define LOAD_INDEX_VERSION                                                     \
+   2 /**< Version of the save header index, bump when changing the format. */
+
 typedef struct player_saves_s {
    char    *name;
+   char    *path;  /**< Directory the saves are in. */
    nsave_t *saves;
+   int      dirty; /**< Whether the header index has to be rewritten. */
 } player_saves_t;
 
 static player_saves_t *load_saves = NULL; /**< Array of saves */
@@ -108,116 +116,365 @@ static int  load_compatibilityTest( const nsave_t *ns );
 static const char       *load_compatibilityString( const nsave_t *ns );
 static int               has_plugin( const char *plugin );
 static SaveCompatibility load_compatibility( const nsave_t *ns );
-static int       load_sortComparePlayersName( const void *p1, const void *p2 );
-static int       load_sortComparePlayers( const void *p1, const void *p2 );
-static int       load_sortCompareName( const void *p1, const void *p2 );
-static int       load_sortCompare( const void *p1, const void *p2 );
-static xmlDocPtr load_xml_parsePhysFS( const char *filename );
-static void      load_freeSave( nsave_t *ns );
+static int  load_sortComparePlayersName( const void *p1, const void *p2 );
+static int  load_sortComparePlayers( const void *p1, const void *p2 );
+static int  load_sortCompareName( const void *p1, const void *p2 );
+static int  load_sortCompare( const void *p1, const void *p2 );
+static void load_freeSave( nsave_t *ns );
+
+static char *load_readerStr( xmlTextReaderPtr reader );
+static char *load_readerAttr( xmlTextReaderPtr reader, const char *name );
+static void  load_indexRead( player_saves_t *ps );
+static int   load_indexWrite( const player_saves_t *ps );
+
+/**
+ * @brief Reads the text of the current element of a reader.
+ */
+static char *load_readerStr( xmlTextReaderPtr reader )
+{
+   xmlChar *str = xmlTextReaderReadString( reader );
+   char    *ret = ( str == NULL ) ? NULL : strdup( (const char *)str );
+   xmlFree( str );
+   return ret;
+}
 
 /**
- * @brief Loads an individual save.
+ * @brief Reads an attribute of the current element of a reader.
+ */
+static char *load_readerAttr( xmlTextReaderPtr reader, const char *name )
+{
+   xmlChar *str = xmlTextReaderGetAttribute( reader, (const xmlChar *)name );
+   char    *ret = ( str == NULL ) ? NULL : strdup( (const char *)str );
+   xmlFree( str );
+   return ret;
+}
+
+/**
+ * @brief Loads the header of an individual save.
+ *
+ * Streams the save and stops as soon as the header information at the start
+ * of the player node has been read, instead of parsing the entire document.
+ *
  * @param[out] save Structure to populate.
  * @return 0 on success.
  */
 static int load_load( nsave_t *save )
 {
-   xmlDocPtr  doc;
-   xmlNodePtr root, parent;
+   xmlTextReaderPtr reader;
+   int              ret, done, skip;
+   int              cycles, periods, seconds, hastime;
+   const char      *section = "";
+
+   /* Open the XML. */
+   reader = xml_readerStream( save->path );
+   if ( reader == NULL ) {
+      WARN( _( "Unable to parse save path '%s'." ), save->path );
+      return -1;
+   }
 
-   /* Load the XML. */
-   doc = load_xml_parsePhysFS( save->path );
-   if ( doc == NULL ) {
+   done = hastime = 0;
+   cycles = periods = seconds = 0;
+   ret                        = xmlTextReaderRead( reader );
+   while ( ret == 1 ) {
+      int         depth = xmlTextReaderDepth( reader );
+      int         type  = xmlTextReaderNodeType( reader );
+      const char *name  = (const char *)xmlTextReaderConstName( reader );
+      skip              = 0;
+
+      /* Once the player node is done, we have the entire header. */
+      if ( type == XML_READER_TYPE_END_ELEMENT ) {
+         if ( ( depth == 1 ) && ( strcmp( section, "player" ) == 0 ) )
+            done = 1;
+      } else if ( type != XML_READER_TYPE_ELEMENT ) {
+         /* Only care about elements. */
+      } else if ( depth == 1 ) {
+         if ( strcmp( name, "version" ) == 0 )
+            section = "version";
+         else if ( strcmp( name, "plugins" ) == 0 ) {
+            section = "plugins";
+            if ( save->plugins == NULL )
+               save->plugins = array_create( char * );
+         } else if ( strcmp( name, "player" ) == 0 ) {
+            section = "player";
+            free( save->player_name );
+            save->player_name = load_readerAttr( reader, "name" );
+         } else {
+            section = "";
+            skip    = 1;
+         }
+      } else if ( depth == 2 ) {
+         if ( strcmp( section, "version" ) == 0 ) {
+            if ( strcmp( name, "naev" ) == 0 ) {
+               free( save->version );
+               save->version = load_readerStr( reader );
+            } else if ( strcmp( name, "data" ) == 0 ) {
+               free( save->data );
+               save->data = load_readerStr( reader );
+            }
+         } else if ( strcmp( section, "plugins" ) == 0 ) {
+            if ( strcmp( name, "plugin" ) == 0 ) {
+               char *plugin = load_readerStr( reader );
+               if ( plugin != NULL )
+                  array_push_back( &save->plugins, plugin );
+               else
+                  WARN( _( "Save '%s' has unnamed plugin node!" ), save->path );
+            }
+         } else if ( strcmp( section, "player" ) == 0 ) {
+            /* Player info. */
+            if ( strcmp( name, "location" ) == 0 ) {
+               free( save->spob );
+               save->spob = load_readerStr( reader );
+            } else if ( strcmp( name, "credits" ) == 0 ) {
+               char *str     = load_readerStr( reader );
+               save->credits = ( str == NULL ) ? 0 : strtoull( str, NULL, 10 );
+               free( str );
+            } else if ( strcmp( name, "chapter" ) == 0 ) {
+               free( save->chapter );
+               save->chapter = load_readerStr( reader );
+            } else if ( strcmp( name, "difficulty" ) == 0 ) {
+               free( save->difficulty );
+               save->difficulty = load_readerStr( reader );
+            }
+            /* Time. */
+            else if ( strcmp( name, "time" ) == 0 )
+               hastime = 1;
+            /* Ship info. */
+            else if ( strcmp( name, "ship" ) == 0 ) {
+               free( save->shipname );
+               free( save->shipmodel );
+               save->shipname  = load_readerAttr( reader, "name" );
+               save->shipmodel = load_readerAttr( reader, "model" );
+               skip            = 1;
+            }
+            /* The rest of the ships and everything after are not needed. */
+            else if ( strcmp( name, "ships" ) == 0 )
+               done = 1;
+            else
+               skip = 1;
+         }
+      } else if ( ( depth == 3 ) && hastime ) {
+         char *str = NULL;
+         if ( strcmp( name, "SCU" ) == 0 ) {
+            str    = load_readerStr( reader );
+            cycles = ( str == NULL ) ? 0 : strtol( str, NULL, 10 );
+         } else if ( strcmp( name, "STP" ) == 0 ) {
+            str     = load_readerStr( reader );
+            periods = ( str == NULL ) ? 0 : strtol( str, NULL, 10 );
+         } else if ( strcmp( name, "STU" ) == 0 ) {
+            str     = load_readerStr( reader );
+            seconds = ( str == NULL ) ? 0 : strtol( str, NULL, 10 );
+         }
+         free( str );
+      }
+
+      if ( done )
+         break;
+      ret = skip ? xmlTextReaderNext( reader ) : xmlTextReaderRead( reader );
+   }
+   xmlFreeTextReader( reader );
+
+   if ( ret < 0 ) {
       WARN( _( "Unable to parse save path '%s'." ), save->path );
       return -1;
    }
-   root = doc->xmlChildrenNode; /* base node */
-   if ( root == NULL ) {
-      WARN( _( "Unable to get child node of save '%s'." ), save->path );
-      xmlFreeDoc( doc );
+   if ( save->player_name == NULL ) {
+      WARN( _( "Save '%s' has no player node!" ), save->path );
       return -1;
    }
+   if ( hastime )
+      save->date = ntime_create( cycles, periods, seconds );
+
+   /* Defaults. */
+   if ( save->chapter == NULL )
+      save->chapter = strdup( start_chapter() );
+
+   save->compatible = load_compatibility( save );
+
+   return 0;
+}
+
+/**
+ * @brief Fills in the saves of a player directory from its header index.
+ *
+ * Entries are only used if the save file has not been modified since the
+ * index was written. Saves that could not be filled in have to be loaded.
+ */
+static void load_indexRead( player_saves_t *ps )
+{
+   char       path[PATH_MAX];
+   xmlDocPtr  doc;
+   xmlNodePtr node;
+   int        version, nused, nentries;
+
+   /* No index, so has to be created. */
+   ps->dirty = 1;
+   snprintf( path, sizeof( path ), "%s/%s", ps->path, LOAD_INDEX_FILE );
+   if ( !PHYSFS_exists( path ) )
+      return;
+
+   doc = xml_parseStream( path );
+   if ( doc == NULL )
+      return;
+   node = doc->xmlChildrenNode;
+   if ( ( node == NULL ) || !xml_isNode( node, "save_index" ) ) {
+      xmlFreeDoc( doc );
+      return;
+   }
+   xmlr_attr_int( node, "version", version );
+   if ( version != LOAD_INDEX_VERSION ) {
+      xmlFreeDoc( doc );
+      return;
+   }
 
-   /* Iterate inside the naev_save. */
-   parent = root->xmlChildrenNode;
+   nused = nentries = 0;
+   node             = node->xmlChildrenNode;
+   if ( node == NULL ) {
+      xmlFreeDoc( doc );
+      return;
+   }
    do {
-      xml_onlyNodes( parent );
+      char         *file;
+      PHYSFS_sint64 modtime, filesize;
+      nsave_t      *ns = NULL;
 
-      /* Info. */
-      if ( xml_isNode( parent, "version" ) ) {
-         xmlNodePtr node = parent->xmlChildrenNode;
-         do {
-            xmlr_strd( node, "naev", save->version );
-            xmlr_strd( node, "data", save->data );
-         } while ( xml_nextNode( node ) );
+      xml_onlyNodes( node );
+      if ( !xml_isNode( node, "save" ) )
          continue;
+      nentries++;
+
+      /* Find the save it corresponds to. */
+      xmlr_attr_strd( node, "file", file );
+      xmlr_attr_long( node, "modtime", modtime );
+      xmlr_attr_long( node, "size", filesize );
+      for ( int i = 0; i < array_size( ps->saves ); i++ ) {
+         nsave_t *s = &ps->saves[i];
+         if ( !s->cached && ( file != NULL ) &&
+              ( strcmp( s->save_name, file ) == 0 ) ) {
+            ns = s;
+            break;
+         }
       }
+      free( file );
+      /* Modification times only have second granularity, so a save
+       * rewritten within the same second is caught by its size. */
+      if ( ( ns == NULL ) || ( ns->modtime != modtime ) ||
+           ( ns->filesize != filesize ) )
+         continue;
 
-      else if ( xml_isNode( parent, "player" ) ) {
-         /* Get name. */
-         xmlr_attr_strd( parent, "name", save->player_name );
-         /* Parse rest. */
-         xmlNodePtr node = parent->xmlChildrenNode;
+      /* Load the header. */
+      nsave_t    hdr;
+      xmlNodePtr cur = node->xmlChildrenNode;
+      memset( &hdr, 0, sizeof( hdr ) );
+      hdr.plugins = array_create( char * );
+      if ( cur != NULL ) {
          do {
-            xml_onlyNodes( node );
-
-            /* Player info. */
-            xmlr_strd( node, "location", save->spob );
-            xmlr_ulong( node, "credits", save->credits );
-            xmlr_strd( node, "chapter", save->chapter );
-            xmlr_strd( node, "difficulty", save->difficulty );
-
-            /* Time. */
-            if ( xml_isNode( node, "time" ) ) {
-               int        cycles, periods, seconds;
-               xmlNodePtr cur = node->xmlChildrenNode;
-               cycles = periods = seconds = 0;
-               do {
-                  xmlr_int( cur, "SCU", cycles );
-                  xmlr_int( cur, "STP", periods );
-                  xmlr_int( cur, "STU", seconds );
-               } while ( xml_nextNode( cur ) );
-               save->date = ntime_create( cycles, periods, seconds );
+            xml_onlyNodes( cur );
+            xmlr_strd( cur, "naev", hdr.version );
+            xmlr_strd( cur, "data", hdr.data );
+            xmlr_strd( cur, "player", hdr.player_name );
+            xmlr_strd( cur, "spob", hdr.spob );
+            xmlr_ulong( cur, "credits", hdr.credits );
+            xmlr_strd( cur, "chapter", hdr.chapter );
+            xmlr_strd( cur, "difficulty", hdr.difficulty );
+            xmlr_strd( cur, "shipname", hdr.shipname );
+            xmlr_strd( cur, "shipmodel", hdr.shipmodel );
+            if ( xml_isNode( cur, "date" ) ) {
+               xml_parseNTime( cur, &hdr.date );
                continue;
             }
-
-            /* Ship info. */
-            if ( xml_isNode( node, "ship" ) ) {
-               xmlr_attr_strd( node, "name", save->shipname );
-               xmlr_attr_strd( node, "model", save->shipmodel );
+            if ( xml_isNode( cur, "plugin" ) ) {
+               const char *name = xml_get( cur );
+               if ( name != NULL )
+                  array_push_back( &hdr.plugins, strdup( name ) );
                continue;
             }
-         } while ( xml_nextNode( node ) );
-         continue;
-      } else if ( xml_isNode( parent, "plugins" ) ) {
-         save->plugins = array_create( char * );
-         /* Parse rest. */
-         xmlNodePtr node = parent->xmlChildrenNode;
-         do {
-            xml_onlyNodes( node );
+         } while ( xml_nextNode( cur ) );
+      }
 
-            if ( xml_isNode( node, "plugin" ) ) {
-               const char *name = xml_get( node );
-               if ( name != NULL )
-                  array_push_back( &save->plugins, strdup( name ) );
-               else
-                  WARN( _( "Save '%s' has unnamed plugin node!" ), save->path );
-            }
-         } while ( xml_nextNode( node ) );
+      /* Broken entry, so just reload the save. */
+      if ( ( hdr.player_name == NULL ) || ( hdr.chapter == NULL ) ) {
+         load_freeSave( &hdr );
          continue;
       }
-   } while ( xml_nextNode( parent ) );
-
-   /* Defaults. */
-   if ( save->chapter == NULL )
-      save->chapter = strdup( start_chapter() );
-
-   save->compatible = load_compatibility( save );
-
-   /* Clean up. */
+      hdr.save_name  = ns->save_name;
+      hdr.path       = ns->path;
+      hdr.modtime    = ns->modtime;
+      hdr.filesize   = ns->filesize;
+      hdr.compatible = load_compatibility( &hdr );
+      *ns            = hdr;
+      ns->cached     = 1;
+      nused++;
+   } while ( xml_nextNode( node ) );
    xmlFreeDoc( doc );
 
-   return 0;
+   /* Only have to rewrite if something changed. */
+   ps->dirty = ( nused != nentries ) || ( nused != array_size( ps->saves ) );
+}
+
+/**
+ * @brief Writes the header index of a player directory.
+ */
+static int load_indexWrite( const player_saves_t *ps )
+{
+   char             file[PATH_MAX];
+   xmlBufferPtr     buf;
+   xmlTextWriterPtr writer;
+   int              ret;
+
+   buf = xmlBufferCreate();
+   if ( buf == NULL ) {
+      WARN( _( "testXmlwriterDoc: Error creating the xml buffer" ) );
+      return -1;
+   }
+   writer = xmlNewTextWriterMemory( buf, 0 );
+   if ( writer == NULL ) {
+      WARN( _( "testXmlwriterDoc: Error creating the xml writer" ) );
+      xmlBufferFree( buf );
+      return -1;
+   }
+   xmlw_setParams( writer );
+   xmlw_start( writer );
+   xmlw_startElem( writer, "save_index" );
+   xmlw_attr( writer, "version", "%d", LOAD_INDEX_VERSION );
+   for ( int i = 0; i < array_size( ps->saves ); i++ ) {
+      const nsave_t *ns = &ps->saves[i];
+      xmlw_startElem( writer, "save" );
+      xmlw_attr( writer, "file", "%s", ns->save_name );
+      xmlw_attr( writer, "modtime", "%lld", (long long)ns->modtime );
+      xmlw_attr( writer, "size", "%lld", (long long)ns->filesize );
+      if ( ns->version != NULL )
+         xmlw_elem( writer, "naev", "%s", ns->version );
+      if ( ns->data != NULL )
+         xmlw_elem( writer, "data", "%s", ns->data );
+      xmlw_elem( writer, "player", "%s", ns->player_name );
+      if ( ns->spob != NULL )
+         xmlw_elem( writer, "spob", "%s", ns->spob );
+      xmlw_saveNTime( writer, "date", ns->date );
+      xmlw_elem( writer, "credits", "%" PRIu64, ns->credits );
+      xmlw_elem( writer, "chapter", "%s", ns->chapter );
+      if ( ns->difficulty != NULL )
+         xmlw_elem( writer, "difficulty", "%s", ns->difficulty );
+      if ( ns->shipname != NULL )
+         xmlw_elem( writer, "shipname", "%s", ns->shipname );
+      if ( ns->shipmodel != NULL )
+         xmlw_elem( writer, "shipmodel", "%s", ns->shipmodel );
+      for ( int j = 0; j < array_size( ns->plugins ); j++ )
+         xmlw_elem( writer, "plugin", "%s", ns->plugins[j] );
+      xmlw_endElem( writer ); /* "save" */
+   }
+   xmlw_endElem( writer ); /* "save_index" */
+   xmlw_done( writer );
+   xmlFreeTextWriter( writer );
+
+   /* Replaced atomically so a crash can't leave a truncated index. */
+   snprintf( file, sizeof( file ), "%s/%s/%s", PHYSFS_getWriteDir(), ps->path,
+             LOAD_INDEX_FILE );
+   ret = nfile_writeFileAtomic( (const char *)xmlBufferContent( buf ),
+                                xmlBufferLength( buf ), file );
+   if ( ret < 0 )
+      WARN( _( "Failed to write save index '%s'!" ), file );
+   xmlBufferFree( buf );
+   return ret;
 }
 
 static int load_loadThread( void *ptr )
@@ -234,6 +491,9 @@ int load_refresh( void )
 {
    ThreadQueue *tq = vpool_create();
 
+   /* Make sure the saves are all there. */
+   save_wait();
+
    if ( load_saves != NULL )
       load_free();
 
@@ -241,12 +501,14 @@ int load_refresh( void )
    load_saves = array_create( player_saves_t );
    PHYSFS_enumerate( "saves", load_enumerateCallback, NULL );
 
-   /* Set up threads and load. */
+   /* Set up threads and load the saves not in the index. */
    for ( int i = 0; i < array_size( load_saves ); i++ ) {
       player_saves_t *ps = &load_saves[i];
+      load_indexRead( ps );
       for ( int j = 0; j < array_size( ps->saves ); j++ ) {
          nsave_t *ns = &ps->saves[j];
-         vpool_enqueue( tq, load_loadThread, ns );
+         if ( !ns->cached )
+            vpool_enqueue( tq, load_loadThread, ns );
       }
    }
    vpool_wait( tq );
@@ -258,16 +520,20 @@ int load_refresh( void )
       for ( int j = array_size( ps->saves ) - 1; j >= 0; j-- ) {
          const nsave_t *ns = &ps->saves[j];
          if ( ns->ret != 0 ) {
-            free( ns->path );
-            free( ns->save_name );
+            load_freeSave( &ps->saves[j] );
             array_erase( &ps->saves, &ps->saves[j], &ps->saves[j + 1] );
             continue;
          }
          if ( ps->name == NULL )
             ps->name = strdup( ns->player_name );
       }
-      if ( ps->name == NULL )
+      if ( ps->dirty && ( array_size( ps->saves ) > 0 ) )
+         load_indexWrite( ps );
+      if ( ps->name == NULL ) {
+         array_free( ps->saves );
+         free( ps->path );
          array_erase( &load_saves, &load_saves[i], &load_saves[i + 1] );
+      }
    }
 
    /* Sort and done. */
@@ -313,6 +579,7 @@ int load_refresh( void )
       /* Erase current iterator. */
       array_free( ps->saves );
       free( ps->name );
+      free( ps->path );
       array_erase( &load_saves, ps, &ps[1] );
    }
 
@@ -352,6 +619,7 @@ static int load_enumerateCallbackPlayer( void *data, const char *origdir,
       ns.save_name                             = strdup( fname );
       ns.save_name[strlen( ns.save_name ) - 3] = '\0';
       ns.modtime                               = stat.modtime;
+      ns.filesize                              = stat.filesize;
       array_push_back( &ps->saves, ns );
    } else
       free( path );
@@ -398,7 +666,9 @@ static int load_enumerateCallback( void *data, const char *origdir,
    } else if ( stat.filetype == PHYSFS_FILETYPE_DIRECTORY ) {
       player_saves_t psave;
       psave.name  = NULL;
+      psave.path  = strdup( path );
       psave.saves = array_create( nsave_t );
+      psave.dirty = 0;
       PHYSFS_enumerate( path, load_enumerateCallbackPlayer, &psave );
       array_push_back( &load_saves, psave );
    }
@@ -636,6 +906,7 @@ void load_free( void )
    for ( int i = 0; i < array_size( load_saves ); i++ ) {
       player_saves_t *ps = &load_saves[i];
       free( ps->name );
+      free( ps->path );
       for ( int j = 0; j < array_size( ps->saves ); j++ ) {
          load_freeSave( &ps->saves[j] );
       }
@@ -1170,6 +1441,9 @@ static void load_menu_delete( unsigned int wdw, const char *str )
       if ( !PHYSFS_delete( load_saves[pos].saves[i].path ) )
          dialogue_alert( _( "Unable to delete %s" ),
                          load_saves[pos].saves[i].path );
+   snprintf( path, sizeof( path ), "saves/%s/%s", load_saves[pos].name,
+             LOAD_INDEX_FILE );
+   PHYSFS_delete( path ); /* May not exist. */
    snprintf( path, sizeof( path ), "saves/%s", load_saves[pos].name );
    if ( !PHYSFS_delete( path ) )
       dialogue_alert( _( "Unable to delete '%s' directory" ),
@@ -1212,6 +1486,9 @@ static void load_snapshot_menu_delete( unsigned int wdw, const char *str )
    /* Delete directory if all are gone. */
    if ( last_save ) {
       char path[PATH_MAX];
+      snprintf( path, sizeof( path ), "saves/%s/%s", load_player->name,
+                LOAD_INDEX_FILE );
+      PHYSFS_delete( path ); /* May not exist. */
       snprintf( path, sizeof( path ), "saves/%s", load_player->name );
       if ( !PHYSFS_delete( path ) )
          dialogue_alert( _( "Unable to delete '%s' directory" ),
@@ -1284,6 +1561,9 @@ int load_gameDiff( const char *file )
    xmlNodePtr node;
    xmlDocPtr  doc;
 
+   /* Make sure it is done being written. */
+   save_wait();
+
    /* Make sure it exists. */
    if ( !PHYSFS_exists( file ) ) {
       dialogue_alertRaw( _( "Saved game file seems to have been deleted." ) );
@@ -1291,7 +1571,7 @@ int load_gameDiff( const char *file )
    }
 
    /* Load the XML. */
-   doc = load_xml_parsePhysFS( file );
+   doc = xml_parseStream( file );
    if ( doc == NULL )
       goto err;
    node = doc->xmlChildrenNode; /* base node */
@@ -1325,6 +1605,9 @@ int load_game( const nsave_t *ns )
    const char  *file    = ns->path;
    const char  *version = ns->version;
 
+   /* Make sure it is done being written. */
+   save_wait();
+
    /* Make sure it exists. */
    if ( !PHYSFS_exists( file ) ) {
       dialogue_alertRaw( _( "Saved game file seems to have been deleted." ) );
@@ -1378,7 +1661,7 @@ static int load_gameInternalHook( void *data )
    free( data );
 
    /* Load the XML. */
-   doc = load_xml_parsePhysFS( file );
+   doc = xml_parseStream( file );
    if ( doc == NULL )
       goto err;
    node = doc->xmlChildrenNode; /* base node */
@@ -1495,14 +1778,3 @@ err:
    menu_main();
    return -1;
 }
-
-/**
- * @brief Temporary (hopefully) wrapper around xml_parsePhysFS in support of
- * gzipped XML (like .ns files).
- */
-static xmlDocPtr load_xml_parsePhysFS( const char *filename )
-{
-   char buf[PATH_MAX];
-   snprintf( buf, sizeof( buf ), "%s/%s", PHYSFS_getWriteDir(), filename );
-   return xmlParseFile( buf );
-}
@@ -27,6 +27,7 @@ typedef struct nsave_s {
    char         *player_name; /**< Player name. */
    char         *path; /**< File path relative to PhysicsFS write directory. */
    PHYSFS_sint64 modtime; /**< Last modified time in seconds from UNIX epoch. */
+   PHYSFS_sint64 filesize; /**< Size of the save file in bytes. */
 
    /* Naev info. */
    char *version; /**< Naev version. */
@@ -47,7 +48,8 @@ typedef struct nsave_s {
    char *shipname;  /**< Name of the ship. */
    char *shipmodel; /**< Model of the ship. */
 
-   int ret; /**< Used for threaded loading. */
+   int ret;    /**< Used for threaded loading. */
+   int cached; /**< Header was read from the save index. */
 } nsave_t;
 
 void load_loadGameMenu( void );
@@ -7,6 +7,7 @@
  * @brief Handles missions.
  */
 /** @cond */
+#include <limits.h>
 #include <stdlib.h>
 
 #include <SDL3/SDL_timer.h>
@@ -35,6 +36,7 @@
 #include "player_fleet.h"
 #include "rng.h"
 #include "space.h"
+#include "spawn_index.h"
 
 #define XML_MISSION_TAG "mission" /**< XML mission tag. */
 
@@ -51,6 +53,17 @@ static char       **player_missions_failed =
  */
 static MissionData *mission_stack = NULL; /**< Unmutable after creation */
 
+static SpawnIndex mission_index[MIS_AVAIL_ENTER + 1]; /**< By location. */
+
+/*
+ * chapter matching cache
+ */
+static char *mission_chapter = NULL; /**< Chapter the cache was built for. */
+static int  *mission_chapterCache =
+   NULL; /**< Chapter results by mission index (array.h). */
+#define MISSION_CHAPTER_UNKNOWN                                                \
+   INT_MIN /**< Chapter hasn't been matched yet. */
+
 /*
  * prototypes
  */
@@ -66,6 +79,12 @@ static int mission_meetReq( const MissionData *misn, int faction,
                             const Spob *pnt, const StarSystem *sys );
 static int mission_matchFaction( const MissionData *misn, int faction );
 static int mission_location( const char *loc );
+static int mission_matchChapter( const MissionData *misn );
+/* Index. */
+static void missions_indexBuild( void );
+static void missions_indexFree( void );
+static int *missions_indexGet( MissionAvailability loc, int faction,
+                               const Spob *pnt, const StarSystem *sys );
 /* Loading. */
 static int missions_cmp( const void *a, const void *b );
 static int mission_parseFile( const char *file, MissionData *temp );
@@ -235,25 +254,62 @@ int mission_alreadyRunning( const MissionData *misn )
    return n;
 }
 
+/**
+ * @brief Checks to see if a mission matches the player's current chapter.
+ *
+ * Results are cached per mission and only recomputed when the chapter changes.
+ *
+ *    @param misn Mission to check.
+ *    @return 0 if it matches (or errored), -1 or 1 if it doesn't.
+ */
+static int mission_matchChapter( const MissionData *misn )
+{
+   int id, rc;
+   const char *chapter = ( player.chapter != NULL ) ? player.chapter : "";
+
+   /* Invalidate the cache if the chapter changed. */
+   if ( ( mission_chapter == NULL ) ||
+        ( strcmp( mission_chapter, chapter ) != 0 ) ) {
+      free( mission_chapter );
+      mission_chapter = strdup( chapter );
+      if ( mission_chapterCache == NULL )
+         mission_chapterCache = array_create( int );
+      array_resize( &mission_chapterCache, array_size( mission_stack ) );
+      for ( int i = 0; i < array_size( mission_chapterCache ); i++ )
+         mission_chapterCache[i] = MISSION_CHAPTER_UNKNOWN;
+   }
+
+   id = misn - mission_stack;
+   if ( mission_chapterCache[id] != MISSION_CHAPTER_UNKNOWN )
+      return mission_chapterCache[id];
+
+   rc = pcre2_match( misn->avail.chapter_re, (PCRE2_SPTR)chapter,
+                     strlen( chapter ), 0, 0, misn->avail.chapter_md, NULL );
+   if ( rc < 0 ) {
+      switch ( rc ) {
+      case PCRE2_ERROR_NOMATCH:
+         rc = -1;
+         break;
+      default:
+         WARN( _( "Matching error %d" ), rc );
+         rc = 0;
+         break;
+      }
+   } else if ( rc == 0 )
+      rc = 1;
+   else
+      rc = 0;
+   mission_chapterCache[id] = rc;
+   return rc;
+}
+
 static int mission_meetConditionals( const MissionData *misn )
 {
    /* If chapter, must match chapter. */
    if ( misn->avail.chapter_re != NULL ) {
-      pcre2_match_data *match_data =
-         pcre2_match_data_create_from_pattern( misn->avail.chapter_re, NULL );
-      int rc = pcre2_match( misn->avail.chapter_re, (PCRE2_SPTR)player.chapter,
-                            strlen( player.chapter ), 0, 0, match_data, NULL );
-      pcre2_match_data_free( match_data );
-      if ( rc < 0 ) {
-         switch ( rc ) {
-         case PCRE2_ERROR_NOMATCH:
-            return -1;
-         default:
-            WARN( _( "Matching error %d" ), rc );
-            break;
-         }
-      } else if ( rc == 0 )
-         return 1;
+      int c = mission_matchChapter( misn );
+      if ( c != 0 )
+         return c;
    }
 
    /* Must not be already done or running if unique. */
@@ -315,6 +371,70 @@ static int mission_meetReq( const MissionData *misn, int faction,
    return !mission_meetConditionals( misn );
 }
 
+/**
+ * @brief Frees the mission location index.
+ */
+static void missions_indexFree( void )
+{
+   for ( int i = 0; i <= MIS_AVAIL_ENTER; i++ )
+      spawnindex_free( &mission_index[i] );
+   array_free( mission_chapterCache );
+   mission_chapterCache = NULL;
+   free( mission_chapter );
+   mission_chapter = NULL;
+}
+
+/**
+ * @brief Builds the mission location index from the mission stack.
+ */
+static void missions_indexBuild( void )
+{
+   missions_indexFree();
+
+   for ( int i = 0; i <= MIS_AVAIL_ENTER; i++ )
+      spawnindex_init( &mission_index[i] );
+
+   for ( int i = 0; i < array_size( mission_stack ); i++ ) {
+      const MissionData *misn = &mission_stack[i];
+      if ( ( misn->avail.loc < 0 ) || ( misn->avail.loc > MIS_AVAIL_ENTER ) )
+         continue;
+      spawnindex_add( &mission_index[misn->avail.loc], misn->avail.spob,
+                      misn->avail.system, misn->avail.factions, i );
+   }
+
+   for ( int i = 0; i <= MIS_AVAIL_ENTER; i++ )
+      spawnindex_sort( &mission_index[i] );
+}
+
+/**
+ * @brief Gets the missions that could possibly spawn somewhere.
+ *
+ * Candidates still have to be checked with mission_meetReq(), but everything
+ * that is left out is guaranteed to fail it.
+ *
+ *    @param loc Location to match.
+ *    @param faction Faction of the spob.
+ *    @param pnt Spob to run on.
+ *    @param sys System to run on.
+ *    @return Candidate mission indices in priority order (array.h). Has to be
+ *            freed by the caller.
+ */
+static int *missions_indexGet( MissionAvailability loc, int faction,
+                               const Spob *pnt, const StarSystem *sys )
+{
+   int nospawn;
+
+   if ( ( loc < 0 ) || ( loc > MIS_AVAIL_ENTER ) )
+      return array_create( int );
+
+   /* Spob specific missions ignore SPOB_NOMISNSPAWN. */
+   nospawn = ( pnt != NULL ) && spob_isFlag( pnt, SPOB_NOMISNSPAWN );
+   return spawnindex_get( &mission_index[loc],
+                          ( pnt != NULL ) ? pnt->name : NULL,
+                          ( !nospawn && ( sys != NULL ) ) ? sys->name : NULL,
+                          !nospawn, faction );
+}
+
 /**
  * @brief Runs missions matching location, all Lua side and one-shot.
  *
@@ -326,16 +446,14 @@ static int mission_meetReq( const MissionData *misn, int faction,
 void missions_run( MissionAvailability loc, int faction, const Spob *pnt,
                    const StarSystem *sys )
 {
-   for ( int i = 0; i < array_size( mission_stack ); i++ ) {
+   int *cand = missions_indexGet( loc, faction, pnt, sys );
+   for ( int i = 0; i < array_size( cand ); i++ ) {
       Mission      mission;
       double       chance;
-      MissionData *misn = &mission_stack[i];
+      MissionData *misn = &mission_stack[cand[i]];
 
       if ( naev_isQuit() )
-         return;
-
-      if ( misn->avail.loc != loc )
-         continue;
+         break;
 
       if ( !mission_meetReq( misn, faction, pnt, sys ) )
          continue;
@@ -350,6 +468,7 @@ void missions_run( MissionAvailability loc, int faction, const Spob *pnt,
             &mission ); /* it better clean up for itself or we do it */
       }
    }
+   array_free( cand );
 }
 
 /**
@@ -868,6 +987,7 @@ static void mission_freeData( MissionData *mission )
    free( mission->avail.spob );
    free( mission->avail.system );
    free( mission->avail.chapter );
+   pcre2_match_data_free( mission->avail.chapter_md );
    pcre2_code_free( mission->avail.chapter_re );
    array_free( mission->avail.factions );
    free( mission->avail.cond );
@@ -960,16 +1080,16 @@ Mission *missions_genList( int faction, const Spob *pnt, const StarSystem *sys,
                            MissionAvailability loc )
 {
    int      rep;
+   int     *cand;
    Mission *tmp = array_create( Mission );
 
    NTracingZone( _ctx, 1 );
 
    /* Find available missions. */
-   for ( int i = 0; i < array_size( mission_stack ); i++ ) {
+   cand = missions_indexGet( loc, faction, pnt, sys );
+   for ( int i = 0; i < array_size( cand ); i++ ) {
       double       chance;
-      MissionData *misn = &mission_stack[i];
-      if ( misn->avail.loc != loc )
-         continue;
+      MissionData *misn = &mission_stack[cand[i]];
 
       /* Must hit chance. */
       chance = (double)( misn->avail.chance % 100 ) / 100.;
@@ -994,6 +1114,7 @@ Mission *missions_genList( int faction, const Spob *pnt, const StarSystem *sys,
          array_push_back( &tmp, newm );
       }
    }
+   array_free( cand );
 
    /* Sort. */
    if ( array_size( tmp ) > 0 )
@@ -1129,7 +1250,9 @@ static int mission_parseXML( MissionData *temp, const xmlNodePtr parent )
          WARN( _( "Mission '%s' chapter PCRE2 compilation failed at offset %d: "
                   "%s" ),
                temp->name, (int)erroroffset, buffer );
-      }
+      } else
+         temp->avail.chapter_md = pcre2_match_data_create_from_pattern(
+            temp->avail.chapter_re, NULL );
    }
 
 #define MELEMENT( o, s )                                                       \
@@ -1203,6 +1326,9 @@ int missions_load( void )
    qsort( mission_stack, array_size( mission_stack ), sizeof( MissionData ),
           missions_cmp );
 
+   /* Index by location. */
+   missions_indexBuild();
+
 #if DEBUGGING
    if ( conf.devmode ) {
       time = SDL_GetTicks() - time;
@@ -1312,6 +1438,9 @@ void missions_free( void )
    /* Free all the player missions. */
    missions_cleanup();
 
+   /* Free the index. */
+   missions_indexFree();
+
    /* Free the mission data. */
    for ( int i = 0; i < array_size( mission_stack ); i++ )
       mission_freeData( &mission_stack[i] );
@@ -1728,5 +1857,8 @@ int mission_reload( const char *name )
       mission_freeData( &save );
    else
       *temp = save;
+
+   /* Location or requirements may have changed. */
+   missions_indexBuild();
    return res;
 }
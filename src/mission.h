@@ -42,8 +42,9 @@ typedef struct MissionAvail_s {
    /* For specific cases */
    char       *spob;       /**< Spob name. */
    char       *system;     /**< System name. */
-   char       *chapter;    /**< Chapter name. */
-   pcre2_code *chapter_re; /**< Compiled regex chapter if applicable. */
+   char             *chapter;    /**< Chapter name. */
+   pcre2_code       *chapter_re; /**< Compiled regex chapter if applicable. */
+   pcre2_match_data *chapter_md; /**< Match data for chapter_re. */
 
    /* For generic cases */
    int *factions; /**< Array (array.h): To certain factions. */
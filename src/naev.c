@@ -76,6 +76,7 @@
 #include "plugin.h"
 #include "render.h"
 #include "safelanes.h"
+#include "save.h"
 #include "ship.h"
 #include "sound.h"
 #include "space.h"
@@ -246,6 +247,8 @@ int naev_main_events( void )
 
 int naev_main_cleanup( void )
 {
+   /* Finish writing any pending save. */
+   save_wait();
 
    /* Save configuration. */
    conf_saveConfig( conf_file_path );
@@ -655,6 +658,9 @@ static void update_all( int dohooks )
 {
    NTracingZone( _ctx, 1 );
 
+   /* The control tick budget is per frame, not per update. */
+   ai_frameStart();
+
    if ( ( real_dt > 0.25 ) &&
         ( fps_skipped == 0 ) ) { /* slow timers down and rerun calculations */
       fps_skipped = 1;
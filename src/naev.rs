@@ -370,6 +370,9 @@ fn naevmain() -> Result<()> {
             naevc::main_loop(0);
         }
 
+        // Upload textures that finished loading in the background
+        context.upload_textures(renderer::texture::UPLOAD_BUDGET);
+
         // Process clean up messages
         context.execute_messages();
     }
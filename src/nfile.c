@@ -14,16 +14,20 @@
 #include <stdlib.h>
 #include <sys/stat.h>
 
+#include <SDL3/SDL_error.h>
+#include <SDL3/SDL_filesystem.h>
 #include <SDL3/SDL_stdinc.h>
 
 #include <errno.h>
 #include <libgen.h> /* dirname / basename */
 #if HAS_POSIX
+#include <fcntl.h>
 #include <libgen.h>
 #include <sys/types.h>
 #include <unistd.h>
 #endif /* HAS_POSIX */
 #if SDL_PLATFORM_WIN32
+#include <io.h>
 #include <windows.h>
 #endif /* SDL_PLATFORM_WIN32 */
 /** @endcond */
@@ -519,6 +523,111 @@ int nfile_writeFile( const char *data, size_t len, const char *path )
    return 0;
 }
 
+/**
+ * @brief Tries to write a file, atomically replacing it if it exists.
+ *
+ * The data is written to a temporary file which is flushed to disk and then
+ * renamed over the original, so the file is never left partially written.
+ *
+ *    @param data Pointer to the data to write.
+ *    @param len The size of data.
+ *    @param path Path of the file.
+ *    @return 0 on success, -1 on error.
+ */
+int nfile_writeFileAtomic( const char *data, size_t len, const char *path )
+{
+   char   tmp[PATH_MAX];
+   size_t n;
+   FILE  *file;
+   int    ret;
+
+   if ( path == NULL )
+      return -1;
+
+   /* Open temporary file. */
+   snprintf( tmp, sizeof( tmp ), "%s.tmp", path );
+   file = fopen( tmp, "wb" );
+   if ( file == NULL ) {
+      WARN( _( "Error occurred while opening '%s': %s" ), tmp,
+            strerror( errno ) );
+      return -1;
+   }
+
+   /* Write the file. */
+   n = 0;
+   while ( n < len ) {
+      size_t pos = fwrite( &data[n], 1, len - n, file );
+      if ( pos <= 0 ) {
+         WARN( _( "Error occurred while writing '%s': %s" ), tmp,
+               strerror( errno ) );
+         goto err;
+      }
+      n += pos;
+   }
+
+   /* Make sure it actually hits the disk before replacing the original. */
+   if ( fflush( file ) == EOF ) {
+      WARN( _( "Error occurred while writing '%s': %s" ), tmp,
+            strerror( errno ) );
+      goto err;
+   }
+#if SDL_PLATFORM_WIN32
+   ret = _commit( _fileno( file ) );
+#elif HAS_POSIX
+   ret = fsync( fileno( file ) );
+#else  /* HAS_POSIX */
+   ret = 0;
+#endif /* SDL_PLATFORM_WIN32 */
+   if ( ret != 0 ) {
+      WARN( _( "Error occurred while syncing '%s': %s" ), tmp,
+            strerror( errno ) );
+      goto err;
+   }
+
+   /* Close the file. */
+   if ( fclose( file ) == EOF ) {
+      WARN( _( "Error occurred while closing '%s': %s" ), tmp,
+            strerror( errno ) );
+      remove( tmp );
+      return -1;
+   }
+
+   /* Replace the original. */
+   if ( !SDL_RenamePath( tmp, path ) ) {
+      WARN( _( "Error occurred while renaming '%s' to '%s': %s" ), tmp, path,
+            SDL_GetError() );
+      remove( tmp );
+      return -1;
+   }
+
+#if HAS_POSIX
+   /* The rename is only durable once the directory is synced too. */
+   {
+      const char *dir;
+      int         fd;
+      snprintf( tmp, sizeof( tmp ), "%s", path );
+      dir = dirname( tmp );
+      fd  = open( dir, O_RDONLY );
+      if ( fd < 0 ) {
+         WARN( _( "Error occurred while opening '%s': %s" ), dir,
+               strerror( errno ) );
+         return 0;
+      }
+      if ( fsync( fd ) != 0 )
+         WARN( _( "Error occurred while syncing '%s': %s" ), dir,
+               strerror( errno ) );
+      close( fd );
+   }
+#endif /* HAS_POSIX */
+
+   return 0;
+
+err:
+   fclose( file ); /* don't care about further errors */
+   remove( tmp );
+   return -1;
+}
+
 /**
  * @brief Checks to see if a character is used to separate files in a path.
  *
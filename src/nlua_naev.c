@@ -17,7 +17,9 @@
 
 #include "nlua_naev.h"
 
+#include "ai.h"
 #include "array.h"
+#include "cond.h"
 #include "console.h"
 #include "debug.h"
 #include "difficulty.h"
@@ -30,9 +32,14 @@
 #include "nlua_misn.h"
 #include "nlua_system.h"
 #include "nluadef.h"
+#include "opengl_render.h"
+#include "opengl_tex.h"
 #include "pause.h"
 #include "player.h"
 #include "plugin.h"
+#include "render.h"
+#include "ship.h"
+#include "spfx.h"
 
 static int cache_table = LUA_NOREF; /* No reference. */
 
@@ -76,6 +83,8 @@ static int naevL_unit( lua_State *L );
 static int naevL_quadtreeParams( lua_State *L );
 static int naevL_difficulty( lua_State *L );
 static int naevL_difficultyLevel( lua_State *L );
+static int naevL_perfStats( lua_State *L );
+static int naevL_perfStatsReset( lua_State *L );
 #if DEBUGGING
 static int naevL_debugTrails( lua_State *L );
 static int naevL_debugCollisions( lua_State *L );
@@ -121,6 +130,8 @@ static const luaL_Reg naev_methods[] = {
    { "quadtreeParams", naevL_quadtreeParams },
    { "difficulty", naevL_difficulty },
    { "difficultyLevel", naevL_difficultyLevel },
+   { "perfStats", naevL_perfStats },
+   { "perfStatsReset", naevL_perfStatsReset },
 #if DEBUGGING
    { "debugTrails", naevL_debugTrails },
    { "debugCollisions", naevL_debugCollisions },
@@ -1044,6 +1055,307 @@ static int naevL_difficultyLevel( lua_State *L )
    return 1;
 }
 
+/**
+ * @brief Pushes the statistics of the shared texture cache.
+ */
+static void naevL_pushTexCacheStats( lua_State *L )
+{
+   glTexCacheStats stats;
+   gl_texCacheStats( &stats );
+   lua_newtable( L );
+   lua_pushinteger( L, stats.hits );
+   lua_setfield( L, -2, "hits" );
+   lua_pushinteger( L, stats.misses );
+   lua_setfield( L, -2, "misses" );
+   lua_pushinteger( L, stats.inserts );
+   lua_setfield( L, -2, "inserts" );
+   lua_pushinteger( L, stats.evictions );
+   lua_setfield( L, -2, "evictions" );
+   lua_pushinteger( L, stats.names );
+   lua_setfield( L, -2, "names" );
+   lua_pushinteger( L, stats.entries );
+   lua_setfield( L, -2, "entries" );
+   lua_pushinteger( L, stats.live );
+   lua_setfield( L, -2, "live" );
+}
+
+/**
+ * @brief Pushes the statistics of the compiled Lua conditional cache.
+ */
+static void naevL_pushCondCacheStats( lua_State *L )
+{
+   CondStats stats;
+   cond_getStats( &stats );
+   lua_newtable( L );
+   lua_pushinteger( L, stats.hits );
+   lua_setfield( L, -2, "hits" );
+   lua_pushinteger( L, stats.misses );
+   lua_setfield( L, -2, "misses" );
+   lua_pushinteger( L, stats.evictions );
+   lua_setfield( L, -2, "evictions" );
+   lua_pushinteger( L, stats.entries );
+   lua_setfield( L, -2, "entries" );
+}
+
+/**
+ * @brief Pushes the statistics of the AI control tick scheduler.
+ */
+static void naevL_pushAIStats( lua_State *L )
+{
+   AIStats stats;
+   ai_getStats( &stats );
+   lua_newtable( L );
+   lua_pushinteger( L, stats.control );
+   lua_setfield( L, -2, "control" );
+   lua_pushinteger( L, stats.deferred );
+   lua_setfield( L, -2, "deferred" );
+   lua_pushinteger( L, stats.deferred_frame );
+   lua_setfield( L, -2, "deferred_frame" );
+   lua_pushnumber( L, stats.frame_time );
+   lua_setfield( L, -2, "frame_time" );
+}
+
+/**
+ * @brief Pushes the statistics of the per-tick pilot visibility cache.
+ */
+static void naevL_pushVisibilityStats( lua_State *L )
+{
+   PilotVisStats stats;
+   pilot_ewVisStats( &stats );
+   lua_newtable( L );
+   lua_pushinteger( L, stats.hits );
+   lua_setfield( L, -2, "hits" );
+   lua_pushinteger( L, stats.misses );
+   lua_setfield( L, -2, "misses" );
+   lua_pushinteger( L, stats.entries );
+   lua_setfield( L, -2, "entries" );
+}
+
+/**
+ * @brief Pushes the draw call counters of the renderer.
+ */
+static void naevL_pushRenderStats( lua_State *L )
+{
+   glRenderStats stats;
+   gl_renderStats( &stats );
+   lua_newtable( L );
+   lua_pushinteger( L, stats.draws );
+   lua_setfield( L, -2, "draws" );
+   lua_pushinteger( L, stats.batches );
+   lua_setfield( L, -2, "batches" );
+   lua_pushinteger( L, stats.sprites );
+   lua_setfield( L, -2, "sprites" );
+   lua_pushinteger( L, stats.shape_batches );
+   lua_setfield( L, -2, "shape_batches" );
+   lua_pushinteger( L, stats.shapes );
+   lua_setfield( L, -2, "shapes" );
+}
+
+/**
+ * @brief Pushes the counters of the trail renderer.
+ */
+static void naevL_pushTrailStats( lua_State *L )
+{
+   TrailStats stats;
+   spfx_trailStats( &stats );
+   lua_newtable( L );
+   lua_pushinteger( L, stats.trails );
+   lua_setfield( L, -2, "trails" );
+   lua_pushinteger( L, stats.draws );
+   lua_setfield( L, -2, "draws" );
+   lua_pushinteger( L, stats.vertices );
+   lua_setfield( L, -2, "vertices" );
+   lua_pushinteger( L, stats.frame_vertices );
+   lua_setfield( L, -2, "frame_vertices" );
+}
+
+/**
+ * @brief Pushes the counters of the 3D ship impostor cache.
+ */
+static void naevL_pushImpostorStats( lua_State *L )
+{
+   ShipImpostorStats stats;
+   ship_impostorStats( &stats );
+   lua_newtable( L );
+   lua_pushinteger( L, stats.hits );
+   lua_setfield( L, -2, "hits" );
+   lua_pushinteger( L, stats.misses );
+   lua_setfield( L, -2, "misses" );
+   lua_pushinteger( L, stats.cells );
+   lua_setfield( L, -2, "cells" );
+   lua_pushinteger( L, stats.atlases );
+   lua_setfield( L, -2, "atlases" );
+   lua_pushinteger( L, stats.memory );
+   lua_setfield( L, -2, "memory" );
+   lua_pushinteger( L, stats.evictions );
+   lua_setfield( L, -2, "evictions" );
+}
+
+/**
+ * @brief Pushes the counters of the visibility culling pass of the last frame.
+ */
+static void naevL_pushCullStats( lua_State *L )
+{
+   RenderCullStats stats;
+   render_cullStats( &stats );
+   lua_newtable( L );
+   lua_pushinteger( L, stats.pilots_drawn );
+   lua_setfield( L, -2, "pilots_drawn" );
+   lua_pushinteger( L, stats.pilots_culled );
+   lua_setfield( L, -2, "pilots_culled" );
+   lua_pushinteger( L, stats.weapons_drawn );
+   lua_setfield( L, -2, "weapons_drawn" );
+   lua_pushinteger( L, stats.weapons_culled );
+   lua_setfield( L, -2, "weapons_culled" );
+   lua_pushinteger( L, stats.asteroids_drawn );
+   lua_setfield( L, -2, "asteroids_drawn" );
+   lua_pushinteger( L, stats.asteroids_culled );
+   lua_setfield( L, -2, "asteroids_culled" );
+}
+
+/**
+ * @brief Pushes the profiling counters of an AI function as a table.
+ */
+static void naevL_pushAIProfStats( lua_State *L, const AIProfStats *stats )
+{
+   lua_newtable( L );
+   lua_pushinteger( L, stats->calls );
+   lua_setfield( L, -2, "calls" );
+   lua_pushnumber( L, stats->time );
+   lua_setfield( L, -2, "time" );
+   lua_pushnumber( L, stats->time_max );
+   lua_setfield( L, -2, "time_max" );
+   lua_pushnumber( L, stats->mem );
+   lua_setfield( L, -2, "mem" );
+}
+
+/**
+ * @brief Pushes the profiling counters of the AI profiles that have run at
+ * least once, indexed by profile name.
+ */
+static void naevL_pushAIProfile( lua_State *L )
+{
+   const AI_Profile *profiles = ai_getProfiles();
+   lua_newtable( L );
+   for ( int i = 0; i < array_size( profiles ); i++ ) {
+      const AI_Profile *prof = &profiles[i];
+      if ( prof->control.calls == 0 )
+         continue;
+      lua_newtable( L );
+      naevL_pushAIProfStats( L, &prof->control );
+      lua_setfield( L, -2, "control" );
+      lua_newtable( L );
+      for ( int j = 0; j < array_size( prof->tasks ); j++ ) {
+         naevL_pushAIProfStats( L, &prof->tasks[j] );
+         lua_setfield( L, -2, prof->tasks[j].name );
+      }
+      lua_setfield( L, -2, "tasks" );
+      lua_setfield( L, -2, prof->name );
+   }
+}
+
+/**
+ * @brief Group of performance counters available to naev.perfStats().
+ */
+typedef struct NaevPerfStats_ {
+   const char *name;                /**< Name of the group. */
+   void ( *push )( lua_State *L ); /**< Pushes the counters as a table. */
+} NaevPerfStats;
+
+static const NaevPerfStats naev_perfStats[] = {
+   { "texcache", naevL_pushTexCacheStats },
+   { "condcache", naevL_pushCondCacheStats },
+   { "ai", naevL_pushAIStats },
+   { "visibility", naevL_pushVisibilityStats },
+   { "render", naevL_pushRenderStats },
+   { "trail", naevL_pushTrailStats },
+   { "impostor", naevL_pushImpostorStats },
+   { "cull", naevL_pushCullStats },
+   { "aiprofile", naevL_pushAIProfile },
+   { NULL, NULL } }; /**< Performance counter groups. */
+
+/**
+ * @brief Gets performance counters of the engine.
+ *
+ * The available groups are:<br/>
+ * <ul>
+ *  <li>"texcache": "hits" and "misses" of shared texture cache lookups,
+ * "inserts" and "evictions" of textures, and the current number of "names",
+ * "entries" and "live" entries.</li>
+ *  <li>"condcache": "hits" and "misses" of compiled Lua conditional lookups,
+ * "evictions" and the current number of "entries".</li>
+ *  <li>"ai": total number of AI "control" ticks run and "deferred" to later
+ * frames, control ticks deferred during the last frame "deferred_frame" and
+ * the time in seconds spent running them "frame_time".</li>
+ *  <li>"visibility": pilot visibility checks that were "hits" or "misses" of
+ * the per-tick cache, and the number of pilot pairs "entries" cached.</li>
+ *  <li>"render": textured quad "draws" calls (including batches), instanced
+ * "batches" calls of the sprite batcher, "sprites" drawn by it, instanced
+ * "shape_batches" calls of simple shaders and "shapes" drawn by them.</li>
+ *  <li>"trail": "trails" drawn, "draws" calls issued for them, "vertices"
+ * uploaded in total and "frame_vertices" uploaded during the last frame.</li>
+ *  <li>"impostor": 3D ship "hits" drawn from an impostor atlas, "misses" that
+ * had to be rendered live, atlas "cells" rendered, "atlases" allocated, their
+ * estimated "memory" in bytes and "evictions" to stay within budget.</li>
+ *  <li>"cull": "pilots_drawn", "pilots_culled", "weapons_drawn",
+ * "weapons_culled", "asteroids_drawn" and "asteroids_culled" during the last
+ * frame.</li>
+ *  <li>"aiprofile": table indexed by the name of the AI profiles that have
+ * run. Each has a "control" table for the control function and a "tasks"
+ * table indexed by task function name, with the number of "calls", the total
+ * "time" and longest "time_max" in seconds and the Lua memory "mem" allocated
+ * in bytes.</li>
+ * </ul>
+ *
+ * @usage s = naev.perfStats("texcache"); print( s.hits / (s.hits + s.misses) )
+ * @usage for k,v in pairs(naev.perfStats("aiprofile")) do print( k,
+ * v.control.time ) end
+ *
+ *    @luatparam[opt] string name Name of the group of counters to get.
+ *    @luatreturn table Table with the counters of the group, or a table with
+ * all the groups indexed by name if no name is given.
+ * @luafunc perfStats
+ */
+static int naevL_perfStats( lua_State *L )
+{
+   const char *name;
+
+   if ( lua_isnoneornil( L, 1 ) ) {
+      lua_newtable( L );
+      for ( int i = 0; naev_perfStats[i].name != NULL; i++ ) {
+         naev_perfStats[i].push( L );
+         lua_setfield( L, -2, naev_perfStats[i].name );
+      }
+      return 1;
+   }
+
+   name = luaL_checkstring( L, 1 );
+   for ( int i = 0; naev_perfStats[i].name != NULL; i++ ) {
+      if ( strcmp( naev_perfStats[i].name, name ) == 0 ) {
+         naev_perfStats[i].push( L );
+         return 1;
+      }
+   }
+   return NLUA_ERROR( L, _( "Invalid performance statistics name '%s'." ),
+                      name );
+}
+
+/**
+ * @brief Resets the performance counters that accumulate until reset.
+ *
+ * Currently only the "aiprofile" counters, see naev.perfStats().
+ *
+ * @usage naev.perfStatsReset()
+ *
+ * @luafunc perfStatsReset
+ */
+static int naevL_perfStatsReset( lua_State *L )
+{
+   (void)L;
+   ai_profReset();
+   return 0;
+}
+
 #if DEBUGGING
 /**
  * @brief Toggles the trail emitters.
@@ -3409,7 +3409,9 @@ static int pilotL_setNoRender( lua_State *L )
  */
 static int pilotL_setVisplayer( lua_State *L )
 {
-   return pilotL_setFlagWrapper( L, PILOT_VISPLAYER );
+   pilotL_setFlagWrapper( L, PILOT_VISPLAYER );
+   pilot_ewVisClear();
+   return 0;
 }
 
 /**
@@ -3425,7 +3427,9 @@ static int pilotL_setVisplayer( lua_State *L )
  */
 static int pilotL_setVisible( lua_State *L )
 {
-   return pilotL_setFlagWrapper( L, PILOT_VISIBLE );
+   pilotL_setFlagWrapper( L, PILOT_VISIBLE );
+   pilot_ewVisClear();
+   return 0;
 }
 
 /**
@@ -4196,6 +4200,7 @@ static int pilotL_intrinsicReset( lua_State *L )
    Pilot *p = luaL_validpilot( L, 1 );
    ss_free( p->intrinsic_stats );
    p->intrinsic_stats = NULL;
+   pilot_calcStatsDirty( p, PILOT_STATS_BASE );
    pilot_calcStats( p );
    return 0;
 }
@@ -4226,6 +4231,7 @@ static int pilotL_intrinsicSet( lua_State *L )
       replace            = lua_toboolean( L, 4 );
       p->intrinsic_stats = ss_statsSetList(
          p->intrinsic_stats, ss_typeFromName( name ), value, replace, 0 );
+      pilot_calcStatsDirty( p, PILOT_STATS_BASE );
       pilot_calcStats( p );
       return 0;
    }
@@ -4240,6 +4246,7 @@ static int pilotL_intrinsicSet( lua_State *L )
       lua_pop( L, 1 );
    }
    lua_pop( L, 1 );
+   pilot_calcStatsDirty( p, PILOT_STATS_BASE );
    pilot_calcStats( p );
    return 0;
 }
@@ -4280,6 +4287,7 @@ static int pilotL_shippropReset( lua_State *L )
    Pilot *p = luaL_validpilot( L, 1 );
    ss_free( p->ship_stats );
    p->ship_stats = NULL;
+   pilot_calcStatsDirty( p, PILOT_STATS_BASE );
    pilot_calcStats( p );
    return 0;
 }
@@ -4314,6 +4322,7 @@ static int pilotL_shippropSet( lua_State *L )
       value = luaL_checknumber( L, 3 );
       p->ship_stats =
          ss_statsSetList( p->ship_stats, ss_typeFromName( name ), value, 1, 0 );
+      pilot_calcStatsDirty( p, PILOT_STATS_BASE );
       pilot_calcStats( p );
       return 0;
    }
@@ -4327,6 +4336,7 @@ static int pilotL_shippropSet( lua_State *L )
       lua_pop( L, 1 );
    }
    lua_pop( L, 1 );
+   pilot_calcStatsDirty( p, PILOT_STATS_BASE );
    pilot_calcStats( p );
    return 0;
 }
@@ -4377,6 +4387,7 @@ static int pilotL_effectClear( lua_State *L )
    else
       effect_clearSpecific( &p->effects, !keepdebuffs, !keepbuffs,
                             !keepothers );
+   pilot_calcStatsDirty( p, PILOT_STATS_EFFECTS );
    pilot_calcStats( p );
    return 0;
 }
@@ -4404,8 +4415,11 @@ static int pilotL_effectAdd( lua_State *L )
    if ( !lua_isnoneornil( L, 5 ) )
       applicator = luaL_checkpilot( L, 5 );
    if ( efx != NULL ) {
-      if ( !effect_add( &p->effects, efx, duration, scale, p->id, applicator ) )
+      if ( !effect_add( &p->effects, efx, duration, scale, p->id,
+                        applicator ) ) {
+         pilot_calcStatsDirty( p, PILOT_STATS_EFFECTS );
          pilot_calcStats( p );
+      }
       lua_pushboolean( L, 1 );
    } else
       lua_pushboolean( L, 0 );
@@ -4427,15 +4441,19 @@ static int pilotL_effectRm( lua_State *L )
    Pilot *p = luaL_validpilot( L, 1 );
    if ( lua_isnumber( L, 2 ) ) {
       int idx = lua_tointeger( L, 2 );
-      if ( effect_rm( &p->effects, idx ) )
+      if ( effect_rm( &p->effects, idx ) ) {
+         pilot_calcStatsDirty( p, PILOT_STATS_EFFECTS );
          pilot_calcStats( p );
+      }
    } else {
       const char       *effectname = luaL_checkstring( L, 2 );
       int               all        = lua_toboolean( L, 3 );
       const EffectData *efx        = effect_get( effectname );
       if ( efx != NULL ) {
-         if ( effect_rmType( &p->effects, efx, all ) )
+         if ( effect_rmType( &p->effects, efx, all ) ) {
+            pilot_calcStatsDirty( p, PILOT_STATS_EFFECTS );
             pilot_calcStats( p );
+         }
       }
    }
    return 0;
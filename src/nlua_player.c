@@ -2753,7 +2753,12 @@ static int playerL_saveBackup( lua_State *L )
    snprintf( file, sizeof( file ), "saves/%s/autosave.ns", player.name );
    snprintf( backup, sizeof( backup ), "saves/%s/%s.ns", player.name,
              filename );
-   lua_pushboolean( L, ndata_copyIfExists( file, backup ) );
+   /* The autosave may still be being written in the background. */
+   if ( save_wait() < 0 ) {
+      lua_pushboolean( L, 0 );
+      return 1;
+   }
+   lua_pushboolean( L, ndata_copyIfExists( file, backup ) == 0 );
    return 1;
 }
 
@@ -9,11 +9,31 @@
 #include "nxml.h"
 #include <inttypes.h>
 
+#include "physfs.h"
 #include <ctype.h>
 #include <inttypes.h>
+#include <zlib.h>
 
 #include "ndata.h"
 
+#define XML_STREAM_CHUNK 16384 /**< Size of the chunks to read from files. */
+
+/**
+ * @brief Input stream for libxml2, reading a PhysFS file and decompressing
+ * it if necessary.
+ */
+typedef struct XMLStream_ {
+   PHYSFS_File  *file;                  /**< File being read. */
+   int           gzip;                  /**< Whether the file is gzipped. */
+   int           done;                  /**< Whether the stream is done. */
+   z_stream      strm;                  /**< zlib stream for gzipped files. */
+   unsigned char in[XML_STREAM_CHUNK]; /**< Compressed input buffer. */
+} XMLStream;
+
+static XMLStream *xml_streamOpen( const char *filename );
+static int        xml_streamRead( void *ctx, char *buf, int len );
+static int        xml_streamClose( void *ctx );
+
 /**
  * @brief Parses a texture handling the sx and sy elements.
  *
@@ -95,6 +115,115 @@ xmlDocPtr xml_parsePhysFS( const char *filename )
    return doc;
 }
 
+/**
+ * @brief Opens a PhysFS file for streaming into libxml2.
+ *
+ * Gzipped files are detected by their magic bytes and decompressed on the
+ * fly, anything else is passed through as is.
+ */
+static XMLStream *xml_streamOpen( const char *filename )
+{
+   XMLStream    *s;
+   unsigned char magic[2];
+   PHYSFS_File  *file = PHYSFS_openRead( filename );
+   if ( file == NULL ) {
+      WARN( _( "Unable to open file '%s': %s" ), filename,
+            _( PHYSFS_getErrorByCode( PHYSFS_getLastErrorCode() ) ) );
+      return NULL;
+   }
+
+   s       = calloc( 1, sizeof( XMLStream ) );
+   s->file = file;
+   s->gzip = ( PHYSFS_readBytes( file, magic, sizeof( magic ) ) ==
+               sizeof( magic ) ) &&
+             ( magic[0] == 0x1f ) && ( magic[1] == 0x8b );
+   PHYSFS_seek( file, 0 );
+   if ( s->gzip && ( inflateInit2( &s->strm, 15 + 16 ) != Z_OK ) ) {
+      WARN( _( "Unable to decompress file '%s'" ), filename );
+      PHYSFS_close( file );
+      free( s );
+      return NULL;
+   }
+   return s;
+}
+
+/**
+ * @brief Read callback for libxml2 input streams.
+ */
+static int xml_streamRead( void *ctx, char *buf, int len )
+{
+   XMLStream *s = ctx;
+
+   if ( s->done )
+      return 0;
+   if ( !s->gzip )
+      return PHYSFS_readBytes( s->file, buf, len );
+
+   s->strm.next_out  = (unsigned char *)buf;
+   s->strm.avail_out = len;
+   while ( s->strm.avail_out > 0 ) {
+      int ret;
+      if ( s->strm.avail_in == 0 ) {
+         PHYSFS_sint64 n = PHYSFS_readBytes( s->file, s->in, sizeof( s->in ) );
+         if ( n < 0 )
+            return -1;
+         if ( n == 0 ) /* Truncated, let the parser complain. */
+            break;
+         s->strm.next_in  = s->in;
+         s->strm.avail_in = n;
+      }
+      ret = inflate( &s->strm, Z_NO_FLUSH );
+      if ( ret == Z_STREAM_END ) {
+         s->done = 1;
+         break;
+      } else if ( ret != Z_OK )
+         return -1;
+   }
+   return len - s->strm.avail_out;
+}
+
+/**
+ * @brief Close callback for libxml2 input streams.
+ */
+static int xml_streamClose( void *ctx )
+{
+   XMLStream *s = ctx;
+   if ( s->gzip )
+      inflateEnd( &s->strm );
+   PHYSFS_close( s->file );
+   free( s );
+   return 0;
+}
+
+/**
+ * @brief Parses a file without reading it all into memory first, transparently
+ * decompressing it if it is gzipped (like .ns files).
+ * @param filename PhysFS file name.
+ * @return doc (must xmlFreeDoc) on success, NULL on failure.
+ */
+xmlDocPtr xml_parseStream( const char *filename )
+{
+   XMLStream *s = xml_streamOpen( filename );
+   if ( s == NULL )
+      return NULL;
+   return xmlReadIO( xml_streamRead, xml_streamClose, s, filename, NULL, 0 );
+}
+
+/**
+ * @brief Opens a file for reading with a streaming xmlTextReader,
+ * transparently decompressing it if it is gzipped.
+ * @param filename PhysFS file name.
+ * @return reader (must xmlFreeTextReader) on success, NULL on failure.
+ */
+xmlTextReaderPtr xml_readerStream( const char *filename )
+{
+   XMLStream *s = xml_streamOpen( filename );
+   if ( s == NULL )
+      return NULL;
+   return xmlReaderForIO( xml_streamRead, xml_streamClose, s, filename, NULL,
+                          0 );
+}
+
 int xmlw_saveTime( xmlTextWriterPtr writer, const char *name, time_t t )
 {
    xmlw_elem( writer, name, "%lld", (long long)t );
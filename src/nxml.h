@@ -16,6 +16,7 @@
 #endif
 
 #include "libxml/parser.h"    // IWYU pragma: export
+#include "libxml/xmlreader.h" // IWYU pragma: export
 #include "libxml/xmlwriter.h" // IWYU pragma: export
 #include <stdlib.h>
 /** @endcond */
@@ -279,6 +280,8 @@ static inline char *nxml_trace_strdup( void *ptr )
  * Functions for generic complex reading.
  */
 xmlDocPtr             xml_parsePhysFS( const char *filename );
+xmlDocPtr             xml_parseStream( const char *filename );
+xmlTextReaderPtr      xml_readerStream( const char *filename );
 USE_RESULT glTexture *xml_parseTexture( xmlNodePtr node, const char *path,
                                         int defsx, int defsy,
                                         const unsigned int flags );
@@ -29,10 +29,24 @@
 
 #include "opengl_render.h"
 
+#include "array.h"
 #include "camera.h"
 #include "opengl.h"
 
 #define OPENGL_RENDER_VBO_SIZE 256 /**< Size of VBO. */
+#define GL_BATCH_FLOATS 13 /**< Floats per batched sprite. */
+
+/**
+ * @brief A sprite queued by the sprite batcher.
+ */
+typedef struct glBatchSprite_ {
+   GLuint  ta;  /**< Texture A. */
+   GLuint  tb;  /**< Texture B, same as A if not interpolating. */
+   GLuint  sa;  /**< Sampler of texture A. */
+   GLuint  sb;  /**< Sampler of texture B. */
+   GLfloat data[GL_BATCH_FLOATS]; /**< Instance data: rect, tex_rect, colour
+                                     and inter. */
+} glBatchSprite;
 
 static gl_vbo *gl_renderVBO          = 0; /**< VBO for rendering stuff. */
 gl_vbo        *gl_squareVBO          = 0;
@@ -43,6 +57,17 @@ static gl_vbo *gl_triangleVBO        = 0;
 static int     gl_renderVBOtexOffset = 0; /**< VBO texture offset. */
 static int     gl_renderVBOcolOffset = 0; /**< VBO colour offset. */
 
+/* Sprite batcher. */
+static int            gl_batchActive   = 0; /**< Whether sprites are batched. */
+static glBatchSprite *gl_batchSprites  = NULL; /**< Queued sprites. */
+static GLfloat       *gl_batchData     = NULL; /**< Instance upload buffer. */
+static GLsizei        gl_batchDataSize = 0;    /**< Size of gl_batchData. */
+static gl_vbo        *gl_batchVBO      = NULL; /**< Streaming instance VBO. */
+static glRenderStats  gl_render_stats;         /**< Draw call counters. */
+
+/* Simple shader batcher. */
+static gl_vbo *gl_shaderBatchVBO = NULL; /**< Streaming instance VBO. */
+
 void gl_beginSolidProgram( mat4 projection, const glColour *c )
 {
    glUseProgram( shaders.solid.program );
@@ -368,6 +393,7 @@ void gl_renderTextureRawH( GLuint texture, GLuint sampler,
 
    /* Draw. */
    glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+   gl_render_stats.draws++;
 
    /* Clear state. */
    glDisableVertexAttribArray( shaders.texture.vertex );
@@ -580,6 +606,7 @@ void gl_renderTextureInterpolateRawH( GLuint ta, GLuint tb, GLuint sa,
 
    /* Draw. */
    glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+   gl_render_stats.draws++;
 
    /* Clear state. */
    glDisableVertexAttribArray( shaders.texture_interpolate.vertex );
@@ -923,6 +950,270 @@ void gl_renderSpriteInterpolateScale( const glTexture *sa, const glTexture *sb,
                                 tex_srw( sa ), tex_srh( sa ), c );
 }
 
+/**
+ * @brief Starts batching sprites.
+ *
+ * Until gl_batchEnd() is called, the gl_batchSprite* functions queue sprites
+ * instead of drawing them. They are drawn in the order they were queued, with
+ * one instanced draw call per run of sprites sharing textures. Anything drawn
+ * directly in between has to call gl_batchFlush() first to keep the order.
+ */
+void gl_batchBegin( void )
+{
+   gl_batchActive = 1;
+}
+
+/**
+ * @brief Checks to see if two batched sprites can be drawn together.
+ */
+static int gl_batchSame( const glBatchSprite *b1, const glBatchSprite *b2 )
+{
+   return ( b1->ta == b2->ta ) && ( b1->tb == b2->tb ) &&
+          ( b1->sa == b2->sa ) && ( b1->sb == b2->sb );
+}
+
+/**
+ * @brief Draws all the queued sprites.
+ */
+void gl_batchFlush( void )
+{
+   int     n = array_size( gl_batchSprites );
+   GLsizei size, stride;
+
+   if ( n <= 0 )
+      return;
+
+   /* Upload the instance data, keeping the order they were queued in. */
+   stride = sizeof( GLfloat ) * GL_BATCH_FLOATS;
+   size   = stride * n;
+   if ( size > gl_batchDataSize ) {
+      gl_batchDataSize = size;
+      gl_batchData     = realloc( gl_batchData, size );
+   }
+   for ( int i = 0; i < n; i++ )
+      memcpy( &gl_batchData[i * GL_BATCH_FLOATS], gl_batchSprites[i].data,
+              stride );
+   gl_vboData( gl_batchVBO, size, gl_batchData );
+
+   glUseProgram( shaders.texture_batch.program );
+   gl_uniformMat4( shaders.texture_batch.projection, &gl_view_matrix );
+   glUniform1i( shaders.texture_batch.sampler1, 0 );
+   glUniform1i( shaders.texture_batch.sampler2, 1 );
+
+   /* Set up the vertices. */
+   glEnableVertexAttribArray( shaders.texture_batch.vertex );
+   glEnableVertexAttribArray( shaders.texture_batch.rect );
+   glEnableVertexAttribArray( shaders.texture_batch.tex_rect );
+   glEnableVertexAttribArray( shaders.texture_batch.colour );
+   glEnableVertexAttribArray( shaders.texture_batch.inter );
+   gl_vboActivateAttribOffset( gl_squareVBO, shaders.texture_batch.vertex, 0,
+                               2, GL_FLOAT, 0 );
+   glVertexAttribDivisor( shaders.texture_batch.rect, 1 );
+   glVertexAttribDivisor( shaders.texture_batch.tex_rect, 1 );
+   glVertexAttribDivisor( shaders.texture_batch.colour, 1 );
+   glVertexAttribDivisor( shaders.texture_batch.inter, 1 );
+
+   /* One draw call per run of sprites with the same textures. */
+   for ( int i = 0; i < n; ) {
+      const glBatchSprite *b = &gl_batchSprites[i];
+      GLuint               offset;
+      int                  j = i + 1;
+      while ( ( j < n ) && gl_batchSame( b, &gl_batchSprites[j] ) )
+         j++;
+
+      /* Bind the textures. */
+      glActiveTexture( GL_TEXTURE1 );
+      glBindTexture( GL_TEXTURE_2D, b->tb );
+      if ( b->sb > 0 )
+         glBindSampler( 1, b->sb );
+      glActiveTexture( GL_TEXTURE0 );
+      glBindTexture( GL_TEXTURE_2D, b->ta );
+      if ( b->sa > 0 )
+         glBindSampler( 0, b->sa );
+
+      /* Point the instance attributes at the run. */
+      offset = stride * i;
+      gl_vboActivateAttribOffset( gl_batchVBO, shaders.texture_batch.rect,
+                                  offset, 4, GL_FLOAT, stride );
+      gl_vboActivateAttribOffset( gl_batchVBO, shaders.texture_batch.tex_rect,
+                                  offset + sizeof( GLfloat ) * 4, 4, GL_FLOAT,
+                                  stride );
+      gl_vboActivateAttribOffset( gl_batchVBO, shaders.texture_batch.colour,
+                                  offset + sizeof( GLfloat ) * 8, 4, GL_FLOAT,
+                                  stride );
+      gl_vboActivateAttribOffset( gl_batchVBO, shaders.texture_batch.inter,
+                                  offset + sizeof( GLfloat ) * 12, 1, GL_FLOAT,
+                                  stride );
+
+      /* Draw. */
+      glDrawArraysInstanced( GL_TRIANGLE_STRIP, 0, 4, j - i );
+      gl_render_stats.draws++;
+      gl_render_stats.batches++;
+
+      if ( b->sb > 0 )
+         glBindSampler( 1, 0 );
+      if ( b->sa > 0 )
+         glBindSampler( 0, 0 );
+      i = j;
+   }
+   gl_render_stats.sprites += n;
+
+   /* Clear state. */
+   glVertexAttribDivisor( shaders.texture_batch.rect, 0 );
+   glVertexAttribDivisor( shaders.texture_batch.tex_rect, 0 );
+   glVertexAttribDivisor( shaders.texture_batch.colour, 0 );
+   glVertexAttribDivisor( shaders.texture_batch.inter, 0 );
+   glDisableVertexAttribArray( shaders.texture_batch.vertex );
+   glDisableVertexAttribArray( shaders.texture_batch.rect );
+   glDisableVertexAttribArray( shaders.texture_batch.tex_rect );
+   glDisableVertexAttribArray( shaders.texture_batch.colour );
+   glDisableVertexAttribArray( shaders.texture_batch.inter );
+   glActiveTexture( GL_TEXTURE1 );
+   glBindTexture( GL_TEXTURE_2D, 0 );
+   glActiveTexture( GL_TEXTURE0 );
+   glBindTexture( GL_TEXTURE_2D, 0 );
+   glUseProgram( 0 );
+
+   /* anything failed? */
+   gl_checkErr();
+
+   array_erase( &gl_batchSprites, array_begin( gl_batchSprites ),
+                array_end( gl_batchSprites ) );
+}
+
+/**
+ * @brief Draws the queued sprites and stops batching.
+ */
+void gl_batchEnd( void )
+{
+   gl_batchFlush();
+   gl_batchActive = 0;
+}
+
+/**
+ * @brief Queues a textured quad, same as gl_renderTextureInterpolate().
+ */
+static void gl_batchTexture( const glTexture *ta, const glTexture *tb,
+                             double inter, double x, double y, double w,
+                             double h, double tx, double ty, double tw,
+                             double th, const glColour *c )
+{
+   glBatchSprite *b;
+
+   /* Case no need for interpolation. */
+   if ( tb == NULL ) {
+      tb    = ta;
+      inter = 1.;
+   } else if ( ta == NULL ) {
+      ta    = tb;
+      inter = 1.;
+   }
+
+   /* Must have colour for now. */
+   if ( c == NULL )
+      c = &cWhite;
+
+   b           = &array_grow( &gl_batchSprites );
+   b->ta       = tex_tex( ta );
+   b->tb       = tex_tex( tb );
+   b->sa       = tex_sampler( ta );
+   b->sb       = tex_sampler( tb );
+   b->data[0]  = x;
+   b->data[1]  = y;
+   b->data[2]  = w;
+   b->data[3]  = h;
+   b->data[4]  = tx;
+   b->data[5]  = ty;
+   b->data[6]  = tw;
+   b->data[7]  = th;
+   b->data[8]  = c->r;
+   b->data[9]  = c->g;
+   b->data[10] = c->b;
+   b->data[11] = c->a;
+   b->data[12] = inter;
+}
+
+/**
+ * @brief Batched version of gl_renderSpriteInterpolateScale().
+ *
+ * Draws right away if not between gl_batchBegin() and gl_batchEnd().
+ *
+ *    @param sa Sprite A to blit.
+ *    @param sb Sprite B to blit.
+ *    @param inter Amount to interpolate.
+ *    @param bx X position of the texture relative to the player.
+ *    @param by Y position of the texture relative to the player.
+ *    @param scalew X scale factor.
+ *    @param scaleh Y scale factor.
+ *    @param sx X position of the sprite to use.
+ *    @param sy Y position of the sprite to use.
+ *    @param c Colour to use (modifies texture colour).
+ */
+void gl_batchSpriteInterpolateScale( const glTexture *sa, const glTexture *sb,
+                                     double inter, double bx, double by,
+                                     double scalew, double scaleh, int sx,
+                                     int sy, const glColour *c )
+{
+   double x, y, w, h, tx, ty, z;
+
+   if ( !gl_batchActive ) {
+      gl_renderSpriteInterpolateScale( sa, sb, inter, bx, by, scalew, scaleh,
+                                       sx, sy, c );
+      return;
+   }
+
+   /* Translate coords. */
+   gl_gameToScreenCoords( &x, &y, bx - scalew * tex_sw( sa ) * 0.5,
+                          by - scaleh * tex_sh( sa ) * 0.5 );
+
+   /* Scaled sprite dimensions. */
+   z = cam_getZoom();
+   w = tex_sw( sa ) * z * scalew;
+   h = tex_sh( sa ) * z * scaleh;
+
+   /* check if inbounds */
+   if ( ( x < -w ) || ( x > SCREEN_W + w ) || ( y < -h ) ||
+        ( y > SCREEN_H + h ) )
+      return;
+
+   /* texture coords */
+   tx = tex_sw( sa ) * (double)( sx ) / tex_w( sa );
+   ty = tex_sh( sa ) * ( tex_sy( sa ) - (double)sy - 1 ) / tex_h( sa );
+
+   gl_batchTexture( sa, sb, inter, x, y, w, h, tx, ty, tex_srw( sa ),
+                    tex_srh( sa ), c );
+}
+
+/**
+ * @brief Batched version of gl_renderSpriteInterpolate().
+ */
+void gl_batchSpriteInterpolate( const glTexture *sa, const glTexture *sb,
+                                double inter, double bx, double by, int sx,
+                                int sy, const glColour *c )
+{
+   gl_batchSpriteInterpolateScale( sa, sb, inter, bx, by, 1., 1., sx, sy, c );
+}
+
+/**
+ * @brief Batched version of gl_renderSprite().
+ */
+void gl_batchSprite( const glTexture *sprite, double bx, double by, int sx,
+                     int sy, const glColour *c )
+{
+   gl_batchSpriteInterpolateScale( sprite, NULL, 1., bx, by, 1., 1., sx, sy,
+                                   c );
+}
+
+/**
+ * @brief Gets the draw call counters of the renderer.
+ *
+ *    @param[out] stats Where to store the counters.
+ */
+void gl_renderStats( glRenderStats *stats )
+{
+   *stats = gl_render_stats;
+}
+
 /**
  * @brief Blits a sprite, position is in absolute screen coordinates.
  *
@@ -1243,6 +1534,80 @@ void gl_renderShaderH( const SimpleShader *shd, const mat4 *H,
    gl_checkErr();
 }
 
+/**
+ * @brief Renders many centered instances of a simple shader at once.
+ *
+ * Each instance is GL_SHADER_BATCH_FLOATS floats: position, rotation, size and
+ * colour, as passed to gl_renderShader(). Shaders without an instanced variant
+ * are drawn one at a time.
+ *
+ *    @param shd Shader to render.
+ *    @param data Instance data.
+ *    @param n Number of instances.
+ *    @param dt Value to set the dt uniform to.
+ */
+void gl_renderShaderBatch( const SimpleShader *shd, const GLfloat *data, int n,
+                           double dt )
+{
+   GLsizei stride = sizeof( GLfloat ) * GL_SHADER_BATCH_FLOATS;
+
+   if ( n <= 0 )
+      return;
+
+   /* Fallback. */
+   if ( shd->batch.program == 0 ) {
+      for ( int i = 0; i < n; i++ ) {
+         const GLfloat *d = &data[i * GL_SHADER_BATCH_FLOATS];
+         const glColour c = { .r = d[5], .g = d[6], .b = d[7], .a = d[8] };
+         glUseProgram( shd->program );
+         glUniform1f( shd->dt, dt );
+         gl_renderShader( d[0], d[1], d[3], d[4], d[2], shd, &c, 1 );
+      }
+      return;
+   }
+
+   gl_vboData( gl_shaderBatchVBO, stride * n, data );
+
+   glUseProgram( shd->batch.program );
+   gl_uniformMat4( shd->batch.projection, &gl_view_matrix );
+   glUniform1f( shd->batch.dt, dt );
+
+   /* Set up the vertices. */
+   glEnableVertexAttribArray( shd->batch.vertex );
+   glEnableVertexAttribArray( shd->batch.centre );
+   glEnableVertexAttribArray( shd->batch.size );
+   glEnableVertexAttribArray( shd->batch.tint );
+   gl_vboActivateAttribOffset( gl_circleVBO, shd->batch.vertex, 0, 2, GL_FLOAT,
+                               0 );
+   gl_vboActivateAttribOffset( gl_shaderBatchVBO, shd->batch.centre, 0, 3,
+                               GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( gl_shaderBatchVBO, shd->batch.size,
+                               sizeof( GLfloat ) * 3, 2, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( gl_shaderBatchVBO, shd->batch.tint,
+                               sizeof( GLfloat ) * 5, 4, GL_FLOAT, stride );
+   glVertexAttribDivisor( shd->batch.centre, 1 );
+   glVertexAttribDivisor( shd->batch.size, 1 );
+   glVertexAttribDivisor( shd->batch.tint, 1 );
+
+   /* Draw. */
+   glDrawArraysInstanced( GL_TRIANGLE_STRIP, 0, 4, n );
+   gl_render_stats.shape_batches++;
+   gl_render_stats.shapes += n;
+
+   /* Clear state. */
+   glVertexAttribDivisor( shd->batch.centre, 0 );
+   glVertexAttribDivisor( shd->batch.size, 0 );
+   glVertexAttribDivisor( shd->batch.tint, 0 );
+   glDisableVertexAttribArray( shd->batch.vertex );
+   glDisableVertexAttribArray( shd->batch.centre );
+   glDisableVertexAttribArray( shd->batch.size );
+   glDisableVertexAttribArray( shd->batch.tint );
+   glUseProgram( 0 );
+
+   /* anything failed? */
+   gl_checkErr();
+}
+
 /**
  * @brief Draws a circle.
  *
@@ -1399,6 +1764,13 @@ int gl_initRender( void )
    gl_triangleVBO = gl_vboCreateStatic( sizeof( GLfloat ) * 8, vertex );
    gl_vboLabel( gl_triangleVBO, "C Triangle VBO" );
 
+   /* Sprite batcher. */
+   gl_batchSprites = array_create( glBatchSprite );
+   gl_batchVBO     = gl_vboCreateStream( 0, NULL );
+   gl_vboLabel( gl_batchVBO, "C Sprite Batch VBO" );
+   gl_shaderBatchVBO = gl_vboCreateStream( 0, NULL );
+   gl_vboLabel( gl_shaderBatchVBO, "C Shader Batch VBO" );
+
    gl_checkErr();
 
    return 0;
@@ -1416,5 +1788,16 @@ void gl_exitRender( void )
    gl_vboDestroy( gl_squareEmptyVBO );
    gl_vboDestroy( gl_lineVBO );
    gl_vboDestroy( gl_triangleVBO );
-   gl_renderVBO = NULL;
+   gl_vboDestroy( gl_batchVBO );
+   gl_vboDestroy( gl_shaderBatchVBO );
+   gl_renderVBO      = NULL;
+   gl_batchVBO       = NULL;
+   gl_shaderBatchVBO = NULL;
+
+   /* Clean up the sprite batcher. */
+   array_free( gl_batchSprites );
+   gl_batchSprites = NULL;
+   free( gl_batchData );
+   gl_batchData     = NULL;
+   gl_batchDataSize = 0;
 }
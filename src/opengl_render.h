@@ -9,6 +9,21 @@
 #include "opengl_vbo.h"
 #include "shaders.gen.h"
 
+#define GL_SHADER_BATCH_FLOATS                                                 \
+   9 /**< Floats per instance of gl_renderShaderBatch(): x, y, angle, w, h and \
+        colour. */
+
+/**
+ * @brief Draw call counters of the renderer.
+ */
+typedef struct glRenderStats_ {
+   uint64_t draws;         /**< Textured quad draw calls, including batches. */
+   uint64_t batches;       /**< Instanced draw calls of the sprite batcher. */
+   uint64_t sprites;       /**< Sprites drawn by the sprite batcher. */
+   uint64_t shape_batches; /**< Instanced draw calls of simple shaders. */
+   uint64_t shapes;        /**< Shapes drawn by those calls. */
+} glRenderStats;
+
 /*
  * Init/cleanup.
  */
@@ -57,6 +72,20 @@ void gl_renderTextureInterpolate( const glTexture *ta, const glTexture *tb,
                                   double inter, double x, double y, double w,
                                   double h, double tx, double ty, double tw,
                                   double th, const glColour *c );
+/* batches sprites, relative pos */
+void gl_batchBegin( void );
+void gl_batchFlush( void );
+void gl_batchEnd( void );
+void gl_batchSprite( const glTexture *sprite, double bx, double by, int sx,
+                     int sy, const glColour *c );
+void gl_batchSpriteInterpolate( const glTexture *sa, const glTexture *sb,
+                                double inter, double bx, double by, int sx,
+                                int sy, const glColour *c );
+void gl_batchSpriteInterpolateScale( const glTexture *sa, const glTexture *sb,
+                                     double inter, double bx, double by,
+                                     double scalew, double scaleh, int sx,
+                                     int sy, const glColour *c );
+void gl_renderStats( glRenderStats *stats );
 /* blits a sprite, relative pos */
 void gl_renderSprite( const glTexture *sprite, double bx, double by, int sx,
                       int sy, const glColour *c );
@@ -117,6 +146,8 @@ void gl_renderShader( double x, double y, double w, double h, double r,
                       const SimpleShader *shd, const glColour *c, int center );
 void gl_renderShaderH( const SimpleShader *shd, const mat4 *H,
                        const glColour *c, int center );
+void gl_renderShaderBatch( const SimpleShader *shd, const GLfloat *data, int n,
+                           double dt );
 
 /* Circles. */
 void gl_renderCircle( double x, double y, double r, const glColour *c,
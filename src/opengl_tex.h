@@ -35,6 +35,22 @@
 struct glTexture;
 typedef struct glTexture glTexture;
 
+struct glTexRequest;
+typedef struct glTexRequest glTexRequest;
+
+/**
+ * @brief Statistics of the shared texture data cache.
+ */
+typedef struct glTexCacheStats_ {
+   uint64_t hits;      /**< Lookups that found a loaded texture. */
+   uint64_t misses;    /**< Lookups that found nothing. */
+   uint64_t inserts;   /**< Textures added to the cache. */
+   uint64_t evictions; /**< Dead references removed from the cache. */
+   uint64_t names;     /**< Number of different names in the cache. */
+   uint64_t entries;   /**< Number of cache entries (including dead ones). */
+   uint64_t live;      /**< Number of cache entries still in use. */
+} glTexCacheStats;
+
 /*
  * Init/exit.
  */
@@ -61,6 +77,16 @@ glTexture *gl_resizeTexture( const glTexture *texture, double scale );
 USE_RESULT glTexture *gl_rawTexture( const char *name, GLuint tex, double w,
                                      double h );
 
+/*
+ * Background loading.
+ */
+USE_RESULT glTexRequest *gl_texRequest( const char *path, unsigned int flags,
+                                        int sx, int sy );
+USE_RESULT glTexRequest *gl_texRequestDup( const glTexRequest *req );
+int                      gl_texRequestDone( const glTexRequest *req );
+USE_RESULT glTexture    *gl_texRequestGet( const glTexRequest *req );
+void                     gl_texRequestFree( glTexRequest *req );
+
 /*
  * Clean up.
  */
@@ -81,6 +107,7 @@ int         gl_isTrans( const glTexture *t, const int x, const int y );
 void        gl_getSpriteFromDir( int *x, int *y, int sx, int sy, double dir );
 glTexture **gl_copyTexArray( const glTexture **tex );
 glTexture **gl_addTexArray( glTexture **tex, glTexture *t );
+void        gl_texCacheStats( glTexCacheStats *stats );
 
 /* Transition getters. */
 const char *tex_name( const glTexture *tex );
@@ -64,6 +64,8 @@ typedef struct OutfitThreadData_ {
  */
 static Outfit *outfit_stack  = NULL; /**< Stack of outfits. */
 static char  **license_stack = NULL; /**< Stack of available licenses. */
+static unsigned int outfit_gfxStoreClock =
+   0; /**< Clock used to track store graphic usage. */
 
 /*
  * Helper stuff for setting up short descriptions for outfits.
@@ -95,6 +97,8 @@ static void outfit_parseSLicense( Outfit *temp, const xmlNodePtr parent );
 static int  outfit_loadPLG( Outfit *temp, const char *buf );
 static int  outfit_loadGFX( Outfit *temp, const xmlNodePtr node );
 static void sdesc_miningRarity( int *l, Outfit *temp, int rarity );
+static size_t outfit_gfxStoreMem( const Outfit *o );
+static int    outfit_cmpGfxStoreUsed( const void *p1, const void *p2 );
 /* Display */
 
 typedef struct s_Outfitstat {
@@ -224,6 +228,82 @@ int outfit_gfxStoreLoad( Outfit *o )
    return 0;
 }
 
+/**
+ * @brief Estimates the memory used by the store graphic of an outfit.
+ */
+static size_t outfit_gfxStoreMem( const Outfit *o )
+{
+   if ( o->gfx_store == NULL )
+      return 0;
+   /* RGBA with mipmaps, which add about a third on top. */
+   return (size_t)( tex_w( o->gfx_store ) * tex_h( o->gfx_store ) * 4. * 4. /
+                    3. );
+}
+
+/**
+ * @brief Sorts outfits by least recently used store graphic.
+ */
+static int outfit_cmpGfxStoreUsed( const void *p1, const void *p2 )
+{
+   const Outfit *o1 = *(const Outfit **)p1;
+   const Outfit *o2 = *(const Outfit **)p2;
+   if ( o1->gfx_store_used < o2->gfx_store_used )
+      return -1;
+   else if ( o1->gfx_store_used > o2->gfx_store_used )
+      return +1;
+   return 0;
+}
+
+/**
+ * @brief Frees the least recently used store graphics until they fit in the
+ * memory budget set by conf.outfit_gfx_budget.
+ *
+ * Graphics are loaded again on demand by outfit_gfxStore(), and anything still
+ * displaying them holds its own reference, so this is safe to call whenever
+ * the store windows are not being generated.
+ */
+void outfit_gfxStoreGC( void )
+{
+   size_t   budget, total;
+   int      nfreed;
+   Outfit **loaded;
+
+   if ( conf.outfit_gfx_budget <= 0 )
+      return;
+   budget = (size_t)conf.outfit_gfx_budget * 1024 * 1024;
+
+   total  = 0;
+   loaded = array_create( Outfit * );
+   for ( int i = 0; i < array_size( outfit_stack ); i++ ) {
+      Outfit *o = &outfit_stack[i];
+      if ( o->gfx_store == NULL )
+         continue;
+      total += outfit_gfxStoreMem( o );
+      array_push_back( &loaded, o );
+   }
+
+   nfreed = 0;
+   if ( total > budget ) {
+      qsort( loaded, array_size( loaded ), sizeof( Outfit * ),
+             outfit_cmpGfxStoreUsed );
+      for ( int i = 0; ( i < array_size( loaded ) ) && ( total > budget );
+            i++ ) {
+         Outfit *o = loaded[i];
+         total -= outfit_gfxStoreMem( o );
+         gl_freeTexture( o->gfx_store );
+         o->gfx_store = NULL;
+         nfreed++;
+      }
+   }
+   array_free( loaded );
+
+   if ( nfreed > 0 )
+      DEBUG( n_( "Freed %d outfit store graphic (%.1f MiB still loaded)",
+                 "Freed %d outfit store graphics (%.1f MiB still loaded)",
+                 nfreed ),
+             nfreed, (double)total / ( 1024. * 1024. ) );
+}
+
 /**
  * @brief Gets an outfit by name.
  *
@@ -863,9 +943,15 @@ const OutfitGFX *outfit_gfx( const Outfit *o )
       return &o->u.lau.gfx;
    return NULL;
 }
+/**
+ * @brief Gets the store graphic of an outfit, loading it if necessary.
+ *    @param o Outfit to get information from.
+ */
 const glTexture *outfit_gfxStore( const Outfit *o )
 {
-   outfit_gfxStoreLoad( (Outfit *)o );
+   Outfit *ow = (Outfit *)o;
+   outfit_gfxStoreLoad( ow );
+   ow->gfx_store_used = ++outfit_gfxStoreClock;
    return o->gfx_store;
 }
 const glTexture **outfit_gfxOverlays( const Outfit *o )
@@ -888,6 +974,10 @@ const ShipStatList *outfit_stats( const Outfit *o )
 {
    return o->stats;
 }
+const ShipStatVec *outfit_statsVec( const Outfit *o )
+{
+   return o->stats_vec;
+}
 /**
  * @brief Gets the outfit's sound effect.
  *    @param o Outfit to get information from.
@@ -3565,6 +3655,12 @@ int outfit_load( void )
                outfit_stack[i].name );
 #endif /* DEBUGGING */
 
+   /* Precompile stats. */
+   for ( int i = 0; i < noutfits; i++ ) {
+      Outfit *o    = &outfit_stack[i];
+      o->stats_vec = ss_vecFromList( o->stats );
+   }
+
    /* Second pass. */
    for ( int i = 0; i < noutfits; i++ ) {
       Outfit *o = &outfit_stack[i];
@@ -3912,6 +4008,7 @@ void outfit_free( void )
       outfit_freeSlot( &o->slot );
 
       /* Free stats. */
+      ss_vecFree( o->stats_vec );
       ss_free( o->stats );
 
       /* Free illegality. */
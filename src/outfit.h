@@ -381,12 +381,15 @@ typedef struct Outfit {
 
    char       *gfx_store_path; /**< Store graphic path. */
    glTexture  *gfx_store;      /**< Store graphic. */
+   unsigned int
+      gfx_store_used; /**< Last use of the store graphic (for LRU eviction). */
    glTexture **gfx_overlays;   /**< Array (array.h): Store overlay graphics. */
 
    unsigned int properties; /**< Properties stored bitwise. */
 
    /* Stats. */
-   ShipStatList *stats; /**< Stat list. */
+   ShipStatList *stats;     /**< Stat list. */
+   ShipStatVec  *stats_vec; /**< Precompiled stat list. */
 
    /* Tags. */
    char **tags; /**< Outfit tags. */
@@ -454,6 +457,7 @@ typedef struct Outfit {
 int            outfit_gfxStoreLoaded( const Outfit *o );
 int            outfit_gfxStoreLoadNeeded( void );
 int            outfit_gfxStoreLoad( Outfit *o );
+void           outfit_gfxStoreGC( void );
 const Outfit  *outfit_get( const char *name );
 const Outfit  *outfit_getW( const char *name );
 const Outfit **outfit_getAll( void );
@@ -574,6 +578,7 @@ const glTexture    *outfit_gfxStore( const Outfit *o );
 const glTexture   **outfit_gfxOverlays( const Outfit *o );
 const CollPoly     *outfit_plg( const Outfit *o );
 const ShipStatList *outfit_stats( const Outfit *o );
+const ShipStatVec  *outfit_statsVec( const Outfit *o );
 int                 outfit_spfxArmour( const Outfit *o );
 int                 outfit_spfxShield( const Outfit *o );
 const Damage       *outfit_damage( const Outfit *o );
@@ -55,6 +55,11 @@ static Pilot **pilot_stack =
 static Quadtree pilot_quadtree; /**< Quadtree for the pilots. */
 static IntList  pilot_qtquery;  /**< Quadtree query. */
 static int      qt_init = 0;
+static int      qt_npilots =
+   0; /**< Pilots on the stack when the quadtree was built, later ones are
+           not in it yet. */
+
+static unsigned int *pilot_visible = NULL; /**< IDs of pilots to render. */
 /* A simple grid search procedure was used to determine the following
  * parameters. */
 static int qt_max_elem = 2;
@@ -815,6 +820,42 @@ void pilot_collideQueryIL( IntList *il, int x1, int y1, int x2, int y2 )
    qt_query( &pilot_quadtree, il, x1, y1, x2, y2 );
 }
 
+/**
+ * @brief Gets the stack indices of all the pilots that may be within a radius
+ * of a position.
+ *
+ * Unlike pilot_collideQueryIL, this also includes pilots that were added to
+ * the stack after the quadtree was last built, so it is safe to use from
+ * anywhere. Results are conservative and have to be checked by the caller.
+ *
+ *    @param[out] il List to fill with the indices into pilot_getAll().
+ *    @param x X position to query.
+ *    @param y Y position to query.
+ *    @param r Radius to query.
+ */
+void pilot_nearbyQueryIL( IntList *il, double x, double y, double r )
+{
+   int n = ( qt_init ? MIN( qt_npilots, array_size( pilot_stack ) ) : 0 );
+   if ( n > 0 ) {
+      int m = 0;
+      qt_query( &pilot_quadtree, il, floor( x - r ), floor( y - r ),
+                ceil( x + r ), ceil( y + r ) );
+      /* Pilots created since the last rebuild may already have been inserted
+       * into the quadtree, but they are all added below anyway. Filtering
+       * them here keeps each pilot from being returned twice. */
+      for ( int i = 0; i < il_size( il ); i++ ) {
+         int j = il_get( il, i, 0 );
+         if ( j < n )
+            il_set( il, m++, 0, j );
+      }
+      while ( il_size( il ) > m )
+         il_pop_back( il );
+   } else
+      il_clear( il );
+   for ( int i = n; i < array_size( pilot_stack ); i++ )
+      il_set( il, il_push_back( il ), 0, i );
+}
+
 /**
  * @brief Tries to turn the pilot to face dir.
  *
@@ -1606,6 +1647,7 @@ void pilot_updateDisable( Pilot *p, unsigned int shooter )
       pilot_rmFlag( p, PILOT_COOLDOWN_BRAKE );
       pilot_rmFlag( p, PILOT_BRAKING );
       pilot_rmFlag( p, PILOT_STEALTH );
+      pilot_ewVisClear();
 
       /* Clear hyperspace flags. */
       pilot_rmFlag( p, PILOT_HYP_PREP );
@@ -2051,20 +2093,28 @@ void pilot_render( Pilot *p )
       /* Render normally. */
       if ( e == NULL ) {
          if ( p->ship->gfx_3d != NULL ) {
-            /* Render to framebuffer first. */
-            pilot_renderFramebufferBase( p, gl_screen.fbo[2], gl_screen.nw,
-                                         gl_screen.nh, NULL );
-
-            /* Draw framebuffer with depth on screen. */
-            /* TODO fix this shit. Texture coordinates have to be flipped... */
-            gl_renderTextureDepthRaw(
-               gl_screen.fbo_tex[2], gl_screen.fbo_depth_tex[2], 0,
-               x + ( 1. - scale ) * z * w * 0.5,
-               y + ( 1. - scale ) * z * h * 0.5, w * scale * z, h * scale * z,
-               // 0, 0, w / (double)gl_screen.nw, h / (double)gl_screen.nh,
-               // NULL,
-               0., 0., w / (double)gl_screen.nw, h / (double)gl_screen.nh, NULL,
-               0. ); /* Colour should already be applied. */
+            double rx = x + ( 1. - scale ) * z * w * 0.5;
+            double ry = y + ( 1. - scale ) * z * h * 0.5;
+
+            /* Small ships are drawn from pre-rendered headings if possible. */
+            if ( ship_renderImpostor( p->ship, rx, ry, w * scale * z,
+                                      h * scale * z, p->solid.dir,
+                                      p->engine_glow, p->tilt, &c ) ) {
+               /* Render to framebuffer first. */
+               pilot_renderFramebufferBase( p, gl_screen.fbo[2], gl_screen.nw,
+                                            gl_screen.nh, NULL );
+
+               /* Draw framebuffer with depth on screen. */
+               /* TODO fix this shit. Texture coordinates have to be flipped...
+                */
+               gl_renderTextureDepthRaw(
+                  gl_screen.fbo_tex[2], gl_screen.fbo_depth_tex[2], 0, rx, ry,
+                  w * scale * z, h * scale * z,
+                  // 0, 0, w / (double)gl_screen.nw, h / (double)gl_screen.nh,
+                  // NULL,
+                  0., 0., w / (double)gl_screen.nw, h / (double)gl_screen.nh,
+                  NULL, 0. ); /* Colour should already be applied. */
+            }
          } else {
             gl_renderSpriteInterpolateScale(
                p->ship->gfx_space, p->ship->gfx_engine, 1. - p->engine_glow,
@@ -2727,7 +2777,10 @@ void pilot_update( Pilot *pilot, double dt )
    }
 
    /* Update effects. */
-   nchg += effect_update( &pilot->effects, dt );
+   if ( effect_update( &pilot->effects, dt ) > 0 ) {
+      pilot_calcStatsDirty( pilot, PILOT_STATS_EFFECTS );
+      nchg++;
+   }
    if ( pilot_isFlag( pilot, PILOT_DELETE ) )
       return; /* It's possible for effects to remove the pilot causing future
                  Lua to be unhappy. */
@@ -3637,6 +3690,7 @@ Pilot *pilot_create( const Ship *ship, const char *name, int faction,
       p->id = PLAYER_ID;
       qsort( pilot_stack, array_size( pilot_stack ), sizeof( Pilot * ),
              pilot_cmp );
+      qt_npilots = 0; /* Indices shifted, quadtree is stale. */
    } else
       p->id =
          ++pilot_id; /* new unique pilot id based on pilot_id, can't be 0 */
@@ -4003,6 +4057,8 @@ void pilot_free( Pilot *p )
    array_free( p->outfit_utility );
    array_free( p->outfit_weapon );
    array_free( p->outfit_intrinsic );
+   pilot_outfitLFree( p );
+   array_free( p->stats_transient );
 
    /* Clean up data. */
    ai_destroy( p ); /* Must be destroyed first if applicable. */
@@ -4060,6 +4116,7 @@ void pilot_stackRemove( Pilot *p )
 #endif /* DEBUGGING */
    p->id = 0;
    array_erase( &pilot_stack, &pilot_stack[i], &pilot_stack[i + 1] );
+   qt_npilots = 0; /* Indices shifted, quadtree is stale. */
 }
 
 /**
@@ -4069,6 +4126,7 @@ int pilots_init( void )
 {
    pilot_stack = array_create_size( Pilot *, PILOT_SIZE_MIN );
    il_create( &pilot_qtquery, 1 );
+   pilot_ewInit();
    return 0;
 }
 
@@ -4101,6 +4159,9 @@ void pilots_free( void )
    /* Clean up quadtree. */
    qt_destroy( &pilot_quadtree );
    il_destroy( &pilot_qtquery );
+   array_free( pilot_visible );
+   pilot_visible = NULL;
+   pilot_ewFree();
 }
 
 /**
@@ -4153,6 +4214,7 @@ void pilots_clean( int persist )
    }
    array_erase( &pilot_stack, &pilot_stack[persist_count],
                 array_end( pilot_stack ) );
+   qt_npilots = 0; /* Indices shifted, quadtree is stale. */
 
    /* Init AI on the remaining pilots, has to be done here so the pilot_stack is
     * consistent. */
@@ -4190,7 +4252,8 @@ void pilots_newSystem( void )
    if ( qt_init )
       qt_destroy( &pilot_quadtree );
    qt_create( &pilot_quadtree, -r, -r, r, r, qt_max_elem, qt_depth );
-   qt_init = 1;
+   qt_init    = 1;
+   qt_npilots = 0;
 
    NTracingZoneEnd( _ctx );
 }
@@ -4219,6 +4282,7 @@ void pilots_cleanAll( void )
    }
    array_erase( &pilot_stack, array_begin( pilot_stack ),
                 array_end( pilot_stack ) );
+   qt_npilots = 0;
 }
 
 static void pilot_addQuadtree( const Pilot *p, int i )
@@ -4253,6 +4317,9 @@ void pilots_updatePurge( void )
          pilot_erase( p );
    }
 
+   /* Visibility is cached per tick. */
+   pilot_ewVisClear();
+
    /* Second loop sets up quadtrees. */
    qt_clear( &pilot_quadtree ); /* Empty it. */
    for ( int i = 0; i < array_size( pilot_stack ); i++ ) {
@@ -4268,6 +4335,10 @@ void pilots_updatePurge( void )
 
       pilot_addQuadtree( p, i );
    }
+   qt_npilots = array_size( pilot_stack );
+
+   /* Stealth queries depend on detection ranges. */
+   pilot_ewUpdateDetectMax();
 
    NTracingZoneEnd( _ctx );
 }
@@ -4283,6 +4354,7 @@ void pilots_update( double dt )
    NTracingPlotI( "pilots", array_size( pilot_stack ) );
 
    /* Have all the pilots think. */
+   ai_updateSlots( dt );
    for ( int i = 0; i < array_size( pilot_stack ); i++ ) {
       Pilot *p = pilot_stack[i];
 
@@ -4352,22 +4424,68 @@ void pilots_update( double dt )
 }
 
 /**
- * @brief Renders all the pilots.
+ * @brief Checks to see if a pilot has trails that it draws over itself.
+ */
+static int pilot_hasOntopTrail( const Pilot *p )
+{
+   for ( int i = 0; i < array_size( p->trail ); i++ )
+      if ( p->trail[i]->ontop )
+         return 1;
+   return 0;
+}
+
+/**
+ * @brief Builds the list of pilots to render this frame.
+ *
+ * The pilot quadtree is built before pilots move during the update, so it can
+ * not be trusted at render time and the pilots are tested directly instead.
+ *
+ *    @param view Visible region of the game world.
+ *    @param[out] stats Culling counters to update.
+ */
+void pilots_cull( const RenderView *view, RenderCullStats *stats )
+{
+   if ( pilot_visible == NULL )
+      pilot_visible = array_create( unsigned int );
+   array_resize( &pilot_visible, 0 );
+
+   for ( int i = 0; i < array_size( pilot_stack ); i++ ) {
+      const Pilot *p = pilot_stack[i];
+
+      /* Not rendered by pilots_render(). */
+      if ( pilot_isFlag( p, PILOT_HIDE ) || pilot_isFlag( p, PILOT_DELETE ) ||
+           pilot_isFlag( p, PILOT_PLAYER ) ||
+           pilot_isFlag( p, PILOT_NORENDER ) )
+         continue;
+
+      /* Trails drawn over the pilot can be in view even if it isn't. */
+      if ( render_viewOutside( view, p->solid.pos.x, p->solid.pos.y,
+                               p->ship->size ) &&
+           !pilot_hasOntopTrail( p ) ) {
+         stats->pilots_culled++;
+         continue;
+      }
+
+      array_push_back( &pilot_visible, p->id );
+      stats->pilots_drawn++;
+   }
+}
+
+/**
+ * @brief Renders all the pilots that passed culling.
  */
 void pilots_render( void )
 {
    NTracingZone( _ctx, 1 );
    gl_debugGroupStart();
 
-   for ( int i = 0; i < array_size( pilot_stack ); i++ ) {
-      Pilot *p = pilot_stack[i];
-
-      /* Invisible, not doing anything. */
-      if ( pilot_isFlag( p, PILOT_HIDE ) || pilot_isFlag( p, PILOT_DELETE ) )
+   for ( int i = 0; i < array_size( pilot_visible ); i++ ) {
+      /* Render hooks may have removed it since culling. */
+      Pilot *p = pilot_get( pilot_visible[i] );
+      if ( ( p == NULL ) || pilot_isFlag( p, PILOT_HIDE ) )
          continue;
 
-      if ( !pilot_isFlag( p, PILOT_PLAYER ) )
-         pilot_render( p );
+      pilot_render( p );
    }
 
    gl_debugGroupEnd();
@@ -14,6 +14,7 @@
 #include "ntime.h"
 #include "outfit.h"
 #include "physics.h"
+#include "render.h"
 #include "ship.h"
 #include "space.h"
 #include "spfx.h"
@@ -57,6 +58,12 @@
 #define PILOT_PLAYER_NONTARGETABLE_JUMPIN_DELAY                                \
    5. /**< Time the player is safe (from being targetted) after jumping in. */
 
+/* Stat layers cached by pilot_calcStats. */
+#define PILOT_STATS_BASE ( 1 << 0 ) /**< Ship, ship Lua and intrinsic stats. */
+#define PILOT_STATS_OUTFITS                                                    \
+   ( 1 << 1 ) /**< Outfit stats that don't depend on outfit state. */
+#define PILOT_STATS_EFFECTS ( 1 << 2 ) /**< Stats from effects. */
+
 /* Pilot-related hooks. */
 typedef enum PilotHookType_ {
    PILOT_HOOK_NONE,      /**< No hook. */
@@ -98,6 +105,30 @@ typedef enum PilotHookType_ {
 #define pilot_isWithPlayer( p )                                                \
    ( ( p )->faction == FACTION_PLAYER || ( ( p )->parent == PLAYER_ID ) )
 
+/**
+ * @brief Lua outfit callbacks that get run on all the outfits of a pilot.
+ */
+typedef enum PilotOutfitLHook_ {
+   PILOT_OUTFITL_OUTFITCHANGE, /**< Outfits changed. */
+   PILOT_OUTFITL_UPDATE,       /**< Regular update. */
+   PILOT_OUTFITL_OUTOFENERGY,  /**< Ran out of energy. */
+   PILOT_OUTFITL_ONHIT,        /**< Got hit. */
+   PILOT_OUTFITL_COOLDOWN,     /**< Cooldown started or ended. */
+   PILOT_OUTFITL_ONSHOOTANY,   /**< Any weapon shot. */
+   PILOT_OUTFITL_ONSTEALTH,    /**< Stealth changed. */
+   PILOT_OUTFITL_ONSCAN,       /**< Scanned a target. */
+   PILOT_OUTFITL_ONSCANNED,    /**< Got scanned. */
+   PILOT_OUTFITL_LAND,         /**< Landed. */
+   PILOT_OUTFITL_TAKEOFF,      /**< Took off. */
+   PILOT_OUTFITL_JUMPIN,       /**< Jumped in. */
+   PILOT_OUTFITL_BOARD,        /**< Boarded a target. */
+   PILOT_OUTFITL_KEYDOUBLETAP, /**< Key was double tapped. */
+   PILOT_OUTFITL_KEYRELEASE,   /**< Key was released. */
+   PILOT_OUTFITL_ONDEATH,      /**< Died. */
+   PILOT_OUTFITL_ONANYIMPACT,  /**< Weapon impacted anything. */
+   PILOT_OUTFITL_MAX           /**< Number of callback types. */
+} PilotOutfitLHook;
+
 /**
  * @brief Contains the state of the outfit.
  *
@@ -358,6 +389,23 @@ typedef struct Pilot_ {
    int    outfitlupdate; /**< Has outfits with Lua update scripts. */
    double refuel_amount; /**< Amount to refuel. */
 
+   /* Stat layers, see pilot_calcStats. */
+   unsigned int stats_valid;   /**< Layers that are up to date. */
+   ShipStats    stats_base;    /**< Ship, ship Lua and intrinsic stats. */
+   ShipStats    stats_outfits; /**< Outfit stats not depending on state. */
+   ShipStats    stats_effects; /**< Accumulated effect stats. */
+   int          stats_cpu;     /**< CPU used by the outfits. */
+   double       stats_mass;    /**< Mass of the outfits without ammo. */
+   double       stats_mass_core; /**< Mass of the required outfits. */
+   int         *stats_transient; /**< Array (array.h): Slot indices with stats
+                                    that depend on their state or Lua. */
+
+   /* Lua outfit callbacks, see pilot_outfitLRun. */
+   int *outfitl[PILOT_OUTFITL_MAX]; /**< Array (array.h): Slot indices with
+                                       each callback. */
+   int          outfitl_valid; /**< Whether outfitl matches the slots. */
+   unsigned int outfitl_gen;   /**< Bumped whenever the slots change. */
+
    /* For easier usage. */
    PilotOutfitSlot *afterburner; /**< the afterburner */
 
@@ -538,6 +586,7 @@ void pilots_updatePurge( void );
 void pilots_update( double dt );
 void pilot_renderFramebuffer( Pilot *p, GLuint fbo, double fw, double fh,
                               const Lighting *L );
+void pilots_cull( const RenderView *view, RenderCullStats *stats );
 void pilots_render( void );
 void pilots_renderOverlay( void );
 void pilot_render( Pilot *pilot );
@@ -578,5 +627,6 @@ void    pilot_untargetAsteroid( int anchor, int asteroid );
 PilotOutfitSlot *pilot_getDockSlot( Pilot *p );
 const IntList   *pilot_collideQuery( int x1, int y1, int x2, int y2 );
 void pilot_collideQueryIL( IntList *il, int x1, int y1, int x2, int y2 );
+void pilot_nearbyQueryIL( IntList *il, double x, double y, double r );
 void pilot_quadtreeParams( int max_elem, int depth );
 int  pilot_invincible( const Pilot *p );
@@ -20,7 +20,29 @@
 #include "player_autonav.h"
 #include "space.h"
 
+/* Slack added to stealth queries, since pilots keep moving after the quadtree
+ * gets built. */
+#define EW_QUERY_MARGIN 250.
+
 static double ew_interference = 1.; /**< Interference factor. */
+static double ew_detect_max =
+   0.; /**< Upper bound on the ew_detect of all pilots in the system. */
+static IntList ew_qtquery; /**< Quadtree query for stealth checks. */
+
+/**
+ * @brief Cached visibility of a target pilot to an observer pilot.
+ */
+typedef struct EWVis_ {
+   uint64_t     key; /**< Observer ID in the high bits, target ID in the low. */
+   unsigned int gen; /**< Tick the entry is valid for, stale otherwise. */
+   int          vis; /**< Result of pilot_inRangePilot. */
+} EWVis;
+
+static EWVis        *ew_vis      = NULL; /**< Per-tick visibility cache. */
+static unsigned int  ew_vis_size = 0;    /**< Size of ew_vis. */
+static unsigned int  ew_vis_used = 0;    /**< Valid entries in ew_vis. */
+static unsigned int  ew_vis_gen  = 1;    /**< Current cache generation. */
+static PilotVisStats ew_vis_stats;       /**< Cache statistics. */
 
 /*
  * Prototypes.
@@ -31,6 +53,29 @@ static double pilot_ewAsteroid( const Pilot *p );
 static double pilot_ewJumpPoint( const Pilot *p );
 static int    pilot_ewStealthGetNearby( const Pilot *p, double *mod, int *close,
                                         int *isplayer );
+static int    pilot_inRangePilotCompute( const Pilot *p, const Pilot *target,
+                                         double d );
+static EWVis *pilot_ewVisFind( uint64_t key, int *found );
+
+/**
+ * @brief Initializes the electronic warfare subsystem.
+ */
+void pilot_ewInit( void )
+{
+   il_create( &ew_qtquery, 1 );
+}
+
+/**
+ * @brief Frees the electronic warfare subsystem.
+ */
+void pilot_ewFree( void )
+{
+   il_destroy( &ew_qtquery );
+   free( ew_vis );
+   ew_vis      = NULL;
+   ew_vis_size = 0;
+   ew_vis_used = 0;
+}
 
 /**
  * @brief Gets the time it takes to scan a pilot.
@@ -108,6 +153,9 @@ void pilot_ewUpdateStatic( Pilot *p )
 {
    p->ew_mass = pilot_ewMass( p->solid.mass );
    pilot_ewUpdate( p );
+
+   /* Stats may have changed since the bound was last computed. */
+   ew_detect_max = MAX( ew_detect_max, p->stats.ew_detect );
 }
 
 /**
@@ -208,6 +256,20 @@ static double pilot_ewJumpPoint( const Pilot *p )
    return 1.;
 }
 
+/**
+ * @brief Recomputes the bound on the detection of all the pilots.
+ *
+ * Called whenever the pilot quadtree is rebuilt, so the bound can also shrink
+ * again when pilots leave.
+ */
+void pilot_ewUpdateDetectMax( void )
+{
+   Pilot *const *ps = pilot_getAll();
+   ew_detect_max    = 0.;
+   for ( int i = 0; i < array_size( ps ); i++ )
+      ew_detect_max = MAX( ew_detect_max, ps[i]->stats.ew_detect );
+}
+
 /**
  * @brief Updates the system's base sensor range.
  */
@@ -249,9 +311,86 @@ int pilot_inRange( const Pilot *p, double x, double y )
    return 0;
 }
 
+/**
+ * @brief Invalidates the visibility cache.
+ *
+ * Has to be called every tick and whenever something that isn't expected to
+ * change during a tick, like stealth or visibility flags, changes.
+ */
+void pilot_ewVisClear( void )
+{
+   ew_vis_used = 0;
+   /* Skip 0 so freshly allocated entries are never valid. */
+   if ( ++ew_vis_gen == 0 )
+      ew_vis_gen = 1;
+}
+
+/**
+ * @brief Gets the visibility cache statistics.
+ *
+ *    @param[out] stats Statistics to fill out.
+ */
+void pilot_ewVisStats( PilotVisStats *stats )
+{
+   *stats         = ew_vis_stats;
+   stats->entries = ew_vis_used;
+}
+
+/**
+ * @brief Hashes a visibility cache key (Fibonacci hashing).
+ */
+static unsigned int pilot_ewVisHash( uint64_t key )
+{
+   return (unsigned int)( ( key * 11400714819323198485ull ) >> 32 );
+}
+
+/**
+ * @brief Finds the slot of a pair in the visibility cache.
+ *
+ *    @param key Key of the pair.
+ *    @param[out] found Whether or not the pair is cached.
+ *    @return The slot of the pair, which is free if not found.
+ */
+static EWVis *pilot_ewVisFind( uint64_t key, int *found )
+{
+   unsigned int mask, i;
+
+   /* Grow to keep it at most half full, dropping stale entries. */
+   if ( 2 * ( ew_vis_used + 1 ) > ew_vis_size ) {
+      EWVis       *old     = ew_vis;
+      unsigned int oldsize = ew_vis_size;
+      ew_vis_size          = MAX( 256, 2 * oldsize );
+      ew_vis               = calloc( ew_vis_size, sizeof( EWVis ) );
+      mask                 = ew_vis_size - 1;
+      for ( unsigned int j = 0; j < oldsize; j++ ) {
+         if ( old[j].gen != ew_vis_gen )
+            continue;
+         for ( i = pilot_ewVisHash( old[j].key ) & mask;
+               ew_vis[i].gen == ew_vis_gen; i = ( i + 1 ) & mask )
+            ;
+         ew_vis[i] = old[j];
+      }
+      free( old );
+   }
+
+   mask = ew_vis_size - 1;
+   for ( i = pilot_ewVisHash( key ) & mask; ew_vis[i].gen == ew_vis_gen;
+         i = ( i + 1 ) & mask ) {
+      if ( ew_vis[i].key == key ) {
+         *found = 1;
+         return &ew_vis[i];
+      }
+   }
+   *found = 0;
+   return &ew_vis[i];
+}
+
 /**
  * @brief Check to see if a pilot is in sensor range of another.
  *
+ * Results are cached per pair until the next call to pilot_ewVisClear(), which
+ * happens once per tick.
+ *
  *    @param p Pilot who is trying to check to see if other is in sensor range.
  *    @param target Target of p to check to see if is in sensor range.
  *    @param[out] dist2 Distance squared of the two pilots. Set to NULL if
@@ -261,12 +400,47 @@ int pilot_inRange( const Pilot *p, double x, double y )
  */
 int pilot_inRangePilot( const Pilot *p, const Pilot *target, double *dist2 )
 {
-   double d;
+   int      found;
+   double   d;
+   EWVis   *e;
+   uint64_t key = ( (uint64_t)p->id << 32 ) | target->id;
 
    /* Get distance if needed. */
+   d = vec2_dist2( &p->solid.pos, &target->solid.pos );
    if ( dist2 != NULL )
-      *dist2 = vec2_dist2( &p->solid.pos, &target->solid.pos );
+      *dist2 = d;
+
+   /* Pilots not on the stack, like player ships being swapped, have no stable
+    * ID so don't get cached. */
+   if ( ( p->id == 0 ) || ( target->id == 0 ) )
+      return pilot_inRangePilotCompute( p, target, d );
+
+   e = pilot_ewVisFind( key, &found );
+   if ( found ) {
+      ew_vis_stats.hits++;
+      return e->vis;
+   }
+   ew_vis_stats.misses++;
 
+   e->key = key;
+   e->gen = ew_vis_gen;
+   e->vis = pilot_inRangePilotCompute( p, target, d );
+   ew_vis_used++;
+   return e->vis;
+}
+
+/**
+ * @brief Computes whether a pilot is in sensor range of another.
+ *
+ *    @param p Pilot who is trying to check to see if other is in sensor range.
+ *    @param target Target of p to check to see if is in sensor range.
+ *    @param d Distance squared of the two pilots.
+ *    @return 1 if they are in range, 0 if they aren't and -1 if they are
+ * detected fuzzily.
+ */
+static int pilot_inRangePilotCompute( const Pilot *p, const Pilot *target,
+                                      double d )
+{
    /* Special case player or omni-visible. */
    if ( ( pilot_isPlayer( p ) && pilot_isFlag( target, PILOT_VISPLAYER ) ) ||
         pilot_isFlag( target, PILOT_VISIBLE ) || target->parent == p->id )
@@ -277,8 +451,6 @@ int pilot_inRangePilot( const Pilot *p, const Pilot *target, double *dist2 )
       return 0;
 
    /* No stealth so normal detection. */
-   d = ( dist2 != NULL ? *dist2
-                       : vec2_dist2( &p->solid.pos, &target->solid.pos ) );
    if ( d < pow2( MAX( 0., p->stats.ew_detect * p->stats.ew_track *
                               target->ew_signature ) ) )
       return 1;
@@ -440,6 +612,7 @@ static int pilot_ewStealthGetNearby( const Pilot *p, double *mod, int *close,
 {
    Pilot *const *ps;
    int           n;
+   double        r;
 
    /* Check nearby non-allies. */
    if ( mod != NULL )
@@ -448,11 +621,19 @@ static int pilot_ewStealthGetNearby( const Pilot *p, double *mod, int *close,
       *close = 0;
    if ( isplayer != NULL )
       *isplayer = 0;
-   n  = 0;
+   n = 0;
+
+   /* Only pilots within the largest possible detection range matter, so let
+    * the quadtree discard the rest. */
+   r = MAX( 0., p->ew_stealth * ew_detect_max );
+   if ( close != NULL )
+      r *= 1.5;
+   pilot_nearbyQueryIL( &ew_qtquery, p->solid.pos.x, p->solid.pos.y,
+                        r + EW_QUERY_MARGIN );
    ps = pilot_getAll();
-   for ( int i = 0; i < array_size( ps ); i++ ) {
+   for ( int j = 0; j < il_size( &ew_qtquery ); j++ ) {
       double dist;
-      Pilot *t = ps[i];
+      Pilot *t = ps[il_get( &ew_qtquery, j, 0 )];
 
       /* Quick checks first. */
       if ( pilot_isDisabled( t ) )
@@ -567,6 +748,7 @@ int pilot_stealth( Pilot *p )
       pilot_rmFlag( p, PILOT_STEALTH );
       return 0;
    }
+   pilot_ewVisClear();
 
    /* Turn off all weapon sets. */
    pilot_weapSetAIClear( p );
@@ -595,6 +777,7 @@ void pilot_destealth( Pilot *p )
    if ( !pilot_isFlag( p, PILOT_STEALTH ) )
       return;
    pilot_rmFlag( p, PILOT_STEALTH );
+   pilot_ewVisClear();
    p->ew_stealth_timer = 0.;
    if ( !pilot_outfitLOnstealth( p ) )
       pilot_calcStats( p );
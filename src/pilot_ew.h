@@ -3,8 +3,25 @@
  */
 #pragma once
 
+#include <stdint.h>
+
 #include "pilot.h"
 
+/**
+ * @brief Statistics of the per-tick pilot visibility cache.
+ */
+typedef struct PilotVisStats_ {
+   uint64_t hits;    /**< Visibility checks answered from the cache. */
+   uint64_t misses;  /**< Visibility checks that had to be computed. */
+   uint64_t entries; /**< Pairs currently cached for this tick. */
+} PilotVisStats;
+
+/*
+ * Init/cleanup.
+ */
+void pilot_ewInit( void );
+void pilot_ewFree( void );
+
 /*
  * Sensors and range.
  */
@@ -15,6 +32,8 @@ int    pilot_inRangePilot( const Pilot *p, const Pilot *target, double *dist2 );
 int    pilot_inRangeSpob( const Pilot *p, int target );
 int    pilot_inRangeAsteroid( const Pilot *p, int ast, int fie );
 int    pilot_inRangeJump( const Pilot *p, int target );
+void   pilot_ewVisClear( void );
+void   pilot_ewVisStats( PilotVisStats *stats );
 
 /*
  * Weapon tracking.
@@ -30,6 +49,7 @@ double pilot_ewScanTime( const Pilot *p );
 void   pilot_ewScanStart( Pilot *p );
 void   pilot_ewUpdateStatic( Pilot *p );
 void   pilot_ewUpdateDynamic( Pilot *p, double dt );
+void   pilot_ewUpdateDetectMax( void );
 
 /*
  * Stealth.
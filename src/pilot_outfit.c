@@ -31,13 +31,18 @@
 #include "space.h"
 
 static int stealth_break = 0; /**< Whether or not to break stealth. */
+static const nlua_env *outfitl_batch =
+   NULL; /**< Env whose memory pilot_outfitLRun already saved. */
 
 /*
  * Prototypes.
  */
 static void        pilot_calcStatsSlot( Pilot *pilot, PilotOutfitSlot *slot,
-                                        ShipStats *s );
+                                        int idx );
+static PilotOutfitSlot *pilot_outfitLSlot( Pilot *p, int idx );
 static const char *outfitkeytostr( OutfitKey key );
+static void        pilot_outfitLInvalidate( Pilot *p );
+static void        pilot_outfitLBuild( Pilot *p );
 
 /**
  * @brief Updates the lockons on the pilot's launchers
@@ -305,6 +310,8 @@ int pilot_addOutfitRawNoLua( Pilot *pilot, const Outfit *outfit,
    s->flags  = 0;
    s->state  = PILOT_OUTFIT_OFF;
    s->outfit = outfit;
+   pilot_outfitLInvalidate( pilot );
+   pilot_calcStatsDirty( pilot, PILOT_STATS_OUTFITS );
 
    /* Set some default parameters. */
    s->timer = 0.;
@@ -528,6 +535,8 @@ int pilot_rmOutfitRaw( Pilot *pilot, PilotOutfitSlot *s )
    ret       = ( s->outfit == NULL );
    s->outfit = NULL;
    s->flags  = 0; /* Clear flags. */
+   pilot_outfitLInvalidate( pilot );
+   pilot_calcStatsDirty( pilot, PILOT_STATS_OUTFITS );
    // s->weapset  = -1;
 
    /* Remove secondary and such if necessary. */
@@ -1009,10 +1018,23 @@ double pilot_outfitRange( const Pilot *p, const Outfit *o )
 }
 
 /**
- * @brief Computes the stats for a pilot's slot.
+ * @brief Checks to see if a slot's stats depend on its state or Lua.
  */
-static void pilot_calcStatsSlot( Pilot *pilot, PilotOutfitSlot *slot,
-                                 ShipStats *s )
+static int pilot_calcStatsIsTransient( const PilotOutfitSlot *slot )
+{
+   const Outfit *o = slot->outfit;
+   return ( outfit_isMod( o ) && ( slot->flags & PILOTOUTFIT_ACTIVE ) ) ||
+          outfit_isAfterburner( o ) || ( outfit_luaEnv( o ) != NULL );
+}
+
+/**
+ * @brief Computes the state-independent stats for a pilot's slot.
+ *
+ *    @param pilot Pilot the slot belongs to.
+ *    @param slot Slot to compute.
+ *    @param idx Index of the slot as in pilot_outfitLSlot.
+ */
+static void pilot_calcStatsSlot( Pilot *pilot, PilotOutfitSlot *slot, int idx )
 {
    const Outfit *o = slot->outfit;
 
@@ -1021,37 +1043,52 @@ static void pilot_calcStatsSlot( Pilot *pilot, PilotOutfitSlot *slot,
       return;
 
    /* Modify CPU. */
-   pilot->cpu += outfit_cpu( o );
+   pilot->stats_cpu += outfit_cpu( o );
 
    /* Add mass. */
-   pilot->mass_outfit += outfit_mass( o );
+   pilot->stats_mass += outfit_mass( o );
 
    /* Keep a separate counter for required (core) outfits. */
    if ( sp_required( outfit_slotProperty( o ) ) )
-      pilot->base_mass += outfit_mass( o );
-
-   /* Add ammo mass. */
-   pilot->mass_outfit += slot->u.ammo.quantity * outfit_ammoMass( o );
+      pilot->stats_mass_core += outfit_mass( o );
 
    if ( outfit_isAfterburner( o ) ) /* Afterburner */
       pilot->afterburner = slot;    /* Set afterburner */
 
-   /* Lua mods apply their stats. */
-   if ( slot->lua_mem != LUA_NOREF )
-      ss_statsMergeFromList( s, slot->lua_stats, 0 );
-
    /* Has update function. */
    if ( outfit_luaUpdate( o ) != LUA_NOREF )
       pilot->outfitlupdate = 1;
 
+   /* The rest gets handled every time by pilot_calcStatsSlotTransient. */
+   if ( pilot_calcStatsIsTransient( slot ) )
+      array_push_back( &pilot->stats_transient, idx );
+   if ( ( outfit_isMod( o ) && ( slot->flags & PILOTOUTFIT_ACTIVE ) ) ||
+        outfit_isAfterburner( o ) )
+      return;
+
+   /* Always add stats for the rest. */
+   ss_statsMergeFromVec( &pilot->stats_outfits, outfit_statsVec( o ), 1., 0 );
+}
+
+/**
+ * @brief Computes the stats of a slot that depend on its state or Lua.
+ */
+static void pilot_calcStatsSlotTransient( Pilot *pilot, PilotOutfitSlot *slot,
+                                          ShipStats *s )
+{
+   const Outfit *o = slot->outfit;
+
+   /* Lua mods apply their stats. */
+   if ( slot->lua_mem != LUA_NOREF )
+      ss_statsMergeFromList( s, slot->lua_stats, 0 );
+
    /* Apply modifications. */
-   if ( outfit_isMod( o ) ) { /* Modification */
+   if ( outfit_isMod( o ) && ( slot->flags & PILOTOUTFIT_ACTIVE ) ) {
       /* Active outfits must be on to affect stuff. */
-      if ( ( slot->flags & PILOTOUTFIT_ACTIVE ) &&
-           !( slot->state == PILOT_OUTFIT_ON ) )
+      if ( slot->state != PILOT_OUTFIT_ON )
          return;
       /* Add stats. */
-      ss_statsMergeFromList( s, outfit_stats( o ), 0 );
+      ss_statsMergeFromVec( s, outfit_statsVec( o ), 1., 0 );
 
    } else if ( outfit_isAfterburner( o ) ) { /* Afterburner */
       /* Active outfits must be on to affect stuff. */
@@ -1059,18 +1096,29 @@ static void pilot_calcStatsSlot( Pilot *pilot, PilotOutfitSlot *slot,
            !( slot->state == PILOT_OUTFIT_ON ) )
          return;
       /* Add stats. */
-      ss_statsMergeFromList( s, outfit_stats( o ), 0 );
+      ss_statsMergeFromVec( s, outfit_statsVec( o ), 1., 0 );
       pilot_setFlag(
          pilot,
          PILOT_AFTERBURNER ); /* We use old school flags for this still... */
       pilot->stats.energy_regen_malus +=
          outfit_energy( pilot->afterburner->outfit ); /* energy loss */
-   } else {
-      /* Always add stats for non mod/afterburners. */
-      ss_statsMergeFromList( s, outfit_stats( o ), 0 );
    }
 }
 
+/**
+ * @brief Marks stat layers of a pilot as needing to be recomputed.
+ *
+ * Has to be called when whatever a layer is computed from changes, before
+ * calling pilot_calcStats().
+ *
+ *    @param pilot Pilot to mark.
+ *    @param layers Layers to mark (PILOT_STATS_*).
+ */
+void pilot_calcStatsDirty( Pilot *pilot, unsigned int layers )
+{
+   pilot->stats_valid &= ~layers;
+}
+
 /**
  * @brief Recalculates the pilot's stats based on his outfits.
  *
@@ -1087,8 +1135,6 @@ void pilot_calcStats( Pilot *pilot )
    /* mass */
    pilot->solid.mass = pilot->ship->mass;
    pilot->base_mass  = pilot->solid.mass;
-   /* cpu */
-   pilot->cpu = 0.;
    /* movement */
    pilot->accel_base = pilot->ship->accel;
    pilot->turn_base  = pilot->ship->turn;
@@ -1117,8 +1163,6 @@ void pilot_calcStats( Pilot *pilot )
    /* Energy. */
    pilot->energy_max   = pilot->ship->energy;
    pilot->energy_regen = pilot->ship->energy_regen;
-   /* Misc. */
-   pilot->outfitlupdate = 0;
    /* Stats.
     *
     * In general, stats are applied in two ways:
@@ -1131,26 +1175,70 @@ void pilot_calcStats( Pilot *pilot )
    s  = &pilot->stats;
    tm = s->time_mod;
 
-   /* Initialize ship stats (additive). */
-   *s = pilot->ship->stats_array;
-   ss_statsMergeFromList( &pilot->stats, pilot->ship_stats,
-                          0 ); /* From ship Lua if applicable. */
-
-   /* Apply intrinsic stats. */
-   ss_statsMergeFromList( &pilot->stats, pilot->intrinsic_stats, 1 );
+   /* The stats are built from cached layers, which only get recomputed when
+    * marked dirty with pilot_calcStatsDirty(). Slot stats that depend on the
+    * outfit state or Lua are cheap and get recomputed every time. */
+   if ( !( pilot->stats_valid & PILOT_STATS_BASE ) ) {
+      /* Initialize ship stats (additive). */
+      pilot->stats_base = pilot->ship->stats_array;
+      ss_statsMergeFromList( &pilot->stats_base, pilot->ship_stats,
+                             0 ); /* From ship Lua if applicable. */
+
+      /* Apply intrinsic stats. */
+      ss_statsMergeFromList( &pilot->stats_base, pilot->intrinsic_stats, 1 );
+      pilot->stats_valid |= PILOT_STATS_BASE;
+   }
+   if ( !( pilot->stats_valid & PILOT_STATS_OUTFITS ) ) {
+      int n = array_size( pilot->outfits );
+      ss_statsInit( &pilot->stats_outfits );
+      pilot->stats_cpu       = 0;
+      pilot->stats_mass      = 0.;
+      pilot->stats_mass_core = 0.;
+      pilot->outfitlupdate   = 0;
+      if ( pilot->stats_transient == NULL )
+         pilot->stats_transient = array_create( int );
+      else
+         array_erase( &pilot->stats_transient,
+                      array_begin( pilot->stats_transient ),
+                      array_end( pilot->stats_transient ) );
+      for ( int i = 0; i < array_size( pilot->outfit_intrinsic ); i++ )
+         pilot_calcStatsSlot( pilot, &pilot->outfit_intrinsic[i], n + i );
+      for ( int i = 0; i < n; i++ )
+         pilot_calcStatsSlot( pilot, pilot->outfits[i], i );
+      pilot->stats_valid |= PILOT_STATS_OUTFITS;
+   }
+   if ( !( pilot->stats_valid & PILOT_STATS_EFFECTS ) ) {
+      ss_statsInit( &pilot->stats_effects );
+      effect_compute( &pilot->stats_effects, pilot->effects );
+      pilot->stats_valid |= PILOT_STATS_EFFECTS;
+   }
+   *s = pilot->stats_base;
+   pilot->cpu = pilot->stats_cpu;
+   pilot->base_mass += pilot->stats_mass_core;
 
    /* Now add outfit changes */
-   ShipStats outfit_stats;
-   ss_statsInit( &outfit_stats );
-   pilot->mass_outfit = 0.;
-   for ( int i = 0; i < array_size( pilot->outfit_intrinsic ); i++ )
-      pilot_calcStatsSlot( pilot, &pilot->outfit_intrinsic[i], &outfit_stats );
-   for ( int i = 0; i < array_size( pilot->outfits ); i++ )
-      pilot_calcStatsSlot( pilot, pilot->outfits[i], &outfit_stats );
+   ShipStats outfit_stats = pilot->stats_outfits;
+   pilot->mass_outfit     = pilot->stats_mass;
+   for ( int i = 0; i < array_size( pilot->outfit_intrinsic ); i++ ) {
+      const PilotOutfitSlot *slot = &pilot->outfit_intrinsic[i];
+      if ( slot->outfit != NULL )
+         pilot->mass_outfit +=
+            slot->u.ammo.quantity * outfit_ammoMass( slot->outfit );
+   }
+   for ( int i = 0; i < array_size( pilot->outfits ); i++ ) {
+      const PilotOutfitSlot *slot = pilot->outfits[i];
+      if ( slot->outfit != NULL )
+         pilot->mass_outfit +=
+            slot->u.ammo.quantity * outfit_ammoMass( slot->outfit );
+   }
+   for ( int i = 0; i < array_size( pilot->stats_transient ); i++ )
+      pilot_calcStatsSlotTransient(
+         pilot, pilot_outfitLSlot( pilot, pilot->stats_transient[i] ),
+         &outfit_stats );
    ss_statsMerge( &pilot->stats, &outfit_stats, 1 );
 
    /* Compute effects. */
-   effect_compute( &pilot->stats, pilot->effects );
+   ss_statsMerge( &pilot->stats, &pilot->stats_effects, 1 );
 
    /* Apply system effects. */
    ss_statsMergeFromList( &pilot->stats, cur_system->stats, 1 );
@@ -1358,6 +1446,10 @@ void pilot_updateMass( Pilot *pilot )
    /* Need to recalculate electronic warfare mass change. */
    pilot_ewUpdateStatic( pilot );
 
+   /* Slots may have changed, so update the Lua callback lists. */
+   if ( !pilot->outfitl_valid )
+      pilot_outfitLBuild( pilot );
+
    /* Update ship stuff. */
    if ( ( pilot->id > 0 ) && pilot_isPlayer( pilot ) && ( pilot->ai != NULL ) )
       gui_setShip();
@@ -1422,30 +1514,187 @@ static void temp_cleanup( PilotTemp tmp, Pilot *p )
    }
 }
 
+/**
+ * @brief Gets the Lua callback of an outfit for a callback type.
+ */
+static int pilot_outfitLHookRef( const Outfit *o, PilotOutfitLHook hook )
+{
+   switch ( hook ) {
+   case PILOT_OUTFITL_OUTFITCHANGE:
+      return outfit_luaOnoutfitchange( o );
+   case PILOT_OUTFITL_UPDATE:
+      return outfit_luaUpdate( o );
+   case PILOT_OUTFITL_OUTOFENERGY:
+      return outfit_luaOutofenergy( o );
+   case PILOT_OUTFITL_ONHIT:
+      return outfit_luaOnhit( o );
+   case PILOT_OUTFITL_COOLDOWN:
+      return outfit_luaCooldown( o );
+   case PILOT_OUTFITL_ONSHOOTANY:
+      return outfit_luaOnshootany( o );
+   case PILOT_OUTFITL_ONSTEALTH:
+      return outfit_luaOnstealth( o );
+   case PILOT_OUTFITL_ONSCAN:
+      return outfit_luaOnscan( o );
+   case PILOT_OUTFITL_ONSCANNED:
+      return outfit_luaOnscanned( o );
+   case PILOT_OUTFITL_LAND:
+      return outfit_luaLand( o );
+   case PILOT_OUTFITL_TAKEOFF:
+      return outfit_luaTakeoff( o );
+   case PILOT_OUTFITL_JUMPIN:
+      return outfit_luaJumpin( o );
+   case PILOT_OUTFITL_BOARD:
+      return outfit_luaBoard( o );
+   case PILOT_OUTFITL_KEYDOUBLETAP:
+      return outfit_luaKeydoubletap( o );
+   case PILOT_OUTFITL_KEYRELEASE:
+      return outfit_luaKeyrelease( o );
+   case PILOT_OUTFITL_ONDEATH:
+      return outfit_luaOndeath( o );
+   case PILOT_OUTFITL_ONANYIMPACT:
+      return outfit_luaOnanyimpact( o );
+   case PILOT_OUTFITL_MAX:
+      break;
+   }
+   return LUA_NOREF;
+}
+
+/**
+ * @brief Gets a slot by its index in the Lua callback lists.
+ *
+ * Indices go first over pilot->outfits and then over pilot->outfit_intrinsic,
+ * which is the order pilot_outfitLRun runs them in.
+ */
+static PilotOutfitSlot *pilot_outfitLSlot( Pilot *p, int idx )
+{
+   int n = array_size( p->outfits );
+   if ( idx < n )
+      return p->outfits[idx];
+   idx -= n;
+   if ( idx < array_size( p->outfit_intrinsic ) )
+      return &p->outfit_intrinsic[idx];
+   return NULL;
+}
+
+/**
+ * @brief Marks the Lua callback lists of a pilot as out of date.
+ */
+static void pilot_outfitLInvalidate( Pilot *p )
+{
+   p->outfitl_valid = 0;
+   p->outfitl_gen++;
+}
+
+/**
+ * @brief Builds the lists of slots that have each Lua callback.
+ */
+static void pilot_outfitLBuild( Pilot *p )
+{
+   int n = array_size( p->outfits ) + array_size( p->outfit_intrinsic );
+   for ( int h = 0; h < PILOT_OUTFITL_MAX; h++ ) {
+      if ( p->outfitl[h] == NULL )
+         p->outfitl[h] = array_create( int );
+      else
+         array_erase( &p->outfitl[h], array_begin( p->outfitl[h] ),
+                      array_end( p->outfitl[h] ) );
+   }
+   for ( int i = 0; i < n; i++ ) {
+      const PilotOutfitSlot *po = pilot_outfitLSlot( p, i );
+      if ( ( po->outfit == NULL ) || ( outfit_luaEnv( po->outfit ) == NULL ) )
+         continue;
+      for ( int h = 0; h < PILOT_OUTFITL_MAX; h++ )
+         if ( pilot_outfitLHookRef( po->outfit, h ) != LUA_NOREF )
+            array_push_back( &p->outfitl[h], i );
+   }
+   p->outfitl_valid = 1;
+}
+
+/**
+ * @brief Frees the Lua callback lists of a pilot.
+ */
+void pilot_outfitLFree( Pilot *p )
+{
+   for ( int h = 0; h < PILOT_OUTFITL_MAX; h++ ) {
+      array_free( p->outfitl[h] );
+      p->outfitl[h] = NULL;
+   }
+   p->outfitl_valid = 0;
+}
+
 /**
  * @brief Wrapper that does all the work for us.
+ *
+ * When the callback lists are up to date, only the slots with the callback
+ * get visited, and the Lua memory of the outfit environment is only saved and
+ * restored once for consecutive slots sharing it.
+ *
+ *    @param p Pilot to run callbacks of.
+ *    @param hook Callback type, or -1 to run on all the slots.
+ *    @param func Function to run on each slot.
+ *    @param data Data to pass to the function.
  */
-static void pilot_outfitLRun( Pilot *p,
+static void pilot_outfitLRun( Pilot *p, int hook,
                               void ( *const func )( const Pilot     *p,
                                                     PilotOutfitSlot *po,
                                                     const void      *data ),
                               const void *data )
 {
+   int start = 0;
+
    /* If no ID, we'll hackily add a temporary pilot and undo the changes. */
    PilotTemp tmp = temp_setup( p );
 
    pilotoutfit_modified = 0;
-   for ( int i = 0; i < array_size( p->outfits ); i++ ) {
-      PilotOutfitSlot *po = p->outfits[i];
-      if ( po->outfit == NULL )
-         continue;
-      func( p, po, data );
-   }
-   for ( int i = 0; i < array_size( p->outfit_intrinsic ); i++ ) {
-      PilotOutfitSlot *po = &p->outfit_intrinsic[i];
-      if ( po->outfit == NULL )
-         continue;
-      func( p, po, data );
+   if ( ( hook >= 0 ) && p->outfitl_valid ) {
+      nlua_env    *env    = NULL;
+      int          oldmem = LUA_NOREF;
+      unsigned int gen    = p->outfitl_gen;
+      const int   *list   = p->outfitl[hook];
+
+      start = -1;
+      for ( int i = 0; i < array_size( list ); i++ ) {
+         int              idx = list[i];
+         PilotOutfitSlot *po  = pilot_outfitLSlot( p, idx );
+         nlua_env        *e   = outfit_luaEnv( po->outfit );
+
+         /* Save the memory once per run of slots sharing an environment. */
+         if ( e != env ) {
+            if ( env != NULL )
+               pilot_outfitLunmem( env, oldmem );
+            env = e;
+            nlua_getenv( naevL, e, "mem" );                /* oldmem */
+            oldmem = luaL_ref( naevL, LUA_REGISTRYINDEX ); /* */
+         }
+
+         outfitl_batch = env;
+         func( p, po, data );
+         outfitl_batch = NULL;
+
+         /* The callback changed the slots, so the list can't be trusted
+          * anymore. Finish off like the full scan would. */
+         if ( p->outfitl_gen != gen ) {
+            start = idx + 1;
+            break;
+         }
+      }
+      if ( env != NULL )
+         pilot_outfitLunmem( env, oldmem );
+   }
+   if ( start >= 0 ) {
+      for ( int i = start; i < array_size( p->outfits ); i++ ) {
+         PilotOutfitSlot *po = p->outfits[i];
+         if ( po->outfit == NULL )
+            continue;
+         func( p, po, data );
+      }
+      for ( int i = MAX( 0, start - array_size( p->outfits ) );
+            i < array_size( p->outfit_intrinsic ); i++ ) {
+         PilotOutfitSlot *po = &p->outfit_intrinsic[i];
+         if ( po->outfit == NULL )
+            continue;
+         func( p, po, data );
+      }
    }
 
    /* Some clean up. */
@@ -1476,9 +1725,14 @@ static int pilot_outfitLmem( PilotOutfitSlot *po, nlua_env *env )
       lua_newtable( naevL );                              /* mem */
       po->lua_mem = luaL_ref( naevL, LUA_REGISTRYINDEX ); /* */
    }
-   /* Get old memory. */
-   nlua_getenv( naevL, env, "mem" );              /* oldmem */
-   oldmem = luaL_ref( naevL, LUA_REGISTRYINDEX ); /* */
+   /* Get old memory, unless pilot_outfitLRun already saved it. */
+   if ( env == outfitl_batch ) {
+      outfitl_batch = NULL;
+      oldmem        = LUA_NOREF;
+   } else {
+      nlua_getenv( naevL, env, "mem" );              /* oldmem */
+      oldmem = luaL_ref( naevL, LUA_REGISTRYINDEX ); /* */
+   }
    /* Set the memory. */
    lua_rawgeti( naevL, LUA_REGISTRYINDEX, po->lua_mem ); /* mem */
    nlua_setenv( naevL, env, "mem" );                     /* */
@@ -1490,6 +1744,8 @@ static int pilot_outfitLmem( PilotOutfitSlot *po, nlua_env *env )
  */
 static void pilot_outfitLunmem( nlua_env *env, int oldmem )
 {
+   if ( oldmem == LUA_NOREF )
+      return;
    lua_rawgeti( naevL, LUA_REGISTRYINDEX, oldmem );
    nlua_setenv( naevL, env, "mem" ); /* pm */
    luaL_unref( naevL, LUA_REGISTRYINDEX, oldmem );
@@ -1684,7 +1940,7 @@ static void outfitLInit( const Pilot *pilot, PilotOutfitSlot *po,
 void pilot_outfitLInitAll( Pilot *pilot )
 {
    NTracingZone( _ctx, 1 );
-   pilot_outfitLRun( pilot, outfitLInit, NULL );
+   pilot_outfitLRun( pilot, -1, outfitLInit, NULL );
    NTracingZoneEnd( _ctx );
 }
 
@@ -1799,7 +2055,8 @@ void pilot_outfitLOutfitChange( Pilot *pilot )
    changing_outfit++;
 
    NTracingZone( _ctx, 1 );
-   pilot_outfitLRun( pilot, outfitLOutfitChange, NULL );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_OUTFITCHANGE, outfitLOutfitChange,
+                     NULL );
    NTracingZoneEnd( _ctx );
 
    changing_outfit--;
@@ -1860,7 +2117,7 @@ void pilot_outfitLUpdate( Pilot *pilot, double dt )
       return;
 
    NTracingZone( _ctx, 1 );
-   pilot_outfitLRun( pilot, outfitLUpdate, &dt );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_UPDATE, outfitLUpdate, &dt );
    NTracingZoneEnd( _ctx );
 }
 
@@ -1896,7 +2153,8 @@ static void outfitLOutofenergy( const Pilot *pilot, PilotOutfitSlot *po,
  */
 void pilot_outfitLOutfofenergy( Pilot *pilot )
 {
-   pilot_outfitLRun( pilot, outfitLOutofenergy, NULL );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_OUTOFENERGY, outfitLOutofenergy,
+                     NULL );
 }
 
 struct OnhitData {
@@ -1953,7 +2211,7 @@ void pilot_outfitLOnhit( Pilot *pilot, double armour, double shield,
 {
    const struct OnhitData data = {
       .armour = armour, .shield = shield, .attacker = attacker };
-   pilot_outfitLRun( pilot, outfitLOnhit, &data );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_ONHIT, outfitLOnhit, &data );
 }
 
 /**
@@ -2088,7 +2346,7 @@ void pilot_outfitLCooldown( Pilot *pilot, int done, int success, double timer )
 {
    const struct CooldownData data = {
       .done = done, .success = success, .timer = timer };
-   pilot_outfitLRun( pilot, outfitLCooldown, &data );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_COOLDOWN, outfitLCooldown, &data );
 }
 
 static void outfitLOnshootany( const Pilot *pilot, PilotOutfitSlot *po,
@@ -2122,7 +2380,7 @@ static void outfitLOnshootany( const Pilot *pilot, PilotOutfitSlot *po,
  */
 void pilot_outfitLOnshootany( Pilot *pilot )
 {
-   pilot_outfitLRun( pilot, outfitLOnshootany, NULL );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_ONSHOOTANY, outfitLOnshootany, NULL );
 }
 
 static void outfitLOnstealth( const Pilot *pilot, PilotOutfitSlot *po,
@@ -2159,7 +2417,7 @@ static void outfitLOnstealth( const Pilot *pilot, PilotOutfitSlot *po,
  */
 int pilot_outfitLOnstealth( Pilot *pilot )
 {
-   pilot_outfitLRun( pilot, outfitLOnstealth, NULL );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_ONSTEALTH, outfitLOnstealth, NULL );
    return pilotoutfit_modified;
 }
 
@@ -2195,7 +2453,7 @@ static void outfitLOnscan( const Pilot *pilot, PilotOutfitSlot *po,
  */
 void pilot_outfitLOnscan( Pilot *pilot )
 {
-   pilot_outfitLRun( pilot, outfitLOnscan, NULL );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_ONSCAN, outfitLOnscan, NULL );
 }
 
 static void outfitLOnscanned( const Pilot *pilot, PilotOutfitSlot *po,
@@ -2232,7 +2490,8 @@ static void outfitLOnscanned( const Pilot *pilot, PilotOutfitSlot *po,
  */
 void pilot_outfitLOnscanned( Pilot *pilot, const Pilot *scanner )
 {
-   pilot_outfitLRun( pilot, outfitLOnscanned, scanner );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_ONSCANNED, outfitLOnscanned,
+                     scanner );
 }
 
 static void outfitLOnland( const Pilot *pilot, PilotOutfitSlot *po,
@@ -2266,7 +2525,7 @@ static void outfitLOnland( const Pilot *pilot, PilotOutfitSlot *po,
  */
 void pilot_outfitLOnland( Pilot *pilot )
 {
-   pilot_outfitLRun( pilot, outfitLOnland, NULL );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_LAND, outfitLOnland, NULL );
 }
 
 static void outfitLOntakeoff( const Pilot *pilot, PilotOutfitSlot *po,
@@ -2300,7 +2559,7 @@ static void outfitLOntakeoff( const Pilot *pilot, PilotOutfitSlot *po,
  */
 void pilot_outfitLOntakeoff( Pilot *pilot )
 {
-   pilot_outfitLRun( pilot, outfitLOntakeoff, NULL );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_TAKEOFF, outfitLOntakeoff, NULL );
 }
 
 static void outfitLOnjumpin( const Pilot *pilot, PilotOutfitSlot *po,
@@ -2334,7 +2593,7 @@ static void outfitLOnjumpin( const Pilot *pilot, PilotOutfitSlot *po,
  */
 void pilot_outfitLOnjumpin( Pilot *pilot )
 {
-   pilot_outfitLRun( pilot, outfitLOnjumpin, NULL );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_JUMPIN, outfitLOnjumpin, NULL );
 }
 
 static void outfitLOnboard( const Pilot *pilot, PilotOutfitSlot *po,
@@ -2371,7 +2630,7 @@ static void outfitLOnboard( const Pilot *pilot, PilotOutfitSlot *po,
  */
 void pilot_outfitLOnboard( Pilot *pilot, const Pilot *target )
 {
-   pilot_outfitLRun( pilot, outfitLOnboard, target );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_BOARD, outfitLOnboard, target );
 }
 
 static const char *outfitkeytostr( OutfitKey key )
@@ -2423,7 +2682,8 @@ void pilot_outfitLOnkeydoubletap( Pilot *pilot, OutfitKey key )
    if ( pilot_isDisabled( pilot ) )
       return;
    stealth_break = 0;
-   pilot_outfitLRun( pilot, outfitLOnkeydoubletap, &key );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_KEYDOUBLETAP, outfitLOnkeydoubletap,
+                     &key );
    if ( stealth_break && pilot_isFlag( pilot, PILOT_STEALTH ) )
       pilot_destealth( pilot );
 }
@@ -2456,7 +2716,8 @@ static void outfitLOnkeyrelease( const Pilot *pilot, PilotOutfitSlot *po,
 }
 void pilot_outfitLOnkeyrelease( Pilot *pilot, OutfitKey key )
 {
-   pilot_outfitLRun( pilot, outfitLOnkeyrelease, &key );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_KEYRELEASE, outfitLOnkeyrelease,
+                     &key );
 }
 
 /**
@@ -2567,7 +2828,7 @@ static void outfitLOndeath( const Pilot *pilot, PilotOutfitSlot *po,
 }
 void pilot_outfitLOndeath( Pilot *pilot )
 {
-   pilot_outfitLRun( pilot, outfitLOndeath, NULL );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_ONDEATH, outfitLOndeath, NULL );
 }
 
 typedef struct OnanyimpactData {
@@ -2612,5 +2873,6 @@ void pilot_outfitLOnanyimpact( Pilot *pilot, Pilot *target, const Solid *w,
       .w = w,
       .o = o,
    };
-   pilot_outfitLRun( pilot, outfitLOnanyimpact, &data );
+   pilot_outfitLRun( pilot, PILOT_OUTFITL_ONANYIMPACT, outfitLOnanyimpact,
+                     &data );
 }
@@ -69,6 +69,7 @@ void pilot_lockClear( Pilot *p );
 
 /* Other. */
 void             pilot_calcStats( Pilot *pilot );
+void             pilot_calcStatsDirty( Pilot *pilot, unsigned int layers );
 double           pilot_massFactor( const Pilot *pilot );
 void             pilot_updateMass( Pilot *pilot );
 void             pilot_healLanded( Pilot *pilot );
@@ -83,6 +84,7 @@ int  pilot_outfitLAdd( Pilot *pilot, PilotOutfitSlot *po );
 int  pilot_outfitLRemove( Pilot *pilot, PilotOutfitSlot *po );
 void pilot_outfitLOutfitChange( Pilot *pilot );
 void pilot_outfitLInitAll( Pilot *pilot );
+void pilot_outfitLFree( Pilot *p );
 void pilot_outfitLInit( Pilot *pilot, PilotOutfitSlot *po );
 void pilot_outfitLUpdate( Pilot *pilot, double dt );
 void pilot_outfitLOutfofenergy( Pilot *pilot );
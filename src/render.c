@@ -4,6 +4,8 @@
 #include "render.h"
 
 #include "array.h"
+#include "asteroid.h"
+#include "camera.h"
 #include "conf.h"
 #include "gui.h"
 #include "hook.h"
@@ -53,6 +55,9 @@ static PPShader *pp_shaders_list[PP_LAYER_MAX]; /**< Post-processing shaders for
 static LuaShader_t gamma_correction_shader;
 static int         pp_gamma_correction = 0; /**< Gamma correction shader. */
 
+#define RENDER_CULL_MARGIN 100. /**< Screen margin kept when culling. */
+static RenderCullStats render_cull_stats; /**< Last culling pass counters. */
+
 /**
  * @brief Renders an FBO.
  */
@@ -149,6 +154,48 @@ static void render_fbo_list( double dt, PPShader *list, int *current, int done )
    *current = cur;
 }
 
+/**
+ * @brief Builds the lists of objects that are visible this frame.
+ *
+ * Pilots, weapons and asteroids are tested once against the camera view before
+ * anything is rendered, and their renderers only go over what passed.
+ */
+static void render_cull( void )
+{
+   RenderView view;
+   double     cx, cy, z, hw, hh;
+
+   NTracingZone( _ctx, 1 );
+
+   memset( &render_cull_stats, 0, sizeof( RenderCullStats ) );
+
+   /* Same transformation as gl_gameToScreenCoords(), with some margin. */
+   cam_getPos( &cx, &cy );
+   z       = cam_getZoom();
+   hw      = ( SCREEN_W * 0.5 + RENDER_CULL_MARGIN ) / z;
+   hh      = ( SCREEN_H * 0.5 + RENDER_CULL_MARGIN ) / z;
+   view.x1 = cx - hw;
+   view.y1 = cy - hh;
+   view.x2 = cx + hw;
+   view.y2 = cy + hh;
+
+   pilots_cull( &view, &render_cull_stats );
+   weapons_cull( &view, &render_cull_stats );
+   asteroids_cull( &view, &render_cull_stats );
+
+   NTracingZoneEnd( _ctx );
+}
+
+/**
+ * @brief Gets the counters of the last visibility culling pass.
+ *
+ *    @param[out] stats Where to write the counters.
+ */
+void render_cullStats( RenderCullStats *stats )
+{
+   *stats = render_cull_stats;
+}
+
 /**
  * @brief Renders the game itself (player flying around and friends).
  *
@@ -217,6 +264,9 @@ void render_all( double game_dt, double real_dt )
    hooks_run( "renderbg" );
    NTracingZoneEnd( _ctx_renderbg );
    render_reset();
+   /* Figure out what is visible, once the background hooks are done moving
+    * things around. */
+   render_cull();
    spobs_render();
    spfx_render( SPFX_LAYER_BACK, dt );
    weapons_render( WEAPON_LAYER_BG, dt );
@@ -18,10 +18,49 @@ enum {
 #define PP_SHADER_PERMANENT                                                    \
    ( 1 << 0 ) /**< Shader doesn't get removed on main menu / death. */
 
+/**
+ * @brief Region of the game world that is visible, in game coordinates.
+ */
+typedef struct RenderView_ {
+   double x1; /**< Left edge. */
+   double y1; /**< Bottom edge. */
+   double x2; /**< Right edge. */
+   double y2; /**< Top edge. */
+} RenderView;
+
+/**
+ * @brief Counters of the visibility culling pass for the last frame.
+ */
+typedef struct RenderCullStats_ {
+   int pilots_drawn;     /**< Pilots passed on to be rendered. */
+   int pilots_culled;    /**< Pilots skipped for being out of view. */
+   int weapons_drawn;    /**< Weapons passed on to be rendered. */
+   int weapons_culled;   /**< Weapons skipped for being out of view. */
+   int asteroids_drawn;  /**< Asteroids passed on to be rendered. */
+   int asteroids_culled; /**< Asteroids skipped for being out of view. */
+} RenderCullStats;
+
+/**
+ * @brief Checks to see if a circle is completely outside of a view.
+ *
+ *    @param v View to check against.
+ *    @param x X position of the circle.
+ *    @param y Y position of the circle.
+ *    @param r Radius of the circle.
+ *    @return 1 if it can be culled, 0 otherwise.
+ */
+static inline int render_viewOutside( const RenderView *v, double x, double y,
+                                      double r )
+{
+   return ( ( x + r < v->x1 ) || ( x - r > v->x2 ) || ( y + r < v->y1 ) ||
+            ( y - r > v->y2 ) );
+}
+
 void fps_setPos( double x, double y );
 void render_all( double game_dt, double real_dt );
 void render_init( void );
 void render_exit( void );
+void render_cullStats( RenderCullStats *stats );
 
 unsigned int render_postprocessAdd( LuaShader_t *shader, int layer,
                                     int priority, unsigned int flags );
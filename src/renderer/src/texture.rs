@@ -4,10 +4,14 @@ use log::{warn, warn_err};
 use nalgebra::{Matrix3, Vector4};
 use sdl3 as sdl;
 use std::boxed::Box;
+use std::collections::{HashMap, VecDeque};
 use std::ffi::{CStr, CString};
+use std::hash::{BuildHasher, RandomState};
 use std::num::NonZero;
 use std::os::raw::{c_char, c_double, c_float, c_int, c_uint};
-use std::sync::{atomic::AtomicU32, Arc, LazyLock, Mutex, MutexGuard, Weak};
+use std::sync::atomic::{AtomicU32, AtomicU64, Ordering};
+use std::sync::{Arc, LazyLock, Mutex, RwLock, Weak};
+use std::time::{Duration, Instant};
 
 use crate::buffer;
 use crate::{
@@ -15,12 +19,137 @@ use crate::{
 };
 
 /// All the shared texture data to look up
-pub static TEXTURE_DATA: LazyLock<Mutex<Vec<Weak<TextureData>>>> =
-    LazyLock::new(|| Mutex::new(Default::default()));
+pub static TEXTURE_CACHE: LazyLock<TextureCache> = LazyLock::new(TextureCache::new);
 /// Counter for how many textures were destroyed
 pub static GC_COUNTER: AtomicU32 = AtomicU32::new(0);
 /// Number of destroyed textures to start garbage collecting the cache
 pub const GC_THRESHOLD: u32 = 128;
+/// Number of shards of the texture cache, has to be a power of two
+const CACHE_SHARDS: usize = 16;
+
+/// Shared texture data cache, indexed by name.
+///
+/// Each name maps to the variants loaded with different flags (sRGB, flipped, mipmaps, SDF).
+/// The cache is split into shards, each behind its own RwLock, so that lookups don't block
+/// each other and loaders only contend when touching names in the same shard.
+pub struct TextureCache {
+    hasher: RandomState,
+    shards: [RwLock<HashMap<String, Vec<Weak<TextureData>>>>; CACHE_SHARDS],
+    /// Lookups that found a live texture
+    hits: AtomicU64,
+    /// Lookups that found nothing
+    misses: AtomicU64,
+    /// Textures that were added to the cache
+    inserts: AtomicU64,
+    /// Dead references that were removed from the cache
+    evictions: AtomicU64,
+}
+impl TextureCache {
+    fn new() -> Self {
+        TextureCache {
+            hasher: RandomState::new(),
+            shards: std::array::from_fn(|_| RwLock::new(HashMap::new())),
+            hits: AtomicU64::new(0),
+            misses: AtomicU64::new(0),
+            inserts: AtomicU64::new(0),
+            evictions: AtomicU64::new(0),
+        }
+    }
+
+    fn shard(&self, name: &str) -> &RwLock<HashMap<String, Vec<Weak<TextureData>>>> {
+        let idx = (self.hasher.hash_one(name) as usize) & (CACHE_SHARDS - 1);
+        &self.shards[idx]
+    }
+
+    fn count(&self, found: &Option<Arc<TextureData>>) {
+        match found {
+            Some(_) => self.hits.fetch_add(1, Ordering::Relaxed),
+            None => self.misses.fetch_add(1, Ordering::Relaxed),
+        };
+    }
+
+    /// Gets any live texture data with a name, irregardless of flags.
+    fn get(&self, name: &str) -> Option<Arc<TextureData>> {
+        let found = self
+            .shard(name)
+            .read()
+            .unwrap()
+            .get(name)
+            .and_then(|v| v.iter().find_map(|t| t.upgrade()));
+        self.count(&found);
+        found
+    }
+
+    /// Gets the live texture data matching both name and flags.
+    fn search(&self, s: &TextureSearch) -> Option<Arc<TextureData>> {
+        let found = self
+            .shard(s.name)
+            .read()
+            .unwrap()
+            .get(s.name)
+            .and_then(|v| v.iter().filter_map(|t| t.upgrade()).find(|t| s.matches(t)));
+        self.count(&found);
+        found
+    }
+
+    /// Adds texture data to the cache. If another thread added an equivalent texture while
+    /// this one was being loaded, that one is returned instead so there is a single copy.
+    fn insert(&self, s: &TextureSearch, tex: Arc<TextureData>) -> Arc<TextureData> {
+        let mut shard = self.shard(s.name).write().unwrap();
+        let variants = shard.entry(String::from(s.name)).or_default();
+        if let Some(t) = variants
+            .iter()
+            .filter_map(|t| t.upgrade())
+            .find(|t| s.matches(t))
+        {
+            return t;
+        }
+        let len = variants.len();
+        variants.retain(|t| t.strong_count() > 0);
+        self.evictions
+            .fetch_add((len - variants.len()) as u64, Ordering::Relaxed);
+        variants.push(Arc::downgrade(&tex));
+        self.inserts.fetch_add(1, Ordering::Relaxed);
+        tex
+    }
+
+    /// Removes all the dead references from the cache.
+    pub fn gc(&self) {
+        let mut evicted = 0;
+        for shard in self.shards.iter() {
+            let mut shard = shard.write().unwrap();
+            shard.retain(|_, variants| {
+                let len = variants.len();
+                variants.retain(|t| t.strong_count() > 0);
+                evicted += len - variants.len();
+                !variants.is_empty()
+            });
+        }
+        self.evictions.fetch_add(evicted as u64, Ordering::Relaxed);
+    }
+
+    /// Gets the current statistics of the cache.
+    pub fn stats(&self) -> naevc::glTexCacheStats {
+        let (mut names, mut entries, mut live) = (0, 0, 0);
+        for shard in self.shards.iter() {
+            let shard = shard.read().unwrap();
+            names += shard.len();
+            for variants in shard.values() {
+                entries += variants.len();
+                live += variants.iter().filter(|t| t.strong_count() > 0).count();
+            }
+        }
+        naevc::glTexCacheStats {
+            hits: self.hits.load(Ordering::Relaxed),
+            misses: self.misses.load(Ordering::Relaxed),
+            inserts: self.inserts.load(Ordering::Relaxed),
+            evictions: self.evictions.load(Ordering::Relaxed),
+            names: names as u64,
+            entries: entries as u64,
+            live: live as u64,
+        }
+    }
+}
 
 #[allow(clippy::upper_case_acronyms)]
 #[derive(Clone, Copy, Debug)]
@@ -80,6 +209,15 @@ struct TextureSearch<'a> {
     mipmaps: bool,
     sdf: bool,
 }
+impl TextureSearch<'_> {
+    /// Whether or not the texture data was created with the same flags.
+    fn matches(&self, t: &TextureData) -> bool {
+        self.srgb == t.srgb
+            && self.flipv == t.flipv
+            && self.mipmaps == t.mipmaps
+            && self.sdf == t.sdf
+    }
+}
 
 #[derive(Debug)]
 pub struct TextureData {
@@ -149,47 +287,7 @@ impl TextureData {
 
     /// Checks to see if a TextureData exists.
     fn exists(name: &str) -> Option<Arc<Self>> {
-        let textures = TEXTURE_DATA.lock().unwrap();
-        Self::exists_textures(name, &textures)
-    }
-
-    /// Checks to see if a TextureData exists.
-    fn exists_textures(
-        name: &str,
-        textures: &MutexGuard<'_, Vec<Weak<TextureData>>>,
-    ) -> Option<Arc<Self>> {
-        for tex in textures.iter() {
-            if let Some(t) = tex.upgrade() {
-                if let Some(tname) = &t.name {
-                    if tname == name {
-                        return Some(t);
-                    }
-                }
-            }
-        }
-        None
-    }
-
-    /// Searches to see if a TextureData exists, not only considering name
-    fn search_textures(
-        s: &TextureSearch,
-        textures: &MutexGuard<'_, Vec<Weak<TextureData>>>,
-    ) -> Option<Arc<Self>> {
-        for tex in textures.iter() {
-            if let Some(t) = tex.upgrade() {
-                if let Some(tname) = &t.name {
-                    if s.name == tname
-                        && s.srgb == t.srgb
-                        && s.flipv == t.flipv
-                        && s.mipmaps == t.mipmaps
-                        && s.sdf == t.sdf
-                    {
-                        return Some(t);
-                    }
-                }
-            }
-        }
-        None
+        TEXTURE_CACHE.get(name)
     }
 
     /// Creates a new TextureData from
@@ -215,57 +313,8 @@ impl TextureData {
         flipv: bool,
         srgb: bool,
     ) -> Result<Self> {
-        let gl = &ctx.gl;
-        let texture = unsafe { gl.create_texture().map_err(|e| anyhow::anyhow!(e)) }?;
-
-        let has_alpha = img.color().has_alpha();
-        let (w, h) = (img.width(), img.height());
-        let img = match flipv {
-            true => &img.flipv(),
-            false => img,
-        };
-
-        let imgdata = match has_alpha {
-            true => img.to_rgba8().into_raw(),
-            false => img.to_rgb8().into_raw(),
-        };
-
-        let internalformat = TextureFormat::auto(has_alpha, srgb);
-        unsafe {
-            gl.bind_texture(glow::TEXTURE_2D, Some(texture));
-            let gldata = glow::PixelUnpackData::Slice(Some(imgdata.as_slice()));
-            let fmt = match has_alpha {
-                true => glow::RGBA,
-                false => glow::RGB,
-            };
-            gl.tex_image_2d(
-                glow::TEXTURE_2D,
-                0,
-                internalformat,
-                w as i32,
-                h as i32,
-                0,
-                fmt,
-                glow::UNSIGNED_BYTE,
-                gldata,
-            );
-            if gl.supports_debug() {
-                gl.object_label(glow::TEXTURE, texture.0.into(), name);
-            }
-            gl.bind_texture(glow::TEXTURE_2D, None);
-        }
-
-        Ok(TextureData {
-            name: name.map(String::from),
-            w: w as usize,
-            h: h as usize,
-            texture,
-            srgb,
-            sdf: false,
-            mipmaps: false,
-            vmax: 1.,
-            flipv,
-        })
+        let decoded = DecodedImage::from_image(img, flipv, false)?;
+        Self::from_decoded(ctx, name, &decoded, flipv, srgb)
     }
 
     /// Creates a new TextureData from an image wrapper
@@ -274,46 +323,65 @@ impl TextureData {
         name: Option<&str>,
         img: &image::DynamicImage,
         flipv: bool,
+    ) -> Result<Self> {
+        let decoded = DecodedImage::from_image(img, flipv, true)?;
+        Self::from_decoded(ctx, name, &decoded, flipv, false)
+    }
+
+    /// Creates a new TextureData by uploading already decoded image data
+    fn from_decoded(
+        ctx: &Context,
+        name: Option<&str>,
+        decoded: &DecodedImage,
+        flipv: bool,
+        srgb: bool,
     ) -> Result<Self> {
         let gl = &ctx.gl;
         let texture = unsafe { gl.create_texture().map_err(|e| anyhow::anyhow!(e)) }?;
 
-        let has_alpha = img.color().has_alpha();
-        if !has_alpha {
-            anyhow::bail!("Trying to create SDF from image without alpha!");
-        }
-        let (w, h) = (img.width(), img.height());
-        let img = match flipv {
-            true => &img.flipv(),
-            false => img,
-        };
-        let (imgdata, vmax) = {
-            // Get only the alpha channel
-            let mut rawdata: Vec<_> = img.to_luma_alpha8().pixels().map(|p| p.0[1]).collect();
-            let mut vmax: f64 = 0.0;
-            // Compute the distance transform
-            let sdfdata = unsafe {
-                let data = naevc::make_distance_mapbf(rawdata.as_mut_ptr(), w, h, &mut vmax);
-                std::slice::from_raw_parts(data, (w * h) as usize)
-            };
-            (sdfdata, vmax)
+        let (w, h, sdf, vmax) = match decoded {
+            DecodedImage::Image { w, h, .. } => (*w, *h, false, 1.),
+            DecodedImage::Sdf { w, h, vmax, .. } => (*w, *h, true, *vmax),
         };
-
         unsafe {
             gl.bind_texture(glow::TEXTURE_2D, Some(texture));
-            let (_prefix, floats, _suffix) = imgdata.align_to::<u8>();
-            let gldata = glow::PixelUnpackData::Slice(Some(floats));
-            gl.tex_image_2d(
-                glow::TEXTURE_2D,
-                0,
-                glow::RED as i32,
-                w as i32,
-                h as i32,
-                0,
-                glow::RED,
-                glow::FLOAT,
-                gldata,
-            );
+            match decoded {
+                DecodedImage::Image {
+                    data, has_alpha, ..
+                } => {
+                    let gldata = glow::PixelUnpackData::Slice(Some(data.as_slice()));
+                    let fmt = match *has_alpha {
+                        true => glow::RGBA,
+                        false => glow::RGB,
+                    };
+                    gl.tex_image_2d(
+                        glow::TEXTURE_2D,
+                        0,
+                        TextureFormat::auto(*has_alpha, srgb),
+                        w as i32,
+                        h as i32,
+                        0,
+                        fmt,
+                        glow::UNSIGNED_BYTE,
+                        gldata,
+                    );
+                }
+                DecodedImage::Sdf { data, .. } => {
+                    let (_prefix, floats, _suffix) = data.align_to::<u8>();
+                    let gldata = glow::PixelUnpackData::Slice(Some(floats));
+                    gl.tex_image_2d(
+                        glow::TEXTURE_2D,
+                        0,
+                        glow::RED as i32,
+                        w as i32,
+                        h as i32,
+                        0,
+                        glow::RED,
+                        glow::FLOAT,
+                        gldata,
+                    );
+                }
+            }
             if gl.supports_debug() {
                 gl.object_label(glow::TEXTURE, texture.0.into(), name);
             }
@@ -322,13 +390,13 @@ impl TextureData {
 
         Ok(TextureData {
             name: name.map(String::from),
-            w: w as usize,
-            h: h as usize,
+            w,
+            h,
             texture,
-            srgb: false,
-            sdf: true,
+            srgb: srgb && !sdf,
+            sdf,
             mipmaps: false,
-            vmax: vmax as f32,
+            vmax,
             flipv,
         })
     }
@@ -344,6 +412,80 @@ impl TextureData {
     }
 }
 
+/// Image data decoded on the CPU, ready to be uploaded to the GPU
+pub enum DecodedImage {
+    Image {
+        data: Vec<u8>,
+        w: usize,
+        h: usize,
+        has_alpha: bool,
+    },
+    Sdf {
+        data: Vec<f32>,
+        w: usize,
+        h: usize,
+        vmax: f32,
+    },
+}
+impl DecodedImage {
+    /// Converts an image into raw data, computing the distance transform if necessary.
+    pub fn from_image(img: &image::DynamicImage, flipv: bool, sdf: bool) -> Result<Self> {
+        let has_alpha = img.color().has_alpha();
+        let (w, h) = (img.width(), img.height());
+        let img = match flipv {
+            true => &img.flipv(),
+            false => img,
+        };
+
+        if !sdf {
+            let data = match has_alpha {
+                true => img.to_rgba8().into_raw(),
+                false => img.to_rgb8().into_raw(),
+            };
+            return Ok(DecodedImage::Image {
+                data,
+                w: w as usize,
+                h: h as usize,
+                has_alpha,
+            });
+        }
+
+        if !has_alpha {
+            anyhow::bail!("Trying to create SDF from image without alpha!");
+        }
+        // Get only the alpha channel
+        let mut rawdata: Vec<_> = img.to_luma_alpha8().pixels().map(|p| p.0[1]).collect();
+        let mut vmax: f64 = 0.0;
+        // Compute the distance transform
+        let data = unsafe {
+            let data = naevc::make_distance_mapbf(rawdata.as_mut_ptr(), w, h, &mut vmax);
+            if data.is_null() {
+                anyhow::bail!("Failed to compute the distance transform!");
+            }
+            // Copied so the buffer malloc'd by C can be freed right away
+            let out = std::slice::from_raw_parts(data, (w * h) as usize).to_vec();
+            naevc::free(data as *mut std::ffi::c_void);
+            out
+        };
+        Ok(DecodedImage::Sdf {
+            data,
+            w: w as usize,
+            h: h as usize,
+            vmax: vmax as f32,
+        })
+    }
+
+    /// Loads and decodes an image from the virtual filesystem.
+    pub fn from_path(path: &str, flipv: bool, sdf: bool) -> Result<Self> {
+        let cpath = ndata::simplify_path(path)?;
+        let rw = ndata::iostream(&cpath)?;
+        let img = image::ImageReader::new(std::io::BufReader::new(rw))
+            .with_guessed_format()?
+            .decode()?;
+        Self::from_image(&img, flipv, sdf)
+    }
+}
+
 #[derive(Debug)]
 pub struct Texture {
     pub path: Option<String>,
@@ -658,18 +800,16 @@ impl TextureSource {
             return Ok(tex.clone());
         };
 
-        let mut textures = TEXTURE_DATA.lock().unwrap();
-
         // Try to see if a texture that matches everything already exists
-        if let Some(name) = name {
-            let search = TextureSearch {
-                name,
-                srgb,
-                flipv,
-                mipmaps,
-                sdf,
-            };
-            if let Some(t) = TextureData::search_textures(&search, &textures) {
+        let search = name.map(|name| TextureSearch {
+            name,
+            srgb,
+            flipv,
+            mipmaps,
+            sdf,
+        });
+        if let Some(search) = &search {
+            if let Some(t) = TEXTURE_CACHE.search(search) {
                 return Ok(t);
             }
         }
@@ -678,16 +818,9 @@ impl TextureSource {
         let tex = Arc::new({
             let mut inner = match self {
                 TextureSource::Path(path) => {
-                    let cpath = ndata::simplify_path(path)?;
-                    let rw = ndata::iostream(&cpath)?;
-                    let img = image::ImageReader::new(std::io::BufReader::new(rw))
-                        .with_guessed_format()?
-                        .decode()?;
+                    let decoded = DecodedImage::from_path(path, flipv, sdf)?;
                     let ctx = &sctx.lock();
-                    match sdf {
-                        true => TextureData::from_image_sdf(ctx, name, &img, flipv)?,
-                        false => TextureData::from_image(ctx, name, &img, flipv, srgb)?,
-                    }
+                    TextureData::from_decoded(ctx, name, &decoded, flipv, srgb)?
                 }
                 TextureSource::Image(img) => {
                     let ctx = &sctx.lock();
@@ -711,11 +844,10 @@ impl TextureSource {
         });
 
         // Add weak reference to cache
-        if name.is_some() {
-            textures.push(Arc::downgrade(&tex));
+        match &search {
+            Some(search) => Ok(TEXTURE_CACHE.insert(search, tex)),
+            None => Ok(tex),
         }
-
-        Ok(tex)
     }
 }
 
@@ -952,6 +1084,152 @@ impl TextureBuilder {
     }
 }
 
+/// Time budget to spend each frame uploading asynchronously loaded textures
+pub const UPLOAD_BUDGET: Duration = Duration::from_millis(2);
+
+enum RequestState {
+    Pending,
+    Ready(Texture),
+    Failed,
+}
+
+/// Texture that is being loaded in the background.
+///
+/// Decoding (and distance transform for SDF textures) is done on worker threads, while the
+/// upload to the GPU is done on the main thread by `Context::upload_textures`.
+pub struct TextureRequest {
+    state: Mutex<RequestState>,
+}
+impl TextureRequest {
+    /// Whether or not the request has finished, successfully or not.
+    pub fn is_done(&self) -> bool {
+        !matches!(*self.state.lock().unwrap(), RequestState::Pending)
+    }
+
+    /// Gets a copy of the texture if it has been loaded.
+    pub fn texture(&self) -> Option<Texture> {
+        match &*self.state.lock().unwrap() {
+            RequestState::Ready(tex) => tex.try_clone().ok(),
+            _ => None,
+        }
+    }
+}
+
+/// Decoded image waiting to be uploaded on the main thread
+struct PendingUpload {
+    request: Weak<TextureRequest>,
+    builder: TextureBuilder,
+    decoded: DecodedImage,
+}
+static UPLOAD_QUEUE: Mutex<VecDeque<PendingUpload>> = Mutex::new(VecDeque::new());
+
+impl TextureBuilder {
+    /// Starts loading the texture in the background, only works with a path as source.
+    pub fn build_async(self, ctx: &Context) -> Result<Arc<TextureRequest>> {
+        let path = match &self.source {
+            TextureSource::Path(path) => path.clone(),
+            _ => anyhow::bail!("Asynchronous textures must use Path as source!"),
+        };
+
+        // Already loaded, so no need to go through the worker threads
+        if let Some(name) = &self.name {
+            let search = TextureSearch {
+                name,
+                srgb: self.is_srgb,
+                flipv: self.is_flipv,
+                mipmaps: self.mipmaps,
+                sdf: self.is_sdf,
+            };
+            if let Some(data) = TEXTURE_CACHE.search(&search) {
+                let tex = self.texture_data(&data).build(ctx)?;
+                return Ok(Arc::new(TextureRequest {
+                    state: Mutex::new(RequestState::Ready(tex)),
+                }));
+            }
+        }
+
+        let request = Arc::new(TextureRequest {
+            state: Mutex::new(RequestState::Pending),
+        });
+        let weak = Arc::downgrade(&request);
+        rayon::spawn(move || {
+            // Request was dropped before we got to it
+            if weak.strong_count() == 0 {
+                return;
+            }
+            match DecodedImage::from_path(&path, self.is_flipv, self.is_sdf) {
+                Ok(decoded) => UPLOAD_QUEUE.lock().unwrap().push_back(PendingUpload {
+                    request: weak,
+                    builder: self,
+                    decoded,
+                }),
+                Err(e) => {
+                    warn_err(e.context(format!("unable to load texture '{path}'")));
+                    if let Some(request) = weak.upgrade() {
+                        *request.state.lock().unwrap() = RequestState::Failed;
+                    }
+                }
+            }
+        });
+        Ok(request)
+    }
+}
+
+impl PendingUpload {
+    fn upload(self, ctx: &Context) -> Result<Texture> {
+        let b = &self.builder;
+        let mut data = TextureData::from_decoded(
+            ctx,
+            b.name.as_deref(),
+            &self.decoded,
+            b.is_flipv,
+            b.is_srgb,
+        )?;
+        if b.mipmaps {
+            data.generate_mipmap(&ctx.gl)?;
+        }
+        let mut data = Arc::new(data);
+        if let Some(name) = &b.name {
+            let search = TextureSearch {
+                name,
+                srgb: b.is_srgb,
+                flipv: b.is_flipv,
+                mipmaps: b.mipmaps,
+                sdf: b.is_sdf,
+            };
+            data = TEXTURE_CACHE.insert(&search, data);
+        }
+        self.builder.texture_data(&data).build(ctx)
+    }
+}
+
+impl Context {
+    /// Uploads textures decoded in the background until the time budget is exhausted. At
+    /// least one texture is always uploaded so that progress is made.
+    pub fn upload_textures(&self, budget: Duration) {
+        let start = Instant::now();
+        loop {
+            let Some(pending) = UPLOAD_QUEUE.lock().unwrap().pop_front() else {
+                break;
+            };
+            let Some(request) = pending.request.upgrade() else {
+                continue;
+            };
+            let state = match pending.upload(self) {
+                Ok(tex) => RequestState::Ready(tex),
+                Err(e) => {
+                    warn_err(e.context("unable to upload texture"));
+                    RequestState::Failed
+                }
+            };
+            *request.state.lock().unwrap() = state;
+            if start.elapsed() >= budget {
+                break;
+            }
+        }
+    }
+}
+
 pub struct FramebufferC {
     fb: glow::NativeFramebuffer,
     w: usize,
@@ -1470,6 +1748,74 @@ pub extern "C" fn gl_newSpriteRWops(
     out
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn gl_texRequest(
+    cpath: *const c_char,
+    cflags: c_uint,
+    sx: c_int,
+    sy: c_int,
+) -> *const TextureRequest {
+    let ctx = Context::get();
+    let path = unsafe { CStr::from_ptr(cpath) };
+    let flags = Flags::from(cflags);
+
+    let mut builder = TextureBuilder::new()
+        .path(path.to_str().unwrap())
+        .sx(sx as usize)
+        .sy(sy as usize)
+        .srgb(!flags.notsrgb)
+        .sdf(flags.sdf)
+        .mipmaps(flags.mipmaps);
+
+    if flags.clamp_alpha {
+        builder = builder.border(Some(Vector4::<f32>::new(0., 0., 0., 0.)));
+    }
+
+    match builder.build_async(ctx) {
+        Ok(req) => Arc::into_raw(req),
+        Err(e) => {
+            warn_err(e.context("unable to request texture"));
+            std::ptr::null()
+        }
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn gl_texRequestDup(creq: *const TextureRequest) -> *const TextureRequest {
+    if !creq.is_null() {
+        unsafe { Arc::increment_strong_count(creq) };
+    }
+    creq
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn gl_texRequestDone(creq: *const TextureRequest) -> c_int {
+    if creq.is_null() {
+        return 1;
+    }
+    let req = unsafe { &*creq };
+    req.is_done() as c_int
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn gl_texRequestGet(creq: *const TextureRequest) -> *mut Texture {
+    if creq.is_null() {
+        return std::ptr::null_mut();
+    }
+    let req = unsafe { &*creq };
+    match req.texture() {
+        Some(tex) => tex.into_ptr(),
+        None => std::ptr::null_mut(),
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn gl_texRequestFree(creq: *const TextureRequest) {
+    if !creq.is_null() {
+        let _ = unsafe { Arc::from_raw(creq) };
+    }
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn gl_dupTexture(ctex: *mut Texture) -> *mut Texture {
     if ctex.is_null() {
@@ -1546,6 +1892,13 @@ pub extern "C" fn gl_freeTexture(ctex: *mut Texture) {
     // The texture should get dropped now
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn gl_texCacheStats(stats: *mut naevc::glTexCacheStats) {
+    unsafe {
+        *stats = TEXTURE_CACHE.stats();
+    }
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn tex_tex(ctex: *mut Texture) -> naevc::GLuint {
     let tex = unsafe { &*ctex };
@@ -8,6 +8,8 @@
  */
 /** @cond */
 #include "physfs.h"
+#include <SDL3/SDL_thread.h>
+#include <zlib.h>
 
 #include "naev.h"
 /** @endcond */
@@ -21,13 +23,29 @@
 #include "log.h"
 #include "mission.h"
 #include "ndata.h"
+#include "nfile.h"
 #include "nxml.h"
 #include "player.h"
 #include "plugin.h"
 #include "shiplog.h"
 #include "start.h"
 
+/**
+ * @brief A serialised save being written to disk.
+ */
+typedef struct SaveJob_ {
+   char    *player;   /**< Name of the player, used as the directory. */
+   char    *name;     /**< Name of the save. */
+   xmlChar *buf;      /**< Serialised save. */
+   int      len;      /**< Length of the serialised save. */
+   int      backups;  /**< Number of backups to rotate, 0 to not back up. */
+   int      compress; /**< Whether to compress the save. */
+} SaveJob;
+
 int save_loaded = 0; /**< Just loaded the saved game. */
+static SDL_Thread *save_thread =
+   NULL; /**< Thread writing the last save, if any. */
+static SaveJob *save_job = NULL; /**< Save being written by save_thread. */
 
 /*
  * prototypes
@@ -53,7 +71,12 @@ economy_sysSave( xmlTextWriterPtr writer ); /**< Saves the economy stuff. */
 extern int
 diff_save( xmlTextWriterPtr writer ); /**< Saves the universe diffs. */
 /* static */
-static int save_data( xmlTextWriterPtr writer );
+static int  save_data( xmlTextWriterPtr writer );
+static int  save_game( const char *name, int async );
+static int  save_write( void *data );
+static int  save_compress( const SaveJob *job, char **out, size_t *outlen );
+static void save_freeJob( SaveJob *job );
+static void save_error( void );
 
 /**
  * @brief Saves all the player's game data.
@@ -92,6 +115,9 @@ static int save_data( xmlTextWriterPtr writer )
 /**
  * @brief Saves the current game.
  *
+ * The game is written to disk in the background, use save_wait() to make
+ * sure it is done.
+ *
  *    @return 0 on success.
  */
 int save_all( void )
@@ -99,7 +125,7 @@ int save_all( void )
    /* Don't actually save if we are loading the game still. */
    if ( save_loaded == 0 )
       return 0;
-   return save_all_with_name( "autosave" );
+   return save_game( "autosave", 1 );
 }
 
 /**
@@ -109,21 +135,179 @@ int save_all( void )
  *    @return 0 on success.
  */
 int save_all_with_name( const char *name )
+{
+   return save_game( name, 0 );
+}
+
+/**
+ * @brief Waits for any save being written in the background to finish.
+ *
+ *    @return 0 on success or if nothing was being written.
+ */
+int save_wait( void )
+{
+   int ret;
+
+   if ( save_thread == NULL )
+      return 0;
+
+   SDL_WaitThread( save_thread, &ret );
+   save_thread = NULL;
+
+   save_freeJob( save_job );
+   save_job = NULL;
+
+   return ret;
+}
+
+/**
+ * @brief Frees a save job.
+ */
+static void save_freeJob( SaveJob *job )
+{
+   xmlFree( job->buf );
+   free( job->player );
+   free( job->name );
+   free( job );
+}
+
+/**
+ * @brief Tells the player that saving failed.
+ */
+static void save_error( void )
+{
+   const char *err =
+      _( "Failed to write saved game!  You'll most likely have to restore it "
+         "by copying your backup saved game over your current saved game." );
+   WARN( "%s", err );
+   dialogue_alert( "%s", err );
+}
+
+/**
+ * @brief Writes a serialised save to disk, rotating backups if necessary.
+ *
+ *    @param data Save to write (SaveJob).
+ *    @return 0 on success.
+ */
+static int save_write( void *data )
+{
+   const SaveJob *job = data;
+   char           file[PATH_MAX];
+
+   /* Back up old saved game. */
+   if ( job->backups > 0 ) {
+      char backup[PATH_MAX];
+      for ( int i = job->backups - 1; i > 0; i-- ) {
+         snprintf( file, sizeof( file ), "saves/%s/backup%d.ns", job->player,
+                   i );
+         snprintf( backup, sizeof( backup ), "saves/%s/backup%d.ns",
+                   job->player, i + 1 );
+         if ( ndata_copyIfExists( file, backup ) < 0 ) {
+            WARN( _( "Aborting save…" ) );
+            return -1;
+         }
+      }
+      snprintf( file, sizeof( file ), "saves/%s/%s.ns", job->player,
+                job->name );
+      snprintf( backup, sizeof( backup ), "saves/%s/backup%d.ns", job->player,
+                1 );
+      if ( ndata_copyIfExists( file, backup ) < 0 ) {
+         WARN( _( "Aborting save…" ) );
+         return -1;
+      }
+   }
+
+   /* Replaced atomically so a crash can't leave a corrupt save behind. */
+   snprintf( file, sizeof( file ), "%s/saves/%s/%s.ns", PHYSFS_getWriteDir(),
+             job->player, job->name ); /* TODO: write via physfs */
+   if ( job->compress ) {
+      char  *out;
+      size_t outlen;
+      int    ret;
+      if ( save_compress( job, &out, &outlen ) < 0 ) {
+         WARN( _( "Unable to compress saved game!" ) );
+         return -1;
+      }
+      ret = nfile_writeFileAtomic( out, outlen, file );
+      free( out );
+      return ret;
+   }
+   return nfile_writeFileAtomic( (const char *)job->buf, job->len, file );
+}
+
+/**
+ * @brief Compresses a serialised save with gzip.
+ *
+ * Loading detects the compression from the magic bytes, so compressed and
+ * uncompressed saves can be mixed freely.
+ *
+ *    @param job Save to compress.
+ *    @param[out] out Compressed data (must free).
+ *    @param[out] outlen Length of the compressed data.
+ *    @return 0 on success.
+ */
+static int save_compress( const SaveJob *job, char **out, size_t *outlen )
+{
+   z_stream strm;
+   int      ret;
+
+   memset( &strm, 0, sizeof( strm ) );
+   if ( deflateInit2( &strm, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8,
+                      Z_DEFAULT_STRATEGY ) != Z_OK )
+      return -1;
+
+   /* Done in a single go, the bound includes the gzip header. */
+   *outlen        = deflateBound( &strm, job->len );
+   *out           = malloc( *outlen );
+   strm.next_in   = job->buf;
+   strm.avail_in  = job->len;
+   strm.next_out  = (unsigned char *)*out;
+   strm.avail_out = *outlen;
+   ret            = deflate( &strm, Z_FINISH );
+   *outlen        = strm.total_out;
+   deflateEnd( &strm );
+
+   if ( ret != Z_STREAM_END ) {
+      free( *out );
+      *out = NULL;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * @brief Saves the current game.
+ *
+ * The game state is serialised to memory here, while the slow part of
+ * touching the disk is done by save_write(), optionally in a thread.
+ *
+ *    @param name Name of the save.
+ *    @param async Whether to write the save in the background.
+ *    @return 0 on success.
+ */
+static int save_game( const char *name, int async )
 {
    char             file[PATH_MAX];
    const plugin_t  *plugins = plugin_list();
-   xmlDocPtr        doc;
+   xmlBufferPtr     buf;
    xmlTextWriterPtr writer;
-   const char      *err;
+   SaveJob         *job;
 
    /* Do not save if saving is off. */
    if ( player_isFlag( PLAYER_NOSAVE ) )
       return 0;
 
-   /* Create the writer. */
-   writer = xmlNewTextWriterDoc( &doc, 0 );
-   if ( writer == NULL )
+   /* Only one save can be written at a time. */
+   if ( save_wait() < 0 )
+      save_error();
+
+   /* Create the writer, streaming straight to memory without a tree. */
+   buf = xmlBufferCreate();
+   if ( buf == NULL )
       goto err_ret;
+   writer = xmlNewTextWriterMemory( buf, 0 );
+   if ( writer == NULL )
+      goto err;
 
    /* Set the writer parameters. */
    xmlw_setParams( writer );
@@ -156,13 +340,14 @@ int save_all_with_name( const char *name )
    /* Finish element. */
    xmlw_endElem( writer ); /* "naev_save" */
    xmlw_done( writer );
+   xmlFreeTextWriter( writer );
 
    /* Write to file. */
    if ( PHYSFS_mkdir( "saves" ) == 0 ) {
       snprintf( file, sizeof( file ), "%s/saves", PHYSFS_getWriteDir() );
       WARN( _( "Dir '%s' does not exist and unable to create: %s" ), file,
             _( PHYSFS_getErrorByCode( PHYSFS_getLastErrorCode() ) ) );
-      goto err_writer;
+      goto err;
    }
    snprintf( file, sizeof( file ), "saves/%s", player.name );
    if ( PHYSFS_mkdir( file ) == 0 ) {
@@ -170,54 +355,52 @@ int save_all_with_name( const char *name )
                 player.name );
       WARN( _( "Dir '%s' does not exist and unable to create: %s" ), file,
             _( PHYSFS_getErrorByCode( PHYSFS_getLastErrorCode() ) ) );
-      goto err_writer;
+      goto err;
    }
 
-   /* Back up old saved game. */
-   if ( strcmp( name, "autosave" ) == 0 ) {
-      char backup[PATH_MAX];
-      // for (int i=0; i<conf.num_backups-1; i++) {
-      for ( int i = conf.num_backups - 1; i > 0; i-- ) {
-         snprintf( file, sizeof( file ), "saves/%s/backup%d.ns", player.name,
-                   i );
-         snprintf( backup, sizeof( backup ), "saves/%s/backup%d.ns",
-                   player.name, i + 1 );
-         if ( ndata_copyIfExists( file, backup ) < 0 ) {
-            WARN( _( "Aborting save…" ) );
-            goto err_writer;
-         }
-      }
-      snprintf( file, sizeof( file ), "saves/%s/autosave.ns", player.name );
-      snprintf( backup, sizeof( backup ), "saves/%s/backup%d.ns", player.name,
-                1 );
-      if ( ndata_copyIfExists( file, backup ) < 0 ) {
-         WARN( _( "Aborting save…" ) );
-         goto err_writer;
+   /* Hand over the serialised save, the rest doesn't need the game state. */
+   job           = calloc( 1, sizeof( SaveJob ) );
+   job->player   = strdup( player.name );
+   job->name     = strdup( name );
+   job->backups  = ( strcmp( name, "autosave" ) == 0 ) ? conf.num_backups : 0;
+   job->compress = conf.save_compress;
+   job->len      = xmlBufferLength( buf );
+   job->buf      = xmlBufferDetach( buf );
+   xmlBufferFree( buf );
+   if ( job->buf == NULL ) {
+      save_freeJob( job );
+      goto err_ret;
+   }
+
+   /* Start writing, falling back to doing it here if no thread. */
+   save_thread = SDL_CreateThread( save_write, "save_write", job );
+   if ( save_thread == NULL ) {
+      int ret;
+      WARN( _( "Unable to create thread: %s" ), SDL_GetError() );
+      ret = save_write( job );
+      save_freeJob( job );
+      if ( ret < 0 ) {
+         save_error();
+         return -1;
       }
+      return 0;
    }
+   save_job = job;
 
-   /* Critical section, if crashes here player's game gets corrupted.
-    * Luckily we have a copy just in case... */
-   xmlFreeTextWriter( writer );
-   snprintf( file, sizeof( file ), "%s/saves/%s/%s.ns", PHYSFS_getWriteDir(),
-             player.name, name ); /* TODO: write via physfs */
-   if ( xmlSaveFileEnc( file, doc, "UTF-8" ) < 0 ) {
-      goto err;
+   /* Synchronous saves have to be written before returning. */
+   if ( !async && ( save_wait() < 0 ) ) {
+      save_error();
+      return -1;
    }
-   xmlFreeDoc( doc );
 
    return 0;
 
 err_writer:
    xmlFreeTextWriter( writer );
 err:
-   xmlFreeDoc( doc );
+   xmlBufferFree( buf );
 err_ret:
-   err =
-      _( "Failed to write saved game!  You'll most likely have to restore it "
-         "by copying your backup saved game over your current saved game." );
-   WARN( "%s", err );
-   dialogue_alert( "%s", err );
+   save_error();
    return -1;
 }
 
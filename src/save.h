@@ -5,4 +5,5 @@
 
 int  save_all( void );
 int  save_all_with_name( const char *name );
+int  save_wait( void );
 void save_reload( void );
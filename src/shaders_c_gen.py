@@ -47,14 +47,15 @@ class Shader:
 
 num_simpleshaders = 0
 class SimpleShader(Shader):
-    def __init__(self, name, fs_path):
+    def __init__(self, name, fs_path, batch=False):
         super().__init__( name=name, vs_path="project_pos.vert", fs_path=fs_path, attributes=["vertex"], uniforms=["projection","colour","dimensions","dt","paramf","parami","paramv"], subroutines={} )
+        self.batch = batch
         global num_simpleshaders
         num_simpleshaders += 1
     def header_chunks(self):
         yield f"   SimpleShader {self.name};\n"
     def source_chunks(self):
-        yield f"   shaders_loadSimple( \"{self.name}\", &shaders.{self.name}, \"{self.fs_path}\" );"
+        yield f"   shaders_loadSimple( \"{self.name}\", &shaders.{self.name}, \"{self.fs_path}\", {int(self.batch)} );"
 
 SHADERS = [
    Shader(
@@ -120,6 +121,13 @@ SHADERS = [
       attributes = ["vertex"],
       uniforms = ["projection", "colour", "tex_mat", "sampler1", "sampler2", "inter"],
    ),
+   Shader(
+      name = "texture_batch",
+      vs_path = "texture_batch.vert",
+      fs_path = "texture_batch.frag",
+      attributes = ["vertex", "rect", "tex_rect", "colour", "inter"],
+      uniforms = ["projection", "sampler1", "sampler2"],
+   ),
    Shader(
       name = "texturesdf",
       vs_path = "texturesdf.vert",
@@ -274,42 +282,52 @@ SHADERS = [
    SimpleShader(
       name = "spobmarker_empty",
       fs_path = "spobmarker_empty.frag",
+      batch = True,
    ),
    SimpleShader(
       name = "spobmarker_earth",
       fs_path = "spobmarker_earth.frag",
+      batch = True,
    ),
    SimpleShader(
       name = "spobmarker_uninhabited",
       fs_path = "spobmarker_uninhabited.frag",
+      batch = True,
    ),
    SimpleShader(
       name = "spobmarker_rhombus",
       fs_path = "spobmarker_rhombus.frag",
+      batch = True,
    ),
    SimpleShader(
       name = "spobmarker_triangle",
       fs_path = "spobmarker_triangle.frag",
+      batch = True,
    ),
    SimpleShader(
       name = "spobmarker_wormhole",
       fs_path = "spobmarker_wormhole.frag",
+      batch = True,
    ),
    SimpleShader(
       name = "spobmarker_obelisk",
       fs_path = "spobmarker_obelisk.frag",
+      batch = True,
    ),
    SimpleShader(
       name = "jumpmarker",
       fs_path = "jumpmarker.frag",
+      batch = True,
    ),
    SimpleShader(
       name = "pilotmarker",
       fs_path = "pilotmarker.frag",
+      batch = True,
    ),
    SimpleShader(
       name = "pilotscanning",
       fs_path = "pilotscanning.frag",
+      batch = True,
    ),
    SimpleShader(
       name = "playermarker",
@@ -318,6 +336,7 @@ SHADERS = [
    SimpleShader(
       name = "blinkmarker",
       fs_path = "blinkmarker.frag",
+      batch = True,
    ),
    SimpleShader(
       name = "sysmarker",
@@ -330,6 +349,7 @@ SHADERS = [
    SimpleShader(
       name = "asteroidmarker",
       fs_path = "asteroidmarker.frag",
+      batch = True,
    ),
    SimpleShader(
       name = "targetship",
@@ -386,6 +406,7 @@ SHADERS = [
    SimpleShader(
       name = "hilight",
       fs_path = "hilight.frag",
+      batch = True,
    ),
    SimpleShader(
       name = "hilight_circle",
@@ -441,6 +462,15 @@ typedef struct SimpleShader_ {{
    GLuint parami;
    GLuint paramf;
    GLuint paramv;
+   struct {{
+      GLuint program; /* Instanced variant, 0 if the shader isn't batchable. */
+      GLuint vertex;
+      GLuint centre;
+      GLuint size;
+      GLuint tint;
+      GLuint projection;
+      GLuint dt;
+   }} batch;
 }} SimpleShader;
 
 typedef struct Shaders_ {{
@@ -478,7 +508,7 @@ static int shaders_cmp( const void *p1, const void *p2 )
    return strcmp( (*s1)->name, (*s2)->name );
 }
 
-static int shaders_loadSimple( const char *name, SimpleShader *shd, const char *fs_path )
+static int shaders_loadSimple( const char *name, SimpleShader *shd, const char *fs_path, int batch )
 {
    shd->name   = name;
    shd->program = gl_program_vert_frag( "project_pos.vert", fs_path );
@@ -491,6 +521,17 @@ static int shaders_loadSimple( const char *name, SimpleShader *shd, const char *
    shd->parami = glGetUniformLocation( shd->program, "parami" );
    shd->paramv = glGetUniformLocation( shd->program, "paramv" );
 
+   /* Instanced variant, the fragment shader has to include marker_params.glsl. */
+   if (batch) {
+      shd->batch.program = gl_program_backend( "project_pos_batch.vert", fs_path, "#define MARKER_BATCH 1\\n" );
+      shd->batch.vertex = glGetAttribLocation( shd->batch.program, "vertex" );
+      shd->batch.centre = glGetAttribLocation( shd->batch.program, "centre" );
+      shd->batch.size   = glGetAttribLocation( shd->batch.program, "size" );
+      shd->batch.tint   = glGetAttribLocation( shd->batch.program, "tint" );
+      shd->batch.projection = glGetUniformLocation( shd->batch.program, "projection" );
+      shd->batch.dt     = glGetUniformLocation( shd->batch.program, "dt" );
+   }
+
    /* Add to list. */
    shaders.simple_shaders[ nsimpleshaders++ ] = shd;
 
@@ -528,6 +569,8 @@ void shaders_unload (void) {
 """
     for shader in SHADERS:
         yield f"   glDeleteProgram(shaders.{shader.name}.program);\n"
+        if isinstance(shader, SimpleShader) and shader.batch:
+            yield f"   glDeleteProgram(shaders.{shader.name}.batch.program);\n"
 
     yield """   memset(&shaders, 0, sizeof(shaders));
    nsimpleshaders = 0;
@@ -66,6 +66,34 @@ static GLuint       ship_texd[SHIP_FBO] = { GL_INVALID_ENUM };
 static const double ship_aa_scale_base  = 2.;
 static double       ship_aa_scale       = -1.;
 
+#define SHIP_IMPOSTOR_DIRS 64 /**< Quantised headings, at most 64 for masks. */
+#define SHIP_IMPOSTOR_COLS 8  /**< Columns of cells in an impostor atlas. */
+#define SHIP_IMPOSTOR_ROWS                                                     \
+   ( 2 * SHIP_IMPOSTOR_DIRS / SHIP_IMPOSTOR_COLS ) /**< Body, then engine. */
+#define SHIP_IMPOSTOR_SIZE 64. /**< Largest on-screen size using impostors. */
+#define SHIP_IMPOSTOR_BPP 8    /**< Colour and depth bytes per atlas pixel. */
+#define SHIP_IMPOSTOR_BUDGET                                                   \
+   ( 128 * 1024 * 1024 ) /**< Bytes of atlases to keep before evicting. */
+#define SHIP_IMPOSTOR_KEEP                                                     \
+   1000 /**< Atlases used this recently (ms) are never evicted. */
+
+/**
+ * @brief Atlas of a 3D ship pre-rendered at quantised headings.
+ */
+typedef struct ShipImpostor_ {
+   GLuint       fbo;     /**< Framebuffer of the atlas. */
+   GLuint       tex;     /**< Colour texture of the atlas. */
+   GLuint       depth;   /**< Depth texture of the atlas. */
+   double       size;    /**< Size the ship is rendered at. */
+   GLint        cell;    /**< Size of a cell in pixels. */
+   unsigned int gen;     /**< Lighting generation of the rendered cells. */
+   uint64_t     done[2]; /**< Rendered headings of the body and engine. */
+   size_t       memory;  /**< Estimated GPU memory of the atlas in bytes. */
+   Uint64       used;    /**< Last time the atlas was used (ms). */
+} ShipImpostor;
+static ShipImpostor     *ship_impostors = NULL; /**< Indexed like ship_stack. */
+static ShipImpostorStats ship_impostor_stats;   /**< Impostor cache counters. */
+
 /*
  * Prototypes
  */
@@ -1570,6 +1598,225 @@ void ship_renderFramebuffer( const Ship *s, GLuint fbo, double fw, double fh,
    }
 }
 
+/**
+ * @brief Frees the impostor atlas of a ship.
+ */
+static void ship_impostorFree( ShipImpostor *imp )
+{
+   if ( imp->fbo == 0 )
+      return;
+   glDeleteFramebuffers( 1, &imp->fbo );
+   glDeleteTextures( 1, &imp->tex );
+   glDeleteTextures( 1, &imp->depth );
+   ship_impostor_stats.atlases--;
+   ship_impostor_stats.memory -= imp->memory;
+   memset( imp, 0, sizeof( ShipImpostor ) );
+}
+
+/**
+ * @brief Frees all the impostor atlases.
+ */
+static void ship_impostorsFree( void )
+{
+   if ( ship_impostors == NULL )
+      return;
+   for ( int i = 0; i < array_size( ship_stack ); i++ )
+      ship_impostorFree( &ship_impostors[i] );
+   free( ship_impostors );
+   ship_impostors = NULL;
+}
+
+/**
+ * @brief Frees the least recently used atlases until a new one fits in the
+ * budget.
+ *
+ *    @param memory Memory needed by the new atlas in bytes.
+ *    @param now Current time (ms).
+ *    @return 0 if there is room, -1 if only recently used atlases are left.
+ */
+static int ship_impostorEvict( size_t memory, Uint64 now )
+{
+   while ( ship_impostor_stats.memory + memory > SHIP_IMPOSTOR_BUDGET ) {
+      ShipImpostor *lru = NULL;
+      for ( int i = 0; i < array_size( ship_stack ); i++ ) {
+         ShipImpostor *imp = &ship_impostors[i];
+         if ( ( imp->fbo != 0 ) &&
+              ( ( lru == NULL ) || ( imp->used < lru->used ) ) )
+            lru = imp;
+      }
+      /* Evicting atlases still on screen would just thrash. */
+      if ( ( lru == NULL ) || ( now - lru->used < SHIP_IMPOSTOR_KEEP ) )
+         return -1;
+      ship_impostorFree( lru );
+      ship_impostor_stats.evictions++;
+   }
+   return 0;
+}
+
+/**
+ * @brief Gets the impostor atlas of a ship, creating it if necessary.
+ *
+ * Cells rendered with a different lighting environment are discarded. Least
+ * recently used atlases are evicted to stay within SHIP_IMPOSTOR_BUDGET.
+ */
+static ShipImpostor *ship_impostorGet( const Ship *s )
+{
+   ShipImpostor *imp;
+   ptrdiff_t     idx = s - ship_stack;
+   Uint64        now = SDL_GetTicks();
+
+   if ( ( idx < 0 ) || ( idx >= array_size( ship_stack ) ) )
+      return NULL;
+   if ( ship_impostors == NULL )
+      ship_impostors =
+         calloc( array_size( ship_stack ), sizeof( ShipImpostor ) );
+   imp = &ship_impostors[idx];
+
+   if ( imp->fbo == 0 ) {
+      GLsizei w, h;
+      double  size = MIN( s->size, SHIP_IMPOSTOR_SIZE );
+      GLint   cell = ceil( size / gl_screen.scale ) + 1;
+      w            = SHIP_IMPOSTOR_COLS * cell;
+      h            = SHIP_IMPOSTOR_ROWS * cell;
+      if ( ship_impostorEvict( (size_t)w * h * SHIP_IMPOSTOR_BPP, now ) )
+         return NULL;
+      imp->size   = size;
+      imp->cell   = cell;
+      imp->memory = (size_t)w * h * SHIP_IMPOSTOR_BPP;
+      gl_fboCreate( &imp->fbo, &imp->tex, w, h );
+      gl_fboAddDepth( imp->fbo, &imp->depth, w, h );
+      imp->gen = gltf_lightGeneration();
+
+      /* Names for debugging. */
+      if ( gl_supportsDebug() ) {
+         char buf[STRMAX_SHORT];
+         snprintf( buf, sizeof( buf ), "Ship Impostor %s", s->name );
+         glObjectLabel( GL_FRAMEBUFFER, imp->fbo, strlen( buf ), buf );
+      }
+      ship_impostor_stats.atlases++;
+      ship_impostor_stats.memory += imp->memory;
+   }
+   imp->used = now;
+
+   if ( imp->gen != gltf_lightGeneration() ) {
+      imp->gen     = gltf_lightGeneration();
+      imp->done[0] = 0;
+      imp->done[1] = 0;
+   }
+   return imp;
+}
+
+/**
+ * @brief Renders a single cell of an impostor atlas.
+ *
+ * The ship is rendered to the scratch screen framebuffer like when rendering
+ * live, and then copied with its depth into the cell.
+ */
+static void ship_impostorRenderCell( ShipImpostor *imp, const Ship *s, int d,
+                                     int engine, GLint cx, GLint cy )
+{
+   double a = 2. * M_PI * (double)d / (double)SHIP_IMPOSTOR_DIRS;
+   mat4   H = mat4_identity();
+
+   mat4_rotate( &H, -a - M_PI_2, 0.0, 1.0, 0.0 );
+   ship_renderFramebuffer3D( s, gl_screen.fbo[2], imp->size, gl_screen.nw,
+                             gl_screen.nh, engine ? 1. : 0., 0., &cWhite,
+                             NULL, &H, 1 );
+
+   glBindFramebuffer( GL_READ_FRAMEBUFFER, gl_screen.fbo[2] );
+   glBindFramebuffer( GL_DRAW_FRAMEBUFFER, imp->fbo );
+   glBlitFramebuffer( 0, 0, imp->cell, imp->cell, cx, cy, cx + imp->cell,
+                      cy + imp->cell, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT,
+                      GL_NEAREST );
+   glBindFramebuffer( GL_FRAMEBUFFER, gl_screen.current_fbo );
+
+   imp->done[engine] |= UINT64_C( 1 ) << d;
+   ship_impostor_stats.cells++;
+   gl_checkErr();
+}
+
+/**
+ * @brief Renders a 3D ship from its impostor atlas.
+ *
+ * Small ships are drawn from a cache of pre-rendered quantised headings
+ * instead of rendering the model every frame. Ships that are large on screen,
+ * tilted, animated or changing engine glow can not use it and have to be
+ * rendered live.
+ *
+ *    @param s Ship to render.
+ *    @param x X position on screen.
+ *    @param y Y position on screen.
+ *    @param w Width on screen.
+ *    @param h Height on screen.
+ *    @param dir Direction the ship is facing.
+ *    @param engine_glow Engine glow of the ship.
+ *    @param tilt Tilt of the ship.
+ *    @param c Colour to modulate the ship with.
+ *    @return 0 if rendered, nonzero if it has to be rendered live.
+ */
+int ship_renderImpostor( const Ship *s, double x, double y, double w, double h,
+                         double dir, double engine_glow, double tilt,
+                         const glColour *c )
+{
+   ShipImpostor *imp;
+   int           d, engine, idx;
+   GLint         cx, cy;
+   double        tw, th, ts;
+   GltfObject   *obj = s->gfx_3d;
+
+   if ( obj == NULL )
+      return -1;
+
+   /* Engine glow only matters if there is an engine scene. */
+   if ( gltf_sceneEngine( obj ) < 0 )
+      engine = 0;
+   else if ( engine_glow <= 0. )
+      engine = 0;
+   else if ( engine_glow >= 1. )
+      engine = 1;
+   else
+      engine = -1;
+
+   if ( ( engine < 0 ) || ( MAX( w, h ) > SHIP_IMPOSTOR_SIZE ) ||
+        ( fabs( tilt ) > DOUBLE_TOL ) || ( gltf_numAnimations( obj ) > 0 ) ) {
+      ship_impostor_stats.misses++;
+      return -1;
+   }
+   imp = ship_impostorGet( s );
+   if ( imp == NULL ) {
+      ship_impostor_stats.misses++;
+      return -1;
+   }
+
+   /* Find the cell. */
+   d = (int)round( dir / ( 2. * M_PI ) * SHIP_IMPOSTOR_DIRS );
+   d = ( ( d % SHIP_IMPOSTOR_DIRS ) + SHIP_IMPOSTOR_DIRS ) % SHIP_IMPOSTOR_DIRS;
+   idx = engine * SHIP_IMPOSTOR_DIRS + d;
+   cx  = ( idx % SHIP_IMPOSTOR_COLS ) * imp->cell;
+   cy  = ( idx / SHIP_IMPOSTOR_COLS ) * imp->cell;
+   if ( !( imp->done[engine] & ( UINT64_C( 1 ) << d ) ) )
+      ship_impostorRenderCell( imp, s, d, engine, cx, cy );
+
+   /* Draw with depth like the live path. */
+   tw = SHIP_IMPOSTOR_COLS * imp->cell;
+   th = SHIP_IMPOSTOR_ROWS * imp->cell;
+   ts = imp->size / gl_screen.scale;
+   gl_renderTextureDepthRaw( imp->tex, imp->depth, 0, x, y, w, h, cx / tw,
+                             cy / th, ts / tw, ts / th, c, 0. );
+   ship_impostor_stats.hits++;
+   return 0;
+}
+
+/**
+ * @brief Gets the counters of the 3D ship impostor cache.
+ *
+ *    @param[out] stats Where to write the counters.
+ */
+void ship_impostorStats( ShipImpostorStats *stats )
+{
+   *stats = ship_impostor_stats;
+}
+
 /**
  * @brief Wrapper for threaded loading.
  */
@@ -1754,6 +2001,9 @@ int ships_load( void )
 
 void ships_resize( void )
 {
+   /* Impostor cells depend on the screen scale. */
+   ship_impostorsFree();
+
    if ( ship_aa_scale > 0. ) {
       for ( int i = 0; i < SHIP_FBO; i++ ) {
          glDeleteFramebuffers( 1, &ship_fbo[i] );
@@ -1794,6 +2044,7 @@ void ships_free( void )
       glDeleteTextures( 1, &ship_tex[i] );
       glDeleteTextures( 1, &ship_texd[i] );
    }
+   ship_impostorsFree();
 
    /* Now ships. */
    for ( int i = 0; i < array_size( ship_stack ); i++ ) {
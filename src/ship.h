@@ -200,6 +200,18 @@ typedef struct Ship {
    int    lua_cooldown;       /**< Run when pilot completely cools down. */
 } Ship;
 
+/**
+ * @brief Counters of the 3D ship impostor cache.
+ */
+typedef struct ShipImpostorStats_ {
+   uint64_t hits;      /**< Ships drawn from an impostor atlas. */
+   uint64_t misses;    /**< 3D ships that had to be rendered live. */
+   uint64_t cells;     /**< Atlas cells rendered. */
+   uint64_t atlases;   /**< Atlases currently allocated. */
+   uint64_t memory;    /**< Estimated GPU memory of the atlases in bytes. */
+   uint64_t evictions; /**< Atlases freed to stay within the budget. */
+} ShipImpostorStats;
+
 /*
  * Load/quit
  */
@@ -228,6 +240,10 @@ void ship_renderFramebuffer( const Ship *s, GLuint fbo, double fw, double fh,
                              double dir, double engine_glow, double tilt,
                              double r, int sx, int sy, const glColour *c,
                              const Lighting *L );
+int  ship_renderImpostor( const Ship *s, double x, double y, double w, double h,
+                          double dir, double engine_glow, double tilt,
+                          const glColour *c );
+void ship_impostorStats( ShipImpostorStats *stats );
 USE_RESULT glTexture *ship_gfxComm( const Ship *s, int size, double tilt,
                                     double dir, const Lighting *Lscene );
 void ship_renderGfxStore( GLuint fbo, const Ship *s, int size, double dir,
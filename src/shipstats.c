@@ -45,6 +45,35 @@ typedef struct ShipStatList {
    } d;         /**< Stat data. */
 } ShipStatList;
 
+/**
+ * @brief How a stat gets merged, used to group the stats of a ShipStatVec.
+ */
+typedef enum ShipStatVecKind_ {
+   SS_VEC_RELATIVE, /**< Relative doubles, added or multiplied. */
+   SS_VEC_INVERTED, /**< Inverted relative doubles, always multiplied. */
+   SS_VEC_ABSOLUTE, /**< Absolute doubles, added. */
+   SS_VEC_INTEGER,  /**< Integers, added. */
+   SS_VEC_BOOLEAN,  /**< Booleans, set. */
+   SS_VEC_KINDS     /**< Number of kinds. */
+} ShipStatVecKind;
+
+#define SS_VEC_WORDS ( ( SS_TYPE_SENTINEL + 63 ) / 64 ) /**< Mask words. */
+
+/**
+ * @brief Precompiled dense form of a ShipStatList.
+ *
+ * Values are stored by type, and the types that are set are grouped by how
+ * they get merged, so merging is a tight loop over each group without having
+ * to walk a list or switch on the data type.
+ */
+typedef struct ShipStatVec {
+   uint64_t            mask[SS_VEC_WORDS];      /**< Bitmask of set stats. */
+   double              val[SS_TYPE_SENTINEL];   /**< Values indexed by type. */
+   uint16_t            types[SS_TYPE_SENTINEL]; /**< Set types by kind. */
+   int                 start[SS_VEC_KINDS + 1]; /**< Start of each kind. */
+   const ShipStatList *list; /**< Source list if it repeats a stat. */
+} ShipStatVec;
+
 /**
  * @brief The data type.
  */
@@ -756,6 +785,150 @@ int ss_statsMergeFromListScale( ShipStats *stats, const ShipStatList *list,
    return ret;
 }
 
+/**
+ * @brief Gets how a stat type gets merged.
+ */
+static ShipStatVecKind ss_vecKind( const ShipStatsLookup *sl )
+{
+   switch ( sl->data ) {
+   case SS_DATA_TYPE_DOUBLE:
+      return ( sl->inverted ) ? SS_VEC_INVERTED : SS_VEC_RELATIVE;
+   case SS_DATA_TYPE_DOUBLE_ABSOLUTE:
+   case SS_DATA_TYPE_DOUBLE_ABSOLUTE_PERCENT:
+      return SS_VEC_ABSOLUTE;
+   case SS_DATA_TYPE_INTEGER:
+      return SS_VEC_INTEGER;
+   case SS_DATA_TYPE_BOOLEAN:
+      break;
+   }
+   return SS_VEC_BOOLEAN;
+}
+
+/**
+ * @brief Compiles a stat list into its dense form.
+ *
+ * The list must outlive the returned vector, as it is used for merging lists
+ * that set the same stat more than once.
+ *
+ *    @param list List to compile.
+ *    @return Newly allocated vector or NULL if the list is empty.
+ */
+ShipStatVec *ss_vecFromList( const ShipStatList *list )
+{
+   ShipStatVec *sv;
+   int          count[SS_VEC_KINDS] = { 0 };
+
+   if ( list == NULL )
+      return NULL;
+
+   sv = calloc( 1, sizeof( ShipStatVec ) );
+   for ( const ShipStatList *ll = list; ll != NULL; ll = ll->next ) {
+      const ShipStatsLookup *sl  = &ss_lookup[ll->type];
+      uint64_t               bit = (uint64_t)1 << ( ll->type % 64 );
+      if ( sv->mask[ll->type / 64] & bit ) {
+         /* Repeated stats don't always combine linearly, so let merging use
+          * the list to get the same result. */
+         sv->list = list;
+         continue;
+      }
+      sv->mask[ll->type / 64] |= bit;
+      if ( sl->data == SS_DATA_TYPE_INTEGER )
+         sv->val[ll->type] = ll->d.i;
+      else if ( sl->data != SS_DATA_TYPE_BOOLEAN )
+         sv->val[ll->type] = ll->d.d;
+      count[ss_vecKind( sl )]++;
+   }
+
+   /* Group the types by kind. */
+   sv->start[0] = 0;
+   for ( int k = 0; k < SS_VEC_KINDS; k++ ) {
+      sv->start[k + 1] = sv->start[k] + count[k];
+      count[k]         = sv->start[k];
+   }
+   for ( int t = 0; t < SS_TYPE_SENTINEL; t++ )
+      if ( sv->mask[t / 64] & ( (uint64_t)1 << ( t % 64 ) ) )
+         sv->types[count[ss_vecKind( &ss_lookup[t] )]++] = t;
+
+   return sv;
+}
+
+/**
+ * @brief Frees a stat vector.
+ *
+ *    @param sv Vector to free.
+ */
+void ss_vecFree( ShipStatVec *sv )
+{
+   free( sv );
+}
+
+/**
+ * @brief Updates a stat structure from a stat vector.
+ *
+ * Gives the same result as ss_statsMergeFromListScale() on the list the vector
+ * was compiled from.
+ *
+ *    @param stats Stats to update.
+ *    @param sv Vector to update from.
+ *    @param scale Scaling factor.
+ *    @param multiply Whether or not to use multiplication for merging.
+ *    @return 0 on success.
+ */
+int ss_statsMergeFromVec( ShipStats *stats, const ShipStatVec *sv,
+                          double scale, int multiply )
+{
+   char *ptr = (char *)stats;
+
+   if ( sv == NULL )
+      return 0;
+   if ( sv->list != NULL )
+      return ss_statsMergeFromListScale( stats, sv->list, scale, multiply );
+
+   /* Relative doubles. */
+   for ( int j = sv->start[SS_VEC_RELATIVE]; j < sv->start[SS_VEC_INVERTED];
+         j++ ) {
+      int     t   = sv->types[j];
+      double *dbl = (double *)(void *)&ptr[ss_lookup[t].offset];
+      if ( multiply )
+         *dbl *= 1. + sv->val[t] * scale;
+      else
+         *dbl += sv->val[t] * scale;
+   }
+
+   /* Inverted relative doubles are multiplicative either way. */
+   for ( int j = sv->start[SS_VEC_INVERTED]; j < sv->start[SS_VEC_ABSOLUTE];
+         j++ ) {
+      int     t   = sv->types[j];
+      double *dbl = (double *)(void *)&ptr[ss_lookup[t].offset];
+      *dbl *= 1. + sv->val[t] * scale;
+   }
+
+   /* Absolute doubles. */
+   for ( int j = sv->start[SS_VEC_ABSOLUTE]; j < sv->start[SS_VEC_INTEGER];
+         j++ ) {
+      int     t   = sv->types[j];
+      double *dbl = (double *)(void *)&ptr[ss_lookup[t].offset];
+      *dbl += sv->val[t] * scale;
+   }
+
+   /* Integers. */
+   for ( int j = sv->start[SS_VEC_INTEGER]; j < sv->start[SS_VEC_BOOLEAN];
+         j++ ) {
+      int  t = sv->types[j];
+      int *i = (int *)(void *)&ptr[ss_lookup[t].offset];
+      *i += sv->val[t] * scale;
+   }
+
+   /* Booleans can only be set to true. */
+   for ( int j = sv->start[SS_VEC_BOOLEAN]; j < sv->start[SS_VEC_KINDS];
+         j++ ) {
+      int *i = (int *)(void *)&ptr[ss_lookup[sv->types[j]].offset];
+      *i     = 1;
+   }
+
+   return 0;
+}
+
 /**
  * @brief Gets the name from type.
  *
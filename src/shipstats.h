@@ -188,6 +188,7 @@ typedef enum ShipStatsType {
    SS_TYPE_SENTINEL /**< Sentinel for end of types. */
 } ShipStatsType;
 typedef struct ShipStatList ShipStatList;
+typedef struct ShipStatVec  ShipStatVec;
 
 /**
  * @brief Represents ship statistics, properties ship can use.
@@ -373,6 +374,10 @@ int ss_statsMergeFromList( ShipStats *stats, const ShipStatList *list,
                            int multiply );
 int ss_statsMergeFromListScale( ShipStats *stats, const ShipStatList *list,
                                 double scale, int multiply );
+ShipStatVec *ss_vecFromList( const ShipStatList *list );
+void         ss_vecFree( ShipStatVec *sv );
+int ss_statsMergeFromVec( ShipStats *stats, const ShipStatVec *sv, double scale,
+                          int multiply );
 
 /*
  * Lookup.
@@ -0,0 +1,211 @@
+/*
+ * See Licensing and Copyright notice in naev.h
+ */
+/**
+ * @file spawn_index.c
+ *
+ * @brief Index of missions or events by where they can spawn.
+ *
+ * Used to quickly narrow down the missions or events that have to be checked
+ * for a location, without changing the order they are checked in.
+ */
+/** @cond */
+#include <stdlib.h>
+#include <string.h>
+/** @endcond */
+
+#include "spawn_index.h"
+
+#include "array.h"
+
+static int  spawnindex_cmp( const void *a, const void *b );
+static int  spawnindex_cmpID( const void *a, const void *b );
+static void spawnindex_addNamed( int **cand, const SpawnIndexEntry *entries,
+                                 const char *name );
+static void spawnindex_addList( int **cand, const int *ids );
+
+/**
+ * @brief Compares spawn index entries by name and then ID.
+ */
+static int spawnindex_cmp( const void *a, const void *b )
+{
+   const SpawnIndexEntry *ea  = a;
+   const SpawnIndexEntry *eb  = b;
+   int                    ret = strcmp( ea->name, eb->name );
+   if ( ret != 0 )
+      return ret;
+   return ea->id - eb->id;
+}
+
+/**
+ * @brief Compares spawn index IDs.
+ */
+static int spawnindex_cmpID( const void *a, const void *b )
+{
+   return *(const int *)a - *(const int *)b;
+}
+
+/**
+ * @brief Initializes an empty spawn index.
+ *
+ *    @param idx Index to initialize.
+ */
+void spawnindex_init( SpawnIndex *idx )
+{
+   idx->spob      = array_create( SpawnIndexEntry );
+   idx->system    = array_create( SpawnIndexEntry );
+   idx->any       = array_create( int );
+   idx->faction   = array_create( int );
+   idx->byfaction = array_create( int * );
+}
+
+/**
+ * @brief Frees a spawn index.
+ *
+ *    @param idx Index to free.
+ */
+void spawnindex_free( SpawnIndex *idx )
+{
+   array_free( idx->spob );
+   array_free( idx->system );
+   array_free( idx->any );
+   array_free( idx->faction );
+   for ( int j = 0; j < array_size( idx->byfaction ); j++ )
+      array_free( idx->byfaction[j] );
+   array_free( idx->byfaction );
+   memset( idx, 0, sizeof( SpawnIndex ) );
+}
+
+/**
+ * @brief Adds an entry to a spawn index.
+ *
+ * Entries have to be added in increasing ID order, and spawnindex_sort() has
+ * to be called once they are all added.
+ *
+ *    @param idx Index to add to.
+ *    @param spob Spob the entry is limited to or NULL. Has to outlive the index.
+ *    @param system System the entry is limited to or NULL. Has to outlive the
+ *           index.
+ *    @param factions Factions the entry is limited to (array.h) or NULL.
+ *    @param id ID of the entry.
+ */
+void spawnindex_add( SpawnIndex *idx, const char *spob, const char *system,
+                     const int *factions, int id )
+{
+   /* Specific entries go by the most restrictive name. */
+   if ( spob != NULL ) {
+      SpawnIndexEntry *e = &array_grow( &idx->spob );
+      e->name            = spob;
+      e->id              = id;
+      return;
+   }
+   if ( system != NULL ) {
+      SpawnIndexEntry *e = &array_grow( &idx->system );
+      e->name            = system;
+      e->id              = id;
+      return;
+   }
+
+   /* Generic entries. */
+   if ( array_size( factions ) == 0 ) {
+      array_push_back( &idx->any, id );
+      return;
+   }
+   array_push_back( &idx->faction, id );
+   for ( int j = 0; j < array_size( factions ); j++ ) {
+      int f = factions[j];
+      if ( f < 0 )
+         continue;
+      while ( array_size( idx->byfaction ) <= f )
+         array_push_back( &idx->byfaction, NULL );
+      if ( idx->byfaction[f] == NULL )
+         idx->byfaction[f] = array_create( int );
+      /* Skip duplicate factions. */
+      if ( ( array_size( idx->byfaction[f] ) > 0 ) &&
+           ( array_back( idx->byfaction[f] ) == id ) )
+         continue;
+      array_push_back( &idx->byfaction[f], id );
+   }
+}
+
+/**
+ * @brief Sorts the named entries of a spawn index so they can be looked up.
+ *
+ *    @param idx Index to sort.
+ */
+void spawnindex_sort( SpawnIndex *idx )
+{
+   qsort( idx->spob, array_size( idx->spob ), sizeof( SpawnIndexEntry ),
+          spawnindex_cmp );
+   qsort( idx->system, array_size( idx->system ), sizeof( SpawnIndexEntry ),
+          spawnindex_cmp );
+}
+
+/**
+ * @brief Adds all the index entries matching a name to the candidates.
+ */
+static void spawnindex_addNamed( int **cand, const SpawnIndexEntry *entries,
+                                 const char *name )
+{
+   int lo = 0;
+   int hi = array_size( entries );
+
+   /* Find the first entry with the name. */
+   while ( lo < hi ) {
+      int mid = ( lo + hi ) / 2;
+      if ( strcmp( entries[mid].name, name ) < 0 )
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   for ( int i = lo; i < array_size( entries ); i++ ) {
+      if ( strcmp( entries[i].name, name ) != 0 )
+         break;
+      array_push_back( cand, entries[i].id );
+   }
+}
+
+/**
+ * @brief Adds a list of IDs to the candidates.
+ */
+static void spawnindex_addList( int **cand, const int *ids )
+{
+   for ( int i = 0; i < array_size( ids ); i++ )
+      array_push_back( cand, ids[i] );
+}
+
+/**
+ * @brief Gets the candidates of a spawn index.
+ *
+ * Candidates still have to be checked fully, but everything that is left out
+ * is guaranteed to not match.
+ *
+ *    @param idx Index to look in.
+ *    @param spob Name of the spob to match or NULL.
+ *    @param system Name of the system to match or NULL.
+ *    @param generic Whether to include entries not limited to a spob or system.
+ *    @param faction Faction to match, or -1 to include all the faction entries.
+ *    @return Candidate IDs in increasing order (array.h). Has to be freed by
+ *            the caller.
+ */
+int *spawnindex_get( const SpawnIndex *idx, const char *spob,
+                     const char *system, int generic, int faction )
+{
+   int *cand = array_create( int );
+
+   if ( spob != NULL )
+      spawnindex_addNamed( &cand, idx->spob, spob );
+   if ( system != NULL )
+      spawnindex_addNamed( &cand, idx->system, system );
+   if ( generic ) {
+      spawnindex_addList( &cand, idx->any );
+      if ( faction < 0 )
+         spawnindex_addList( &cand, idx->faction );
+      else if ( faction < array_size( idx->byfaction ) )
+         spawnindex_addList( &cand, idx->byfaction[faction] );
+   }
+
+   /* Keep priority order. */
+   qsort( cand, array_size( cand ), sizeof( int ), spawnindex_cmpID );
+   return cand;
+}
@@ -0,0 +1,34 @@
+/*
+ * See Licensing and Copyright notice in naev.h
+ */
+#pragma once
+
+/**
+ * @brief Spawn index entry for spob or system specific entries.
+ */
+typedef struct SpawnIndexEntry_ {
+   const char *name; /**< Spob or system name. */
+   int         id;   /**< Index of the mission or event data. */
+} SpawnIndexEntry;
+
+/**
+ * @brief Candidate missions or events for a location or trigger.
+ *
+ * Entries are put in the bucket of their most specific requirement, and all
+ * the lists are kept sorted by ID.
+ */
+typedef struct SpawnIndex_ {
+   SpawnIndexEntry *spob;    /**< Spob entries sorted by name (array.h). */
+   SpawnIndexEntry *system;  /**< System entries sorted by name (array.h). */
+   int             *any;     /**< Entries with no requirements (array.h). */
+   int             *faction; /**< Faction entries (array.h). */
+   int **byfaction; /**< Faction entries by faction ID (array.h). */
+} SpawnIndex;
+
+void spawnindex_init( SpawnIndex *idx );
+void spawnindex_free( SpawnIndex *idx );
+void spawnindex_add( SpawnIndex *idx, const char *spob, const char *system,
+                     const int *factions, int id );
+void spawnindex_sort( SpawnIndex *idx );
+int *spawnindex_get( const SpawnIndex *idx, const char *spob,
+                     const char *system, int generic, int faction );
@@ -47,9 +47,25 @@
 /* Trail stuff. */
 #define TRAIL_UPDATE_DT                                                        \
    0.05 /**< Rate (in seconds) at which trail is updated. */
+#define TRAIL_VERTEX_FLOATS                                                    \
+   21 /**< Floats per trail vertex: vertex (3), coord (2), c1 (4), c2 (4), t   \
+         (2), pos1 (2), pos2 (2) and params (2). */
 static TrailSpec   *trail_spec_stack = NULL; /**< Trail specifications. */
 static Trail_spfx **trail_spfx_stack = NULL; /**< Active trail effects. */
 
+/**
+ * @brief Range of the trail vertex buffer drawn with a single trail shader.
+ */
+typedef struct TrailBatch_ {
+   const TrailSpec *spec;  /**< Trail specification (and thus shader). */
+   GLint            first; /**< First vertex. */
+   GLsizei          count; /**< Number of vertices. */
+} TrailBatch;
+static GLfloat    *trail_vertices = NULL; /**< Trail vertices to upload. */
+static TrailBatch *trail_batches  = NULL; /**< Draw calls to issue. */
+static gl_vbo     *trail_vbo      = NULL; /**< Streaming trail VBO. */
+static TrailStats  trail_stats;           /**< Trail rendering counters. */
+
 /*
  * Special hard-coded special effects
  */
@@ -154,6 +170,9 @@ static void spfx_hapticRumble( double mod );
 static void spfx_update_trails( double dt );
 static void spfx_trail_update( Trail_spfx *trail, double dt );
 static void spfx_trail_free( Trail_spfx *trail );
+static void spfx_trail_pack( const Trail_spfx *trail );
+static void spfx_trail_attribs( const TrailSpec *spec, int enable );
+static void spfx_trail_flush( void );
 
 /**
  * @brief For sorting and stuff.
@@ -400,6 +419,10 @@ int spfx_load( void )
 
    /* Trail colour sets. */
    trailSpec_load();
+   trail_vertices = array_create( GLfloat );
+   trail_batches  = array_create( TrailBatch );
+   trail_vbo      = gl_vboCreateStream( 0, NULL );
+   gl_vboLabel( trail_vbo, "Trail VBO" );
 
    /*
     * Now initialize force feedback.
@@ -492,6 +515,12 @@ void spfx_free( void )
    }
    array_free( trail_spec_stack );
    trail_spec_stack = NULL;
+   array_free( trail_vertices );
+   trail_vertices = NULL;
+   array_free( trail_batches );
+   trail_batches = NULL;
+   gl_vboDestroy( trail_vbo );
+   trail_vbo = NULL;
 
    /* Get rid of Lua effects. */
    spfxL_exit();
@@ -884,38 +913,39 @@ static void spfx_trail_free( Trail_spfx *trail )
 }
 
 /**
- * @brief Draws a trail on screen.
+ * @brief Appends the visible segments of a trail to the trail vertex buffer.
  *
- * Assumes depth testing is enabled.
+ * Segments are drawn as two triangles each, with everything the trail shaders
+ * need as vertex attributes so trails sharing a shader can be drawn at once.
  */
-void spfx_trail_draw( const Trail_spfx *trail )
+static void spfx_trail_pack( const Trail_spfx *trail )
 {
+   /* Corners of the two triangles of a segment. */
+   static const GLfloat corners[6][2] = {
+      { 0., 0. }, { 1., 0. }, { 0., 1. }, { 0., 1. }, { 1., 0. }, { 1., 1. } };
    const TrailSpec  *spec;
    const TrailStyle *styles;
    GLfloat           len;
    double            z;
+   GLint             first;
+   GLsizei           count;
+   TrailBatch       *b;
 
    size_t n = trail_size( trail );
    if ( n == 0 )
       return;
    spec   = trail->spec;
    styles = spec->style;
+   first  = array_size( trail_vertices ) / TRAIL_VERTEX_FLOATS;
 
-   /* Stuff that doesn't change for the entire trail. */
-   glUseProgram( spec->shader.program );
-   glEnableVertexAttribArray( spec->shader.vertex );
-   gl_vboActivateAttribOffset( gl_squareVBO, spec->shader.vertex, 0, 2,
-                               GL_FLOAT, 0 );
-   glUniform1f( spec->shader.dt, trail->dt );
-   glUniform1f( spec->shader.r, trail->r );
-
-   /* Start drawing from head to tail. */
+   /* Start packing from head to tail. */
    z   = cam_getZoom();
    len = 0.;
    for ( size_t i = trail->iread + 1; i < trail->iwrite; i++ ) {
-      mat4              projection;
       const TrailStyle *sp, *spp;
-      double            x1, y1, x2, y2, s;
+      double            x1, y1, x2, y2, s, c, sn, h;
+      GLfloat          *v;
+      int               nf;
       TrailPoint       *tp  = &trail_at( trail, i );
       TrailPoint       *tpp = &trail_at( trail, i - 1 );
 
@@ -940,35 +970,152 @@ void spfx_trail_draw( const Trail_spfx *trail )
       sp  = &styles[tp->mode];
       spp = &styles[tpp->mode];
 
-      /* Set vertex. */
-      projection = gl_view_matrix;
-      mat4_translate_xy( &projection, x1, y1 );
-      mat4_rotate2dv( &projection, ( x2 - x1 ) / s, ( y2 - y1 ) / s );
-      mat4_scale_xy( &projection, s, z * ( sp->thick + spp->thick ) );
-      mat4_translate_xy( &projection, 0., -0.5 );
-
-      /* Set uniforms. */
-      gl_uniformMat4( spec->shader.projection, &projection );
-      gl_uniformColour( spec->shader.c1, &sp->col );
-      gl_uniformColour( spec->shader.c2, &spp->col );
-      glUniform2f( spec->shader.t, tp->t, tpp->t );
-      glUniform2f( spec->shader.z, tp->z, tpp->z );
-      glUniform2f( spec->shader.pos2, len, sp->thick );
+      /* Segment goes from (x1,y1) to (x2,y2) and is centred on that line. */
+      c  = ( x2 - x1 ) / s;
+      sn = ( y2 - y1 ) / s;
+      h  = z * ( sp->thick + spp->thick );
+
+      nf = array_size( trail_vertices );
+      array_resize( &trail_vertices, nf + 6 * TRAIL_VERTEX_FLOATS );
+      v = &trail_vertices[nf];
+      for ( int j = 0; j < 6; j++ ) {
+         GLfloat u  = corners[j][0];
+         GLfloat w  = corners[j][1];
+         double  lx = u * s;
+         double  ly = ( w - 0.5 ) * h;
+         /* vertex */
+         v[0] = x1 + c * lx - sn * ly;
+         v[1] = y1 + sn * lx + c * ly;
+         v[2] = tp->z + ( tpp->z - tp->z ) * u;
+         /* coord */
+         v[3] = u;
+         v[4] = w;
+         /* c1 and c2 */
+         v[5]  = sp->col.r;
+         v[6]  = sp->col.g;
+         v[7]  = sp->col.b;
+         v[8]  = sp->col.a;
+         v[9]  = spp->col.r;
+         v[10] = spp->col.g;
+         v[11] = spp->col.b;
+         v[12] = spp->col.a;
+         /* t */
+         v[13] = tp->t;
+         v[14] = tpp->t;
+         /* pos1 and pos2 */
+         v[15] = len + s;
+         v[16] = spp->thick;
+         v[17] = len;
+         v[18] = sp->thick;
+         /* params */
+         v[19] = trail->r;
+         v[20] = trail->dt;
+         v += TRAIL_VERTEX_FLOATS;
+      }
       len += s;
-      glUniform2f( spec->shader.pos1, len, spp->thick );
+   }
 
-      /* Draw. */
-      glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+   count = array_size( trail_vertices ) / TRAIL_VERTEX_FLOATS - first;
+   if ( count == 0 )
+      return;
+   trail_stats.trails++;
+
+   /* Extend the last draw call when it uses the same shader. */
+   if ( ( array_size( trail_batches ) > 0 ) &&
+        ( array_back( trail_batches ).spec == spec ) ) {
+      array_back( trail_batches ).count += count;
+      return;
    }
+   b        = &array_grow( &trail_batches );
+   b->spec  = spec;
+   b->first = first;
+   b->count = count;
+}
 
-   /* Clear state. */
-   glDisableVertexAttribArray( spec->shader.vertex );
+/**
+ * @brief Enables or disables the vertex attributes of a trail shader.
+ */
+static void spfx_trail_attribs( const TrailSpec *spec, int enable )
+{
+   const GLuint attribs[] = { spec->shader.vertex, spec->shader.coord,
+                              spec->shader.c1,     spec->shader.c2,
+                              spec->shader.t,      spec->shader.pos1,
+                              spec->shader.pos2,   spec->shader.params };
+   const GLint  sizes[]   = { 3, 2, 4, 4, 2, 2, 2, 2 };
+   GLsizei      offset    = 0;
+   for ( size_t i = 0; i < sizeof( attribs ) / sizeof( attribs[0] ); i++ ) {
+      /* Shaders may not use all the attributes. */
+      if ( (GLint)attribs[i] >= 0 ) {
+         if ( enable ) {
+            glEnableVertexAttribArray( attribs[i] );
+            gl_vboActivateAttribOffset(
+               trail_vbo, attribs[i], offset, sizes[i], GL_FLOAT,
+               sizeof( GLfloat ) * TRAIL_VERTEX_FLOATS );
+         } else
+            glDisableVertexAttribArray( attribs[i] );
+      }
+      offset += sizeof( GLfloat ) * sizes[i];
+   }
+}
+
+/**
+ * @brief Uploads the packed trails and draws them, one call per batch.
+ *
+ * Assumes depth testing is enabled.
+ */
+static void spfx_trail_flush( void )
+{
+   int nv = array_size( trail_vertices ) / TRAIL_VERTEX_FLOATS;
+   if ( nv <= 0 )
+      return;
+
+   /* Orphaning the buffer lets the driver hand out a fresh one each upload. */
+   gl_vboData( trail_vbo, sizeof( GLfloat ) * array_size( trail_vertices ),
+               trail_vertices );
+   for ( int i = 0; i < array_size( trail_batches ); i++ ) {
+      const TrailBatch *b    = &trail_batches[i];
+      const TrailSpec  *spec = b->spec;
+      glUseProgram( spec->shader.program );
+      gl_uniformMat4( spec->shader.projection, &gl_view_matrix );
+      spfx_trail_attribs( spec, 1 );
+      glDrawArrays( GL_TRIANGLES, b->first, b->count );
+      spfx_trail_attribs( spec, 0 );
+   }
    glUseProgram( 0 );
 
+   trail_stats.draws += array_size( trail_batches );
+   trail_stats.vertices += nv;
+   trail_stats.frame_vertices += nv;
+   array_erase( &trail_vertices, array_begin( trail_vertices ),
+                array_end( trail_vertices ) );
+   array_erase( &trail_batches, array_begin( trail_batches ),
+                array_end( trail_batches ) );
+
    /* Check errors. */
    gl_checkErr();
 }
 
+/**
+ * @brief Draws a trail on screen.
+ *
+ * Assumes depth testing is enabled.
+ */
+void spfx_trail_draw( const Trail_spfx *trail )
+{
+   spfx_trail_pack( trail );
+   spfx_trail_flush();
+}
+
+/**
+ * @brief Gets the counters of the trail renderer.
+ *
+ *    @param[out] stats Where to write the counters.
+ */
+void spfx_trailStats( TrailStats *stats )
+{
+   *stats = trail_stats;
+}
+
 /**
  * @brief Increases the current rumble level.
  *
@@ -1210,12 +1357,19 @@ void spfx_render( int layer, double dt )
       spfxL_renderbg( dt );
 
       NTracingZoneName( _ctx_trails, "spfx_render[trails]", 1 );
-      /* Trails are special (for now?). */
-      for ( int i = 0; i < array_size( trail_spfx_stack ); i++ ) {
-         const Trail_spfx *trail = trail_spfx_stack[i];
-         if ( !trail->ontop )
-            spfx_trail_draw( trail );
+      /* Trails are special (for now?). They are all packed into a single
+       * buffer grouped by specification, so there is one draw call per trail
+       * shader. This is the first trail pass of the frame. */
+      trail_stats.frame_vertices = 0;
+      for ( int j = 0; j < array_size( trail_spec_stack ); j++ ) {
+         const TrailSpec *spec = &trail_spec_stack[j];
+         for ( int i = 0; i < array_size( trail_spfx_stack ); i++ ) {
+            const Trail_spfx *trail = trail_spfx_stack[i];
+            if ( !trail->ontop && ( trail->spec == spec ) )
+               spfx_trail_pack( trail );
+         }
       }
+      spfx_trail_flush();
       NTracingZoneEnd( _ctx_trails );
       break;
 
@@ -1328,16 +1482,17 @@ static int trailSpec_parse( TrailSpec *tc, const char *file, int firstpass )
       tc->shader.program =
          gl_program_vert_frag( "trail.vert", tc->shader_path );
       tc->shader.vertex = glGetAttribLocation( tc->shader.program, "vertex" );
+      tc->shader.coord  = glGetAttribLocation( tc->shader.program, "coord" );
+      tc->shader.c1     = glGetAttribLocation( tc->shader.program, "col1" );
+      tc->shader.c2     = glGetAttribLocation( tc->shader.program, "col2" );
+      tc->shader.t      = glGetAttribLocation( tc->shader.program, "trange" );
+      tc->shader.pos1 =
+         glGetAttribLocation( tc->shader.program, "position1" );
+      tc->shader.pos2 =
+         glGetAttribLocation( tc->shader.program, "position2" );
+      tc->shader.params = glGetAttribLocation( tc->shader.program, "params" );
       tc->shader.projection =
          glGetUniformLocation( tc->shader.program, "projection" );
-      tc->shader.r    = glGetUniformLocation( tc->shader.program, "r" );
-      tc->shader.dt   = glGetUniformLocation( tc->shader.program, "dt" );
-      tc->shader.c1   = glGetUniformLocation( tc->shader.program, "c1" );
-      tc->shader.c2   = glGetUniformLocation( tc->shader.program, "c2" );
-      tc->shader.t    = glGetUniformLocation( tc->shader.program, "t" );
-      tc->shader.z    = glGetUniformLocation( tc->shader.program, "z" );
-      tc->shader.pos1 = glGetUniformLocation( tc->shader.program, "pos1" );
-      tc->shader.pos2 = glGetUniformLocation( tc->shader.program, "pos2" );
       tc->shader.nebu_col =
          glGetUniformLocation( tc->shader.program, "nebu_col" );
       gl_checkErr();
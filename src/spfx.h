@@ -66,19 +66,28 @@ typedef struct TrailSpec_ {
    struct {
       GLuint program;
       GLuint vertex;
-      GLuint projection;
-      GLuint r;
-      GLuint dt;
+      GLuint coord;
       GLuint c1;
       GLuint c2;
       GLuint t;
-      GLuint z;
       GLuint pos1;
       GLuint pos2;
+      GLuint params;
+      GLuint projection;
       GLuint nebu_col;
    } shader;
 } TrailSpec;
 
+/**
+ * @brief Counters of the batched trail renderer.
+ */
+typedef struct TrailStats_ {
+   uint64_t trails;         /**< Trails drawn. */
+   uint64_t draws;          /**< Draw calls issued for trails. */
+   uint64_t vertices;       /**< Trail vertices uploaded. */
+   uint64_t frame_vertices; /**< Trail vertices uploaded in the last frame. */
+} TrailStats;
+
 typedef struct TrailPoint {
    GLfloat x, y, z; /**< Control points for the trail. */
    GLfloat t; /**< Timer, normalized to the time to live of the trail (starts at
@@ -135,6 +144,7 @@ void        spfx_trail_sample( Trail_spfx *trail, double x, double y, double z,
                                double dx, double dy, TrailMode mode, int force );
 void        spfx_trail_remove( Trail_spfx *trail );
 void        spfx_trail_draw( const Trail_spfx *trail );
+void        spfx_trailStats( TrailStats *stats );
 
 /*
  * Misc effects.
@@ -0,0 +1,180 @@
+/*
+ * See Licensing and Copyright notice in naev.h
+ */
+/**
+ * @file strmap.c
+ *
+ * @brief String to integer hash table with linear probing.
+ */
+/** @cond */
+#include <stdlib.h>
+#include <string.h>
+
+#include "naev.h"
+/** @endcond */
+
+#include "strmap.h"
+
+#define STRMAP_MINSIZE 32 /**< Smallest number of slots to allocate. */
+
+static unsigned int strmap_find( const StrMap *sm, const char *key );
+static void         strmap_grow( StrMap *sm );
+
+/**
+ * @brief Hashes a string (FNV-1a).
+ *
+ *    @param str String to hash.
+ *    @return Hash of the string.
+ */
+unsigned int strmap_hash( const char *str )
+{
+   unsigned int hash = 2166136261u;
+   for ( const char *c = str; *c != '\0'; c++ ) {
+      hash ^= (unsigned char)*c;
+      hash *= 16777619u;
+   }
+   return hash;
+}
+
+/**
+ * @brief Finds the slot of a key, or the free slot it would go in.
+ */
+static unsigned int strmap_find( const StrMap *sm, const char *key )
+{
+   unsigned int mask = sm->size - 1;
+   unsigned int i;
+   for ( i = strmap_hash( key ) & mask; sm->keys[i] != NULL;
+         i = ( i + 1 ) & mask )
+      if ( strcmp( sm->keys[i], key ) == 0 )
+         break;
+   return i;
+}
+
+/**
+ * @brief Doubles the number of slots of a map, rehashing all the keys.
+ */
+static void strmap_grow( StrMap *sm )
+{
+   char       **keys = sm->keys;
+   int         *vals = sm->vals;
+   unsigned int size = sm->size;
+
+   sm->size = MAX( STRMAP_MINSIZE, 2 * size );
+   sm->keys = calloc( sm->size, sizeof( char * ) );
+   sm->vals = calloc( sm->size, sizeof( int ) );
+   for ( unsigned int j = 0; j < size; j++ ) {
+      if ( keys[j] == NULL )
+         continue;
+      unsigned int i = strmap_find( sm, keys[j] );
+      sm->keys[i]    = keys[j];
+      sm->vals[i]    = vals[j];
+   }
+   free( keys );
+   free( vals );
+}
+
+/**
+ * @brief Frees a map, leaving it empty and ready to be used again.
+ *
+ *    @param sm Map to free.
+ */
+void strmap_free( StrMap *sm )
+{
+   strmap_clear( sm );
+   free( sm->keys );
+   free( sm->vals );
+   memset( sm, 0, sizeof( StrMap ) );
+}
+
+/**
+ * @brief Removes all the keys of a map, keeping its slots allocated.
+ *
+ *    @param sm Map to clear.
+ */
+void strmap_clear( StrMap *sm )
+{
+   for ( unsigned int i = 0; i < sm->size; i++ ) {
+      free( sm->keys[i] );
+      sm->keys[i] = NULL;
+   }
+   sm->used = 0;
+}
+
+/**
+ * @brief Gets the value of a key.
+ *
+ *    @param sm Map to look in.
+ *    @param key Key to look for.
+ *    @return Pointer to the value of the key, or NULL if not found. Only valid
+ *            until the map is next modified.
+ */
+int *strmap_get( const StrMap *sm, const char *key )
+{
+   unsigned int i;
+   if ( sm->used == 0 )
+      return NULL;
+   i = strmap_find( sm, key );
+   return ( sm->keys[i] != NULL ) ? &sm->vals[i] : NULL;
+}
+
+/**
+ * @brief Sets the value of a key, adding it if necessary.
+ *
+ *    @param sm Map to modify.
+ *    @param key Key to set.
+ *    @param val Value to give the key.
+ *    @return Pointer to the value of the key. Only valid until the map is next
+ *            modified.
+ */
+int *strmap_set( StrMap *sm, const char *key, int val )
+{
+   unsigned int i;
+
+   /* Grow to keep it at most half full. */
+   if ( 2 * ( sm->used + 1 ) > sm->size )
+      strmap_grow( sm );
+
+   i = strmap_find( sm, key );
+   if ( sm->keys[i] == NULL ) {
+      sm->keys[i] = strdup( key );
+      sm->used++;
+   }
+   sm->vals[i] = val;
+   return &sm->vals[i];
+}
+
+/**
+ * @brief Removes a key from a map.
+ *
+ *    @param sm Map to modify.
+ *    @param key Key to remove.
+ *    @return 0 if the key was removed, -1 if it was not found.
+ */
+int strmap_remove( StrMap *sm, const char *key )
+{
+   unsigned int mask, i, j;
+
+   if ( sm->used == 0 )
+      return -1;
+   i = strmap_find( sm, key );
+   if ( sm->keys[i] == NULL )
+      return -1;
+
+   free( sm->keys[i] );
+   sm->keys[i] = NULL;
+   sm->used--;
+
+   /* Backward shift deletion to keep probe chains intact. */
+   mask = sm->size - 1;
+   for ( j = ( i + 1 ) & mask; sm->keys[j] != NULL; j = ( j + 1 ) & mask ) {
+      unsigned int k = strmap_hash( sm->keys[j] ) & mask;
+      /* Move it if its home slot isn't cyclically in (i, j]. */
+      if ( ( ( j - k ) & mask ) >= ( ( j - i ) & mask ) ) {
+         sm->keys[i] = sm->keys[j];
+         sm->vals[i] = sm->vals[j];
+         sm->keys[j] = NULL;
+         i           = j;
+      }
+   }
+   return 0;
+}
@@ -0,0 +1,24 @@
+/*
+ * See Licensing and Copyright notice in naev.h
+ */
+#pragma once
+
+/**
+ * @brief Open addressing hash table mapping strings to integers.
+ *
+ * Zero initialize to create. Keys are copied. Slots with a NULL key are free,
+ * so the table can be walked directly over keys/vals up to size.
+ */
+typedef struct StrMap_ {
+   char       **keys; /**< Keys of the slots, NULL if the slot is free. */
+   int         *vals; /**< Values of the slots. */
+   unsigned int size; /**< Number of slots, always a power of two. */
+   unsigned int used; /**< Number of used slots. */
+} StrMap;
+
+unsigned int strmap_hash( const char *str );
+void         strmap_free( StrMap *sm );
+void         strmap_clear( StrMap *sm );
+int         *strmap_get( const StrMap *sm, const char *key );
+int         *strmap_set( StrMap *sm, const char *key, int val );
+int          strmap_remove( StrMap *sm, const char *key );
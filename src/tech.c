@@ -9,6 +9,7 @@
  */
 /** @cond */
 #include <SDL3/SDL_timer.h>
+#include <stdint.h>
 /** @endcond */
 
 #include "tech.h"
@@ -55,6 +56,14 @@ typedef struct tech_item_s {
    } u;                           /**< Data union. */
 } tech_item_t;
 
+/**
+ * @brief Flattened set of the outfits, ships or commodities of a group.
+ */
+typedef struct tech_set_s {
+   uint64_t    *bits;  /**< Membership by index in the item stack (array.h). */
+   const void **extra; /**< Sorted members not in the item stack (array.h). */
+} tech_set_t;
+
 /**
  * @brief Group of tech items, basic unit of the tech trees.
  */
@@ -62,12 +71,19 @@ struct tech_group_s {
    char        *name;     /**< Name of the tech group. */
    char        *filename; /**< Name of the file. */
    tech_item_t *items;    /**< Items in the tech group. */
+
+   /* Flattened membership, built lazily. */
+   tech_set_t   sets[TECH_TYPE_COMMODITY + 1]; /**< Members by item type. */
+   unsigned int sets_gen;    /**< tech_generation the sets were built for. */
+   int          sets_chance; /**< Whether any member has a random chance. */
 };
 
 /*
  * Group list.
  */
 static tech_group_t *tech_groups = NULL;
+static unsigned int  tech_generation =
+   1; /**< Bumped whenever any group changes, invalidating all sets. */
 
 /*
  * Prototypes.
@@ -75,6 +91,8 @@ static tech_group_t *tech_groups = NULL;
 static void        tech_createMetaGroup( tech_group_t *grp, tech_group_t **tech,
                                          int num );
 static void        tech_freeGroup( tech_group_t *grp );
+static void        tech_freeSets( tech_group_t *grp );
+static void        tech_invalidate( void );
 static const char *tech_getItemName( tech_item_t *item );
 /* Loading. */
 static tech_item_t *tech_itemGrow( tech_group_t *grp );
@@ -182,6 +200,7 @@ static void tech_freeGroup( tech_group_t *grp )
    free( grp->name );
    free( grp->filename );
    array_free( grp->items );
+   tech_freeSets( grp );
 }
 
 /**
@@ -355,6 +374,9 @@ static int tech_parseXMLData( tech_group_t *tech, xmlNodePtr parent )
             node->name );
    } while ( xml_nextNode( node ) );
 
+   /* Groups may include this one. */
+   tech_invalidate();
+
    return 0;
 }
 
@@ -487,6 +509,7 @@ int tech_addItem( const char *name, const char *value )
       return -1;
    }
 
+   tech_invalidate();
    return 0;
 }
 
@@ -513,6 +536,7 @@ static tech_item_t *tech_addItemTechInternal( tech_group_t *tech,
       WARN( _( "Generic item '%s' not found in tech group" ), value );
       return NULL;
    }
+   tech_invalidate();
    return ret;
 }
 
@@ -527,6 +551,7 @@ int tech_rmItemTech( tech_group_t *tech, const char *value )
       const char *buf = tech_getItemName( &tech->items[i] );
       if ( strcmp( buf, value ) == 0 ) {
          array_erase( &tech->items, &tech->items[i], &tech->items[i + 1] );
+         tech_invalidate();
          return 0;
       }
    }
@@ -560,6 +585,7 @@ int tech_rmItem( const char *name, const char *value )
       const char *buf = tech_getItemName( &tech->items[i] );
       if ( strcmp( buf, value ) == 0 ) {
          array_erase( &tech->items, &tech->items[i], &tech->items[i + 1] );
+         tech_invalidate();
          return 0;
       }
    }
@@ -701,6 +727,175 @@ static void **tech_addGroupItem( void **items, tech_item_type_t type,
    return tech_addGroupItemPrice( items, NULL, type, tech );
 }
 
+/**
+ * @brief Invalidates the membership sets of all the groups.
+ */
+static void tech_invalidate( void )
+{
+   /* 0 is reserved for sets that were never built. */
+   if ( ++tech_generation == 0 )
+      tech_generation = 1;
+}
+
+/**
+ * @brief Gets the item stack backing a type of tech item.
+ *
+ *    @param type Type of item.
+ *    @param[out] n Number of items in the stack.
+ *    @param[out] size Size of each item in the stack.
+ *    @return Start of the stack.
+ */
+static const void *tech_setStack( tech_item_type_t type, int *n, size_t *size )
+{
+   switch ( type ) {
+   case TECH_TYPE_OUTFIT:
+      *n    = array_size( outfit_getAll() );
+      *size = sizeof( Outfit );
+      return outfit_getAll_rust();
+   case TECH_TYPE_SHIP:
+      *n    = array_size( ship_getAll() );
+      *size = sizeof( Ship );
+      return ship_getAll();
+   case TECH_TYPE_COMMODITY:
+      *n    = array_size( commodity_getAll() );
+      *size = sizeof( Commodity );
+      return commodity_getAll();
+   default:
+      *n    = 0;
+      *size = 1;
+      return NULL;
+   }
+}
+
+/**
+ * @brief Gets the index of an item in its stack.
+ *
+ *    @return The index or -1 if it is not in the stack (temporary commodities).
+ */
+static int tech_setIndex( tech_item_type_t type, const void *ptr )
+{
+   int         n;
+   size_t      size;
+   const void *base = tech_setStack( type, &n, &size );
+   uintptr_t   off  = (uintptr_t)ptr - (uintptr_t)base;
+   if ( ( base == NULL ) || ( (uintptr_t)ptr < (uintptr_t)base ) ||
+        ( off >= (uintptr_t)n * size ) || ( off % size != 0 ) )
+      return -1;
+   return off / size;
+}
+
+/**
+ * @brief Compares pointers for sorting and searching set extras.
+ */
+static int tech_setCmp( const void *p1, const void *p2 )
+{
+   uintptr_t a = (uintptr_t)( *(const void *const *)p1 );
+   uintptr_t b = (uintptr_t)( *(const void *const *)p2 );
+   return ( a > b ) - ( a < b );
+}
+
+/**
+ * @brief Adds an item to a set.
+ */
+static void tech_setAdd( tech_set_t *set, tech_item_type_t type,
+                         const void *ptr )
+{
+   int idx = tech_setIndex( type, ptr );
+   if ( idx < 0 ) {
+      if ( set->extra == NULL )
+         set->extra = array_create( const void * );
+      array_push_back( &set->extra, ptr );
+      return;
+   }
+   if ( set->bits == NULL )
+      set->bits = array_create( uint64_t );
+   while ( array_size( set->bits ) <= idx / 64 )
+      array_push_back( &set->bits, 0 );
+   set->bits[idx / 64] |= UINT64_C( 1 ) << ( idx % 64 );
+}
+
+/**
+ * @brief Checks to see if an item is in a set.
+ */
+static int tech_setHas( const tech_set_t *set, tech_item_type_t type,
+                        const void *ptr )
+{
+   int idx = tech_setIndex( type, ptr );
+   if ( idx < 0 )
+      return ( set->extra != NULL ) &&
+             ( bsearch( &ptr, set->extra, array_size( set->extra ),
+                        sizeof( const void * ), tech_setCmp ) != NULL );
+   if ( idx / 64 >= array_size( set->bits ) )
+      return 0;
+   return !!( set->bits[idx / 64] & ( UINT64_C( 1 ) << ( idx % 64 ) ) );
+}
+
+/**
+ * @brief Frees the flattened membership sets of a group.
+ */
+static void tech_freeSets( tech_group_t *grp )
+{
+   for ( int i = 0; i <= TECH_TYPE_COMMODITY; i++ ) {
+      array_free( grp->sets[i].bits );
+      array_free( grp->sets[i].extra );
+      grp->sets[i].bits  = NULL;
+      grp->sets[i].extra = NULL;
+   }
+   grp->sets_gen = 0;
+}
+
+/**
+ * @brief Recursively adds all the items of a group to the sets of another.
+ */
+static void tech_buildSets( tech_group_t *tgt, const tech_group_t *tech )
+{
+   for ( int i = 0; i < array_size( tech->items ); i++ ) {
+      const tech_item_t *item = &tech->items[i];
+      switch ( item->type ) {
+      case TECH_TYPE_OUTFIT:
+      case TECH_TYPE_SHIP:
+      case TECH_TYPE_COMMODITY:
+         tech_setAdd( &tgt->sets[item->type], item->type, item->u.ptr );
+         if ( item->chance > 0. )
+            tgt->sets_chance = 1;
+         break;
+      case TECH_TYPE_GROUP:
+         tech_buildSets( tgt, &tech_groups[item->u.grp] );
+         break;
+      case TECH_TYPE_GROUP_POINTER:
+         tech_buildSets( tgt, item->u.grpptr );
+         break;
+      }
+   }
+}
+
+/**
+ * @brief Gets a group with up to date flattened membership sets.
+ *
+ * The sets are only rebuilt when a tech group was modified since they were
+ * last built, since changes to nested groups have to be picked up too.
+ *
+ *    @param tech Group to get sets of.
+ *    @return The same group, with valid sets.
+ */
+static const tech_group_t *tech_getSets( const tech_group_t *tech )
+{
+   /* The sets are a cache, so they can be updated on const groups. */
+   tech_group_t *grp = (tech_group_t *)tech;
+   if ( grp->sets_gen == tech_generation )
+      return grp;
+
+   tech_freeSets( grp );
+   grp->sets_chance = 0;
+   tech_buildSets( grp, grp );
+   for ( int i = 0; i <= TECH_TYPE_COMMODITY; i++ )
+      if ( grp->sets[i].extra != NULL )
+         qsort( grp->sets[i].extra, array_size( grp->sets[i].extra ),
+                sizeof( const void * ), tech_setCmp );
+   grp->sets_gen = tech_generation;
+   return grp;
+}
+
 /**
  * @brief Checks whether a given tech group has the specified item.
  *
@@ -726,38 +921,8 @@ static int tech_hasItemInternal( const tech_group_t *tech,
 {
    if ( tech == NULL )
       return 0;
-   int s = array_size( tech->items );
-   for ( int i = 0; i < s; i++ ) {
-      const tech_item_t *itemi = &tech->items[i];
-
-      if ( item->type == itemi->type ) {
-         switch ( item->type ) {
-         case TECH_TYPE_OUTFIT:
-            if ( item->u.outfit == itemi->u.outfit )
-               return 1;
-            break;
-         case TECH_TYPE_SHIP:
-            if ( item->u.ship == itemi->u.ship )
-               return 1;
-            break;
-         case TECH_TYPE_COMMODITY:
-            if ( item->u.comm == itemi->u.comm )
-               return 1;
-            break;
-         default:
-            break;
-         }
-      }
-
-      if ( itemi->type == TECH_TYPE_GROUP ) {
-         if ( tech_hasItemInternal( &tech_groups[itemi->u.grp], item ) )
-            return 1;
-      } else if ( itemi->type == TECH_TYPE_GROUP_POINTER ) {
-         if ( tech_hasItemInternal( itemi->u.grpptr, item ) )
-            return 1;
-      }
-   }
-   return 0;
+   tech = tech_getSets( tech );
+   return tech_setHas( &tech->sets[item->type], item->type, item->u.ptr );
 }
 
 /**
@@ -995,7 +1160,15 @@ Commodity **tech_getCommodity( const tech_group_t *tech, double **price )
  */
 int tech_checkOutfit( const tech_group_t *tech, const Outfit *o )
 {
-   Outfit **to = tech_getOutfit( tech );
+   Outfit **to;
+
+   /* Membership is exact unless some items only show up by chance. */
+   if ( !tech_hasOutfit( tech, o ) )
+      return 0;
+   if ( !tech_getSets( tech )->sets_chance )
+      return 1;
+
+   to = tech_getOutfit( tech );
    for ( int i = 0; i < array_size( to ); i++ ) {
       if ( to[i] == o ) {
          array_free( to );
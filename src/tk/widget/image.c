@@ -43,6 +43,7 @@ void window_addImage( unsigned int wid, const int x, const int y, const int w,
    wgt->cleanup = img_cleanup;
 
    wgt->dat.img.image   = gl_dupTexture( image );
+   wgt->dat.img.request = NULL;
    wgt->dat.img.border  = border;
    wgt->dat.img.layers  = NULL;
    wgt->dat.img.nlayers = 0;
@@ -55,6 +56,33 @@ void window_addImage( unsigned int wid, const int x, const int y, const int w,
    toolkit_setPos( wdw, wgt, x, y );
 }
 
+/**
+ * @brief Adds an image widget that displays a texture loaded in the background.
+ *
+ * Nothing but the border is drawn until the texture has finished loading.
+ *
+ *    @param wid ID of the window to add the widget to.
+ *    @param x X position within the window to use.
+ *    @param y Y position within the window to use.
+ *    @param w Width of the widget (must be positive).
+ *    @param h Height of the widget (must be positive).
+ *    @param name Name of the widget to use internally.
+ *    @param request Texture request to display once loaded.
+ *    @param border Whether to use a border.
+ */
+void window_addImageRequest( unsigned int wid, const int x, const int y,
+                             const int w, const int h, char *name,
+                             const glTexRequest *request, int border )
+{
+   Widget *wgt;
+
+   window_addImage( wid, x, y, w, h, name, NULL, border );
+   wgt = window_getwgt( wid, name );
+   if ( ( wgt == NULL ) || ( wgt->type != WIDGET_IMAGE ) )
+      return;
+   wgt->dat.img.request = gl_texRequestDup( request );
+}
+
 /**
  * @brief Renders a image widget.
  *
@@ -74,6 +102,15 @@ static void img_render( Widget *img, double bx, double by )
    w = img->w;
    h = img->h;
 
+   /* Pick up the image once it has finished loading. */
+   if ( ( img->dat.img.request != NULL ) &&
+        gl_texRequestDone( img->dat.img.request ) ) {
+      gl_freeTexture( img->dat.img.image );
+      img->dat.img.image = gl_texRequestGet( img->dat.img.request );
+      gl_texRequestFree( img->dat.img.request );
+      img->dat.img.request = NULL;
+   }
+
    /*
     * image
     */
@@ -145,6 +182,10 @@ void window_modifyImage( unsigned int wid, char *name, const glTexture *image,
       return;
    }
 
+   /* Overrides any image being loaded. */
+   gl_texRequestFree( wgt->dat.img.request );
+   wgt->dat.img.request = NULL;
+
    /* Image must not be NULL. */
    if ( image == NULL ) {
       wgt->dat.img.image = NULL;
@@ -204,5 +245,6 @@ static void img_freeLayers( Widget *img )
 static void img_cleanup( Widget *img )
 {
    gl_freeTexture( img->dat.img.image );
+   gl_texRequestFree( img->dat.img.request );
    img_freeLayers( img );
 }
@@ -10,8 +10,9 @@
  * @brief The image widget data
  */
 typedef struct WidgetImageData_ {
-   glTexture *image;  /**< Image to display. */
-   int        border; /**< 1 if widget should have border. */
+   glTexture    *image;   /**< Image to display. */
+   glTexRequest *request; /**< Image being loaded in the background. */
+   int           border;  /**< 1 if widget should have border. */
    /* Additional layers can be set if needed. */
    glTexture **layers;  /**< Layers to be added. */
    int         nlayers; /**< Total number of layers. */
@@ -22,6 +23,9 @@ void window_addImage( unsigned int wid, const int x, const int y, /* position */
                       const int w, const int h, /* dimensions */
                       char *name, const glTexture *image,
                       int border ); /* label and image itself */
+void window_addImageRequest( unsigned int wid, const int x, const int y,
+                             const int w, const int h, char *name,
+                             const glTexRequest *request, int border );
 
 /* Misc functions. */
 void window_modifyImage( unsigned int wid, char *name, const glTexture *image,
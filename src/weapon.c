@@ -71,6 +71,8 @@ typedef struct WeaponHit_ {
 /* Weapon layers. */
 static Weapon *weapon_stack =
    NULL; /**< All the weapon munitions are piled up here. */
+/** IDs of the weapons to render per WeaponLayer (array.h). */
+static unsigned int *weapon_visible[2] = { NULL, NULL };
 
 /* Graphics. */
 static gl_vbo  *weapon_vbo     = NULL; /**< Weapon VBO. */
@@ -762,7 +764,80 @@ void weapons_update( double dt )
 }
 
 /**
- * @brief Renders all the weapons in a layer.
+ * @brief Checks to see if a weapon is completely outside of a view.
+ */
+static int weapon_cullOutside( const Weapon *w, const RenderView *view )
+{
+   const OutfitGFX *gfx;
+   double           r;
+
+   switch ( outfit_type( w->outfit ) ) {
+   case OUTFIT_TYPE_BOLT:
+   case OUTFIT_TYPE_TURRET_BOLT:
+   case OUTFIT_TYPE_LAUNCHER:
+   case OUTFIT_TYPE_TURRET_LAUNCHER:
+      gfx = outfit_gfx( w->outfit );
+      r   = gfx->size;
+      if ( gfx->tex != NULL )
+         r = MAX( r, MAX( tex_sw( gfx->tex ), tex_sh( gfx->tex ) ) );
+      return render_viewOutside( view, w->solid.pos.x, w->solid.pos.y, r );
+
+   /* Beams extend from their origin along their direction. */
+   case OUTFIT_TYPE_BEAM:
+   case OUTFIT_TYPE_TURRET_BEAM: {
+      double range = outfit_range( w->outfit ) * w->range_mod;
+      double x1    = w->solid.pos.x;
+      double y1    = w->solid.pos.y;
+      double x2    = x1 + range * cos( w->solid.dir );
+      double y2    = y1 + range * sin( w->solid.dir );
+      r            = outfit_width( w->outfit );
+      return ( ( MAX( x1, x2 ) + r < view->x1 ) ||
+               ( MIN( x1, x2 ) - r > view->x2 ) ||
+               ( MAX( y1, y2 ) + r < view->y1 ) ||
+               ( MIN( y1, y2 ) - r > view->y2 ) );
+   }
+
+   default:
+      return 0;
+   }
+}
+
+/**
+ * @brief Builds the lists of weapons to render this frame.
+ *
+ * Only hittable munitions are in the weapon quadtree, so the stack is tested
+ * directly instead.
+ *
+ *    @param view Visible region of the game world.
+ *    @param[out] stats Culling counters to update.
+ */
+void weapons_cull( const RenderView *view, RenderCullStats *stats )
+{
+   for ( int i = 0; i < 2; i++ ) {
+      if ( weapon_visible[i] == NULL )
+         weapon_visible[i] = array_create( unsigned int );
+      array_resize( &weapon_visible[i], 0 );
+   }
+
+   for ( int i = 0; i < array_size( weapon_stack ); i++ ) {
+      const Weapon *w = &weapon_stack[i];
+
+      /* Don't render destroyed weapons. */
+      if ( weapon_isFlag( w, WEAPON_FLAG_DESTROYED ) )
+         continue;
+
+      if ( weapon_cullOutside( w, view ) ) {
+         stats->weapons_culled++;
+         continue;
+      }
+
+      array_push_back( &weapon_visible[w->layer], w->id );
+      stats->weapons_drawn++;
+   }
+}
+
+/**
+ * @brief Renders all the weapons in a layer that passed culling.
  *
  *    @param layer Layer to render.
  *    @param dt Current delta tick.
@@ -771,11 +846,15 @@ void weapons_render( const WeaponLayer layer, double dt )
 {
    NTracingZone( _ctx, 1 );
 
-   for ( int i = 0; i < array_size( weapon_stack ); i++ ) {
-      Weapon *w = &weapon_stack[i];
-      if ( w->layer == layer )
+   /* Consecutive sprite bolts sharing textures get drawn together. */
+   gl_batchBegin();
+   for ( int i = 0; i < array_size( weapon_visible[layer] ); i++ ) {
+      /* Render hooks may have removed weapons since culling. */
+      Weapon *w = weapon_getID( weapon_visible[layer][i] );
+      if ( w != NULL )
          weapon_render( w, dt );
    }
+   gl_batchEnd();
 
    NTracingZoneEnd( _ctx );
 }
@@ -865,6 +944,7 @@ static void weapon_render( Weapon *w, double dt )
          col_blend( &col, &cYellow, &cRed, st );
          col.a = 0.5;
 
+         gl_batchFlush(); /* Keep the drawing order. */
          glUseProgram( shaders.iflockon.program );
          glUniform1f( shaders.iflockon.paramf, st );
          gl_renderShader( x, y, r, r, r, &shaders.iflockon, &col, 1 );
@@ -881,12 +961,12 @@ static void weapon_render( Weapon *w, double dt )
       if ( gfx->tex != NULL ) {
          const glTexture *tex = gfx->tex;
          if ( gfx->tex_end != NULL )
-            gl_renderSpriteInterpolate( tex, gfx->tex_end, w->timer / w->life,
-                                        w->solid.pos.x, w->solid.pos.y, w->sx,
-                                        w->sy, &c );
+            gl_batchSpriteInterpolate( tex, gfx->tex_end, w->timer / w->life,
+                                       w->solid.pos.x, w->solid.pos.y, w->sx,
+                                       w->sy, &c );
          else
-            gl_renderSprite( tex, w->solid.pos.x, w->solid.pos.y, w->sx, w->sy,
-                             &c );
+            gl_batchSprite( tex, w->solid.pos.x, w->solid.pos.y, w->sx, w->sy,
+                            &c );
       } else {
          double r, z;
 
@@ -907,6 +987,7 @@ static void weapon_render( Weapon *w, double dt )
          mat4_rotate2d( &projection, w->solid.dir );
          mat4_scale_xy( &projection, r, r );
 
+         gl_batchFlush(); /* Keep the drawing order. */
          glUseProgram( gfx->program );
          glUniform2f( gfx->dimensions, r, r );
          glUniform1f( gfx->u_r, w->r );
@@ -929,6 +1010,7 @@ static void weapon_render( Weapon *w, double dt )
    /* Beam weapons. */
    case OUTFIT_TYPE_BEAM:
    case OUTFIT_TYPE_TURRET_BEAM:
+      gl_batchFlush(); /* Keep the drawing order. */
       weapon_renderBeam( w, dt );
       break;
 
@@ -2942,6 +3024,10 @@ void weapon_exit( void )
 
    /* Destroy weapon stack. */
    array_free( weapon_stack );
+   for ( int i = 0; i < 2; i++ ) {
+      array_free( weapon_visible[i] );
+      weapon_visible[i] = NULL;
+   }
 
    /* Destroy VBO. */
    free( weapon_vboData );
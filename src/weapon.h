@@ -118,6 +118,7 @@ void weapon_collideQueryIL( IntList *il, int x1, int y1, int x2, int y2 );
 void weapons_updatePurge( void );
 void weapons_updateCollide( double dt );
 void weapons_update( double dt );
+void weapons_cull( const RenderView *view, RenderCullStats *stats );
 void weapons_render( const WeaponLayer layer, double dt );
 
 /* Clean. */
@@ -0,0 +1,258 @@
+/*
+ * See Licensing and Copyright notice in naev.h
+ */
+/**
+ * @file sdfcheck.c
+ *
+ * @brief Checks the output of make_distance_mapbf() against the edtaa3 based
+ * implementation it replaced.
+ *
+ * Both estimate where the edge crosses anti-aliased pixels, but they don't
+ * always pick the same pixel as the nearest edge, so the distances are
+ * compared with a tolerance that depends on the kind of input.
+ */
+/** @cond */
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/** @endcond */
+
+#include "distance_field.h"
+#include "edtaa3func.h"
+
+#define SDF_SAMPLES 16 /**< Samples per axis for anti-aliased inputs. */
+#define SDF_BAND 4. /**< Only distances this close to the edge are compared. */
+
+/**
+ * @brief Shape to rasterize, returns whether a point is inside.
+ */
+typedef int ( *SDFShape )( double x, double y );
+
+static double *sdf_referenced( double *data, unsigned int width,
+                               unsigned int height, double *vmax );
+static float  *sdf_reference( const unsigned char *img, unsigned int width,
+                              unsigned int height, double *vmax );
+static int     sdf_square( double x, double y );
+static int     sdf_rect( double x, double y );
+static int     sdf_circle( double x, double y );
+static int     sdf_circleLarge( double x, double y );
+static unsigned char *sdf_rasterize( SDFShape shape, int w, int h,
+                                     int samples );
+static int sdf_check( const char *name, SDFShape shape, int w, int h,
+                      int samples, double mean_tol, double max_tol );
+
+/**
+ * @brief Reference bipolar distance field using edtaa3, normalized to [0,1].
+ */
+static double *sdf_referenced( double *data, unsigned int width,
+                               unsigned int height, double *vmax )
+{
+   unsigned int wh      = width * height;
+   short       *xdist   = malloc( wh * sizeof( short ) );
+   short       *ydist   = malloc( wh * sizeof( short ) );
+   double      *gx      = calloc( wh, sizeof( double ) );
+   double      *gy      = calloc( wh, sizeof( double ) );
+   double      *outside = calloc( wh, sizeof( double ) );
+   double      *inside  = calloc( wh, sizeof( double ) );
+
+   // Compute outside = edtaa3(bitmap); % Transform background (0's)
+   computegradient( data, width, height, gx, gy );
+   edtaa3( data, gx, gy, width, height, xdist, ydist, outside );
+   for ( unsigned int i = 0; i < wh; i++ )
+      if ( outside[i] < 0.0 )
+         outside[i] = 0.0;
+
+   // Compute inside = edtaa3(1-bitmap); % Transform foreground (1's)
+   memset( gx, 0, sizeof( double ) * width * height );
+   memset( gy, 0, sizeof( double ) * width * height );
+   for ( unsigned int i = 0; i < wh; i++ )
+      data[i] = 1. - data[i];
+   computegradient( data, width, height, gx, gy );
+   edtaa3( data, gx, gy, width, height, xdist, ydist, inside );
+   for ( unsigned int i = 0; i < wh; i++ )
+      if ( inside[i] < 0. )
+         inside[i] = 0.;
+
+   // distmap = outside - inside; % Bipolar distance field
+   *vmax = 0.;
+   for ( unsigned int i = 0; i < wh; i++ ) {
+      outside[i] -= inside[i];
+      if ( *vmax < fabs( outside[i] ) )
+         *vmax = fabs( outside[i] );
+   }
+
+   for ( unsigned int i = 0; i < wh; i++ ) {
+      double v = outside[i];
+      if ( v < -*vmax )
+         outside[i] = -*vmax;
+      else if ( v > +*vmax )
+         outside[i] = +*vmax;
+      data[i] = ( outside[i] + *vmax ) / ( 2. * *vmax );
+   }
+
+   free( xdist );
+   free( ydist );
+   free( gx );
+   free( gy );
+   free( outside );
+   free( inside );
+   return data;
+}
+
+/**
+ * @brief The edtaa3 based make_distance_mapbf() that used to be in the game.
+ */
+static float *sdf_reference( const unsigned char *img, unsigned int width,
+                             unsigned int height, double *vmax )
+{
+   unsigned int wh      = width * height;
+   double      *data    = calloc( wh, sizeof( double ) );
+   float       *out     = malloc( wh * sizeof( float ) );
+   double       img_min = DBL_MAX;
+   double       img_max = DBL_MIN;
+
+   // find minimum and maximum values
+   for ( unsigned int i = 0; i < wh; i++ ) {
+      double v = img[i];
+      if ( v > img_max )
+         img_max = v;
+      if ( v < img_min )
+         img_min = v;
+   }
+
+   // Map values from 0 - 255 to 0.0 - 1.0
+   for ( unsigned int i = 0; i < wh; i++ )
+      data[i] = ( img[i] - img_min ) / img_max;
+
+   data = sdf_referenced( data, width, height, vmax );
+
+   // lower to float
+   for ( unsigned int i = 0; i < wh; i++ )
+      out[i] = (float)( 1 - data[i] );
+
+   free( data );
+   return out;
+}
+
+/**
+ * @brief Square aligned to the pixel grid.
+ */
+static int sdf_square( double x, double y )
+{
+   return ( x >= 20. ) && ( x < 44. ) && ( y >= 20. ) && ( y < 44. );
+}
+
+/**
+ * @brief Rectangle with edges in the middle of pixels.
+ */
+static int sdf_rect( double x, double y )
+{
+   return ( x >= 18.3 ) && ( x < 45.6 ) && ( y >= 21.75 ) && ( y < 40.2 );
+}
+
+/**
+ * @brief Circle not centred on the pixel grid.
+ */
+static int sdf_circle( double x, double y )
+{
+   double dx = x - 32.2;
+   double dy = y - 31.7;
+   return dx * dx + dy * dy < 17.4 * 17.4;
+}
+
+/**
+ * @brief Circle big enough to be split across threads.
+ */
+static int sdf_circleLarge( double x, double y )
+{
+   double dx = x - 260.4;
+   double dy = y - 251.9;
+   return dx * dx + dy * dy < 180.3 * 180.3;
+}
+
+/**
+ * @brief Rasterizes a shape with box filtered anti-aliasing.
+ *
+ *    @param samples Samples per axis, 1 for a hard-edged image.
+ */
+static unsigned char *sdf_rasterize( SDFShape shape, int w, int h,
+                                     int samples )
+{
+   unsigned char *img = malloc( w * h );
+   for ( int y = 0; y < h; y++ ) {
+      for ( int x = 0; x < w; x++ ) {
+         int n = 0;
+         for ( int v = 0; v < samples; v++ )
+            for ( int u = 0; u < samples; u++ )
+               n += shape( x + ( u + 0.5 ) / samples,
+                           y + ( v + 0.5 ) / samples );
+         img[y * w + x] = ( 255 * n + samples * samples / 2 ) /
+                          ( samples * samples );
+      }
+   }
+   return img;
+}
+
+/**
+ * @brief Compares the distances near the edge of a shape in pixels.
+ *
+ *    @return 0 if within the tolerances.
+ */
+static int sdf_check( const char *name, SDFShape shape, int w, int h,
+                      int samples, double mean_tol, double max_tol )
+{
+   unsigned char *img = sdf_rasterize( shape, w, h, samples );
+   double         vmax, vref;
+   float         *out  = make_distance_mapbf( img, w, h, &vmax );
+   float         *ref  = sdf_reference( img, w, h, &vref );
+   double         mean = 0.;
+   double         max  = 0.;
+   int            n    = 0;
+   int            ret;
+
+   if ( out == NULL ) {
+      printf( "%s: make_distance_mapbf failed\n", name );
+      free( img );
+      free( ref );
+      return -1;
+   }
+
+   for ( int i = 0; i < w * h; i++ ) {
+      /* Undo the normalization to get back the signed distance. */
+      double d    = vmax * ( 1. - 2. * out[i] );
+      double dref = vref * ( 1. - 2. * ref[i] );
+      double e    = fabs( d - dref );
+      if ( fabs( dref ) > SDF_BAND )
+         continue;
+      mean += e;
+      if ( e > max )
+         max = e;
+      n++;
+   }
+   mean /= ( n > 0 ) ? n : 1;
+
+   ret = ( mean > mean_tol ) || ( max > max_tol );
+   printf( "%s: mean error %.4f px (max %.4f), max error %.4f px (max %.4f) "
+           "over %d pixels: %s\n",
+           name, mean, mean_tol, max, max_tol, n, ret ? "FAIL" : "OK" );
+
+   free( img );
+   free( out );
+   free( ref );
+   return ret;
+}
+
+int main( void )
+{
+   int ret = 0;
+   ret |= sdf_check( "hard-edged", sdf_square, 64, 64, 1, 0.001, 0.001 );
+   ret |= sdf_check( "anti-aliased axis-aligned", sdf_rect, 64, 64,
+                     SDF_SAMPLES, 0.01, 0.05 );
+   ret |= sdf_check( "anti-aliased curved", sdf_circle, 64, 64, SDF_SAMPLES,
+                     0.02, 0.3 );
+   ret |= sdf_check( "anti-aliased curved threaded", sdf_circleLarge, 512, 512,
+                     SDF_SAMPLES, 0.02, 0.4 );
+   return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
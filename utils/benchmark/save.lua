@@ -0,0 +1,71 @@
+--[[
+Benchmarks writing a large synthetic saved game.
+
+Has to be run while landed. Pads the save with lots of mission variables to
+imitate a long campaign, then times snapshot saves and reports the size of the
+resulting file. Run it once with `save_compress = true` and once with
+`save_compress = false` in conf.lua to compare the compressed and plain
+formats.
+
+Loading is not timed here. There is no Lua API to load a save, and loading one
+tears down the running game, including the Lua state running this script. To
+time loads, set `keep_snapshot` to true and load the resulting "benchmark"
+snapshot from the load menu instead, for example in a Tracy enabled build.
+Otherwise the snapshot is deleted when done.
+--]]
+local reps = 5
+local nvars = 200000
+local savename = "benchmark"
+local keep_snapshot = false
+
+local function stats( vals )
+   local mean = 0
+   local stddev = 0
+   for k,v in ipairs(vals) do
+      mean = mean + v
+   end
+   mean = mean / #vals
+   for k,v in ipairs(vals) do
+      stddev = stddev + math.pow(v-mean, 2)
+   end
+   stddev = math.sqrt(stddev / #vals)
+   return mean, stddev
+end
+
+print("====== BENCHMARK START ======")
+
+-- Pad the save
+for i=1,nvars do
+   var.push( string.format("__benchmark_save_%d",i), string.format("Benchmark padding value number %d", i) )
+end
+
+local vals = {}
+for i=1,reps do
+   local rstart = naev.clock()
+   player.save( savename )
+   table.insert( vals, (naev.clock()-rstart)*1000 )
+end
+local mean, stddev = stats( vals )
+
+local path = string.format("saves/%s/%s.ns", player.name(), savename)
+local f = file.new( path )
+f:open("r")
+local size = f:getSize()
+f:close()
+
+print(string.format("Save: %.3f ms (stddev %.3f ms), %.1f KiB", mean, stddev, size / 1024))
+
+-- Clean up
+for i=1,nvars do
+   var.pop( string.format("__benchmark_save_%d",i) )
+end
+if keep_snapshot then
+   print(string.format("Left the snapshot '%s' in place to time loading it.", savename))
+else
+   local ok, err = file.remove( path )
+   if not ok then
+      warn(string.format("Unable to delete the snapshot '%s': %s", path, err))
+   end
+end
+
+print("====== BENCHMARK END ======")